@@ -1,11 +1,11 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
 /*---------------------------------------------------------------------------*/
-/* FemModule.cc                                                (C) 2022-2023 */
+/* FemModule.cc                                                (C) 2022-2024 */
 /*                                                                           */
 /* Simple module to test simple FEM mechanism.                               */
 /*---------------------------------------------------------------------------*/
@@ -17,6 +17,7 @@
 #include <arcane/IItemFamily.h>
 #include <arcane/ItemGroup.h>
 #include <arcane/ICaseMng.h>
+#include <arcane/IParallelMng.h>
 
 #include "IDoFLinearSystemFactory.h"
 #include "Fem_axl.h"
@@ -24,6 +25,8 @@
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
 
+#include <limits>
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -70,6 +73,19 @@ class FemModule
   IItemFamily* m_dof_family = nullptr;
   FemDoFsOnNodes m_dofs_on_nodes;
 
+  //! Data of the angle of attack sweep, computed from the basis solutions
+  struct SweepBasisData
+  {
+    //! Difference of du/dy between the upper and lower trailing edge cells
+    Real kutta = 0.0;
+    //! Integral of du/dn on the airfoil (n towards the fluid)
+    Real lift_flux = 0.0;
+  };
+  SweepBasisData m_sweep_data[3];
+  Real m_chord = 0.0;
+  //! Lift coefficient of each angle of the sweep
+  UniqueArray<Real> m_lift_coefficients;
+
  private:
 
   void _doStationarySolve();
@@ -82,10 +98,17 @@ class FemModule
   void _assembleLinearOperator();
   FixedMatrix<3, 3> _computeElementMatrixTRIA3(Cell cell);
   Real2 _computeDxDyOfRealTRIA3(Cell cell);
+  Real2 _computeDxDyOfRealTRIA3(Cell cell, const VariableNodeReal& u);
   Real _computeAreaTriangle3(Cell cell);
   void _applyDirichletBoundaryConditions();
   void _getPsi();
   void _checkResultFile();
+  void _solveSweepBasis();
+  void _solveSweepBasisProblem(VariableNodeReal& u_basis, Real farfield_y_coef, Real farfield_x_coef, Real airfoil_value);
+  void _computeSweepBasisData();
+  Real _combineSweepSolution(Real angle);
+  void _checkSweepDirectSolve(Real angle, Real airfoil_value);
+  void _checkSweepLiftCoefficients();
 };
 
 /*---------------------------------------------------------------------------*/
@@ -96,10 +119,28 @@ compute()
 {
   info() << "Module Fem COMPUTE";
 
-  // Stop code after computations
-  if (m_global_iteration() > 0)
+  // Stop code after computations. In a sweep each iteration gives the
+  // solution for one angle of attack.
+  Int32 nb_sweep_angle = options()->sweepAngle().size();
+  if (m_global_iteration() >= math::max(nb_sweep_angle, 1))
     subDomain()->timeLoopMng()->stopComputeLoop(true);
 
+  if (nb_sweep_angle > 0) {
+    if (m_global_iteration() == 1)
+      _solveSweepBasis();
+    Real angle = options()->sweepAngle()[m_global_iteration() - 1];
+    Real airfoil_value = _combineSweepSolution(angle);
+    if (m_global_iteration() == nb_sweep_angle) {
+      _checkResultFile();
+      if (options()->sweepCheck()) {
+        _checkSweepLiftCoefficients();
+        _checkSweepDirectSolve(angle, airfoil_value);
+      }
+    }
+    _getPsi();
+    return;
+  }
+
   m_linear_system.reset();
   m_linear_system.setLinearSystemFactory(options()->linearSystem());
   m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
@@ -430,14 +471,23 @@ _computeElementMatrixTRIA3(Cell cell)
 
 Real2 FemModule::
 _computeDxDyOfRealTRIA3(Cell cell)
+{
+  return _computeDxDyOfRealTRIA3(cell, m_u);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Real2 FemModule::
+_computeDxDyOfRealTRIA3(Cell cell, const VariableNodeReal& u)
 {
   Real3 m0 = m_node_coord[cell.nodeId(0)];
   Real3 m1 = m_node_coord[cell.nodeId(1)];
   Real3 m2 = m_node_coord[cell.nodeId(2)];
 
-  Real f0 = m_u[cell.nodeId(0)];
-  Real f1 = m_u[cell.nodeId(1)];
-  Real f2 = m_u[cell.nodeId(2)];
+  Real f0 = u[cell.nodeId(0)];
+  Real f1 = u[cell.nodeId(1)];
+  Real f2 = u[cell.nodeId(2)];
 
   Real detA = ( m0.x*(m1.y - m2.y) - m0.y*(m1.x - m2.x) + (m1.x*m2.y - m2.x*m1.y) );
 
@@ -510,6 +560,263 @@ _solve()
   }
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Solve the three basis problems of the angle of attack sweep.
+ *
+ * The problem is linear: the solution for the far field value y - angle * x
+ * and the value c on the airfoil is u = u_x + angle * u_y + c * u_c, where
+ * - u_x has the value y on the far field and 0 on the airfoil,
+ * - u_y has the value -x on the far field and 0 on the airfoil,
+ * - u_c has the value 0 on the far field and 1 on the airfoil.
+ * The three problems have the same matrix, which is assembled once and
+ * frozen: the second and third solves only rebuild the RHS.
+ */
+void FemModule::
+_solveSweepBasis()
+{
+  info() << "Solving the basis problems of the angle of attack sweep";
+  _getMaterialParameters();
+
+  m_linear_system.reset();
+  m_linear_system.setLinearSystemFactory(options()->linearSystem());
+  m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
+  m_linear_system.setMatrixFrozen(true);
+  _assembleBilinearOperatorTRIA3();
+
+  _solveSweepBasisProblem(m_u_basis_x, 1.0, 0.0, 0.0);
+  _solveSweepBasisProblem(m_u_basis_y, 0.0, -1.0, 0.0);
+  _solveSweepBasisProblem(m_u_basis_circulation, 0.0, 0.0, 1.0);
+
+  _computeSweepBasisData();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_solveSweepBasisProblem(VariableNodeReal& u_basis, Real farfield_y_coef, Real farfield_x_coef, Real airfoil_value)
+{
+  for (const auto& bs : options()->farfieldBoundaryCondition()) {
+    ENUMERATE_ (Face, iface, bs->surface()) {
+      for (Node node : iface->nodes())
+        m_u[node] = farfield_y_coef * m_node_coord[node].y + farfield_x_coef * m_node_coord[node].x;
+    }
+  }
+  for (const auto& bs : options()->dirichletBoundaryCondition()) {
+    ENUMERATE_ (Face, iface, bs->surface()) {
+      for (Node node : iface->nodes())
+        m_u[node] = airfoil_value;
+    }
+  }
+
+  _assembleLinearOperator();
+  m_linear_system.solve();
+
+  VariableDoFReal& dof_u(m_linear_system.solutionVariable());
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    u_basis[node] = (m_u_fixed[node]) ? m_u[node] : dof_u[node_dof.dofId(node, 0)];
+  }
+  u_basis.synchronize();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Compute the Kutta and lift terms of the basis solutions.
+ *
+ * The trailing edge is the node of the airfoil with the largest x. The
+ * Kutta condition requires the same velocity u_x = du/dy in the upper and
+ * lower cells of the airfoil faces sharing the trailing edge, which is a
+ * linear equation in the value c on the airfoil.
+ */
+void FemModule::
+_computeSweepBasisData()
+{
+  IParallelMng* pm = parallelMng();
+  const VariableNodeReal* basis[3] = { &m_u_basis_x, &m_u_basis_y, &m_u_basis_circulation };
+
+  // Trailing edge and chord
+  Real x_min = std::numeric_limits<Real>::max();
+  Real x_max = -std::numeric_limits<Real>::max();
+  for (const auto& bs : options()->dirichletBoundaryCondition()) {
+    ENUMERATE_ (Face, iface, bs->surface()) {
+      for (Node node : iface->nodes()) {
+        x_min = math::min(x_min, m_node_coord[node].x);
+        x_max = math::max(x_max, m_node_coord[node].x);
+      }
+    }
+  }
+  x_min = pm->reduce(Parallel::ReduceMin, x_min);
+  x_max = pm->reduce(Parallel::ReduceMax, x_max);
+  m_chord = x_max - x_min;
+
+  Real kutta[3] = { 0.0, 0.0, 0.0 };
+  Real lift_flux[3] = { 0.0, 0.0, 0.0 };
+  Int32 nb_trailing_edge_face = 0;
+  for (const auto& bs : options()->dirichletBoundaryCondition()) {
+    ENUMERATE_ (Face, iface, bs->surface()) {
+      Face face = *iface;
+      if (!face.isOwn())
+        continue;
+      Cell cell = face.boundaryCell();
+      Real3 n0 = m_node_coord[face.nodeId(0)];
+      Real3 n1 = m_node_coord[face.nodeId(1)];
+      Real3 center = (n0 + n1) * 0.5;
+      Real3 cell_center = (m_node_coord[cell.nodeId(0)] + m_node_coord[cell.nodeId(1)] + m_node_coord[cell.nodeId(2)]) / 3.0;
+      // Normal of length |face| towards the fluid
+      Real3 normal(n1.y - n0.y, n0.x - n1.x, 0.0);
+      if (math::dot(normal, cell_center - center) < 0.0)
+        normal = -normal;
+
+      // Face of the trailing edge: +1 for the upper face, -1 for the lower one
+      Real sign = 0.0;
+      if (n0.x == x_max)
+        sign = (n1.y > n0.y) ? 1.0 : -1.0;
+      else if (n1.x == x_max)
+        sign = (n0.y > n1.y) ? 1.0 : -1.0;
+      if (sign != 0.0)
+        ++nb_trailing_edge_face;
+
+      for (Int32 k = 0; k < 3; ++k) {
+        Real2 grad = _computeDxDyOfRealTRIA3(cell, *basis[k]);
+        lift_flux[k] += grad.x * normal.x + grad.y * normal.y;
+        kutta[k] += sign * grad.y;
+      }
+    }
+  }
+  nb_trailing_edge_face = pm->reduce(Parallel::ReduceSum, nb_trailing_edge_face);
+  if (nb_trailing_edge_face != 2)
+    ARCANE_FATAL("The trailing edge should belong to two airfoil faces (n={0})", nb_trailing_edge_face);
+  for (Int32 k = 0; k < 3; ++k) {
+    m_sweep_data[k].kutta = pm->reduce(Parallel::ReduceSum, kutta[k]);
+    m_sweep_data[k].lift_flux = pm->reduce(Parallel::ReduceSum, lift_flux[k]);
+  }
+  if (m_sweep_data[2].kutta == 0.0)
+    ARCANE_FATAL("The circulation basis solution does not change the Kutta condition");
+  info() << "Sweep basis: chord=" << m_chord << " trailing_edge_x=" << x_max;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Combine the basis solutions for the angle of attack \a angle.
+ *
+ * The value c on the airfoil is given by the Kutta condition. The lift
+ * coefficient is computed from the circulation with the Kutta-Joukowski
+ * theorem: C_l = 2 Gamma / (U chord), with Gamma the integral of du/dn on
+ * the airfoil and U the norm of the freestream velocity (1, angle).
+ * Returns the value on the airfoil.
+ */
+Real FemModule::
+_combineSweepSolution(Real angle)
+{
+  const SweepBasisData& dx = m_sweep_data[0];
+  const SweepBasisData& dy = m_sweep_data[1];
+  const SweepBasisData& dc = m_sweep_data[2];
+  Real airfoil_value = -(dx.kutta + angle * dy.kutta) / dc.kutta;
+
+  ENUMERATE_ (Node, inode, allNodes()) {
+    Node node = *inode;
+    m_u[node] = m_u_basis_x[node] + angle * m_u_basis_y[node] + airfoil_value * m_u_basis_circulation[node];
+  }
+
+  Real circulation = dx.lift_flux + angle * dy.lift_flux + airfoil_value * dc.lift_flux;
+  Real velocity = math::sqrt(1.0 + angle * angle);
+  Real lift_coefficient = 2.0 * circulation / (velocity * m_chord);
+  info() << "Sweep angle=" << angle << " airfoil_value=" << airfoil_value
+         << " circulation=" << circulation << " lift_coefficient=" << lift_coefficient;
+  m_lift_coefficients.add(lift_coefficient);
+  return airfoil_value;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Check the lift coefficients of the sweep of a symmetric airfoil.
+ *
+ * The lift coefficient is near 0 at angle 0 and, for the other angles,
+ * near the thin airfoil value 2 pi sin(alpha), with alpha = atan(angle)
+ * (about 6 % more for the 12 % thick NACA0012). The ratio to the thin
+ * airfoil value is also checked to be about the same for all the angles,
+ * ie. the lift coefficient is about linear in the angle. A positive ratio
+ * checks the sign of the circulation: du/dn with n towards the fluid is
+ * the clockwise velocity, which gives a positive lift for a positive angle.
+ */
+void FemModule::
+_checkSweepLiftCoefficients()
+{
+  const Real max_lift_at_zero = 0.02;
+  const Real min_ratio = 0.95;
+  const Real max_ratio = 1.15;
+  const Real max_ratio_variation = 0.05;
+  const Real pi = 3.14159265358979323846;
+
+  Real ratio_min = std::numeric_limits<Real>::max();
+  Real ratio_max = -std::numeric_limits<Real>::max();
+  for (Int32 i = 0; i < m_lift_coefficients.size(); ++i) {
+    Real angle = options()->sweepAngle()[i];
+    Real lift_coefficient = m_lift_coefficients[i];
+    if (angle == 0.0) {
+      if (math::abs(lift_coefficient) > max_lift_at_zero)
+        ARCANE_FATAL("Lift coefficient at angle 0 is not near 0 for a symmetric airfoil (C_l={0})", lift_coefficient);
+      continue;
+    }
+    Real thin_airfoil = 2.0 * pi * angle / math::sqrt(1.0 + angle * angle);
+    Real ratio = lift_coefficient / thin_airfoil;
+    info() << "Sweep angle=" << angle << " lift_coefficient=" << lift_coefficient
+           << " thin_airfoil=" << thin_airfoil << " ratio=" << ratio;
+    if (ratio < min_ratio || ratio > max_ratio)
+      ARCANE_FATAL("Lift coefficient of angle {0} is not near the thin airfoil value (C_l={1} expected={2})",
+                   angle, lift_coefficient, thin_airfoil);
+    ratio_min = math::min(ratio_min, ratio);
+    ratio_max = math::max(ratio_max, ratio);
+  }
+  if (ratio_max > ratio_min * (1.0 + max_ratio_variation))
+    ARCANE_FATAL("Lift coefficient is not linear in the angle (ratio to the thin airfoil value between {0} and {1})",
+                 ratio_min, ratio_max);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Compare the combined solution of \a angle to a direct solve.
+ *
+ * The problem is solved with the far field value y - angle * x and the
+ * value \a airfoil_value of the Kutta condition on the airfoil, with a new
+ * (not frozen) linear system. The solution is left in u.
+ */
+void FemModule::
+_checkSweepDirectSolve(Real angle, Real airfoil_value)
+{
+  info() << "Checking the sweep against a direct solve for angle=" << angle;
+
+  m_linear_system.reset();
+  m_linear_system.setLinearSystemFactory(options()->linearSystem());
+  m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
+  _assembleBilinearOperatorTRIA3();
+  _solveSweepBasisProblem(m_u, 1.0, -angle, airfoil_value);
+
+  Real max_diff = 0.0;
+  Real max_u = 0.0;
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    Real u_combined = m_u_basis_x[node] + angle * m_u_basis_y[node] + airfoil_value * m_u_basis_circulation[node];
+    max_diff = math::max(max_diff, math::abs(m_u[node] - u_combined));
+    max_u = math::max(max_u, math::abs(m_u[node]));
+  }
+  IParallelMng* pm = parallelMng();
+  max_diff = pm->reduce(Parallel::ReduceMax, max_diff);
+  max_u = pm->reduce(Parallel::ReduceMax, max_u);
+  info() << "Sweep direct solve: max_diff=" << max_diff << " max_u=" << max_u;
+  if (max_diff > 1.0e-6 * max_u)
+    ARCANE_FATAL("Combined solution of the sweep differs from the direct solve (max_diff={0} max_u={1})",
+                 max_diff, max_u);
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -1,11 +1,11 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
 /*---------------------------------------------------------------------------*/
-/* FemModule.cc                                                (C) 2022-2023 */
+/* FemModule.cc                                                (C) 2022-2024 */
 /*                                                                           */
 /* FEM code to test vectorial FE for bilaplacian problem.                    */
 /*---------------------------------------------------------------------------*/
@@ -71,6 +71,7 @@ class FemModule
  private:
 
   void _doStationarySolve();
+  void _doSegregatedSolve();
   void _getMaterialParameters();
   void _updateBoundayConditions();
   void _assembleBilinearOperatorTRIA3();
@@ -83,6 +84,9 @@ class FemModule
   Real _computeEdgeLength2(Face face);
   void _applyDirichletBoundaryConditions();
   void _checkResultFile();
+  void _assembleScalarBilinearOperatorTRIA3();
+  void _assembleSegregatedLinearOperator(bool is_u2_step);
+  void _solveSegregatedStep(VariableNodeReal& u);
 };
 
 /*---------------------------------------------------------------------------*/
@@ -102,7 +106,10 @@ compute()
   m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
 
   info() << "NB_CELL=" << allCells().size() << " NB_FACE=" << allFaces().size();
-  _doStationarySolve();
+  if (options()->segregated())
+    _doSegregatedSolve();
+  else
+    _doStationarySolve();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -113,7 +120,8 @@ startInit()
 {
   info() << "Module Fem INIT";
 
-  m_dofs_on_nodes.initialize(mesh(), 2);
+  // The segregated solve only needs one DoF per node: u2 then u1
+  m_dofs_on_nodes.initialize(mesh(), options()->segregated() ? 1 : 2);
 
   _initBoundaryconditions();
 }
@@ -143,6 +151,45 @@ _doStationarySolve()
   _checkResultFile();
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Solve the problem as two scalar problems.
+ *
+ * When u1 and u2 are both fixed on the Dirichlet surfaces (simply supported
+ * plate), the system is block lower-triangular:
+ *   K u2 = F         (Laplacian(u2) = f, equations of the v1 test functions)
+ *   K u1 = -M u2     (Laplacian(u1) + u2 = 0, equations of the v2 test functions)
+ * where K is the scalar stiffness matrix and M the mass matrix. These are
+ * the rows of the coupled system, so u1 and u2 are the ones of the coupled
+ * solve with the same 'laplacian-value' conditions. Both solves
+ * use the same matrix, which is assembled once and frozen for the second
+ * solve. Only the product M u2 is computed, cell by cell.
+ */
+void FemModule::
+_doSegregatedSolve()
+{
+  _getMaterialParameters();
+  _updateBoundayConditions();
+
+  String method = options()->enforceDirichletMethod();
+  if (method != "Penalty" && method != "WeakPenalty")
+    ARCANE_FATAL("Only 'Penalty' and 'WeakPenalty' Dirichlet methods are supported with 'segregated' (method={0})", method);
+
+  m_linear_system.setMatrixFrozen(true);
+  _assembleScalarBilinearOperatorTRIA3();
+
+  info() << "Segregated solve: first step (u2)";
+  _assembleSegregatedLinearOperator(true);
+  _solveSegregatedStep(m_u2);
+
+  info() << "Segregated solve: second step (u1)";
+  _assembleSegregatedLinearOperator(false);
+  _solveSegregatedStep(m_u1);
+
+  _checkResultFile();
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -182,10 +229,17 @@ _applyDirichletBoundaryConditions()
     FaceGroup group = bs->surface();
     Real value = bs->value();
     info() << "Apply Dirichlet boundary condition surface=" << group.name() << " v=" << value;
+    // u2 is always fixed with the segregated solve
+    bool is_u2_fixed = options()->segregated() || bs->hasLaplacianValue();
+    Real laplacian_value = (bs->hasLaplacianValue()) ? bs->laplacianValue() : 0.0;
     ENUMERATE_ (Face, iface, group) {
       for (Node node : iface->nodes()) {
         m_u1[node] = value;
         m_u1_fixed[node] = true;
+        if (is_u2_fixed) {
+          m_u2[node] = laplacian_value;
+          m_u2_fixed[node] = true;
+        }
       }
     }
   }
@@ -261,6 +315,11 @@ _assembleLinearOperator()
           rhs_values[dof_id1] = temperature;
         }
       }
+      if (m_u2_fixed[node_id]) {
+        DoFLocalId dof_id2 = node_dof.dofId(node_id, 1);
+        m_linear_system.matrixSetValue(dof_id2, dof_id2, Penalty);
+        rhs_values[dof_id2] = Penalty * m_u2[node_id];
+      }
     }
   }else if (options()->enforceDirichletMethod() == "WeakPenalty") {
 
@@ -297,6 +356,11 @@ _assembleLinearOperator()
           rhs_values[dof_id1] = temperature;
         }
       }
+      if (m_u2_fixed[node_id]) {
+        DoFLocalId dof_id2 = node_dof.dofId(node_id, 1);
+        m_linear_system.matrixAddValue(dof_id2, dof_id2, Penalty);
+        rhs_values[dof_id2] = Penalty * m_u2[node_id];
+      }
     }
   }else if (options()->enforceDirichletMethod() == "RowElimination") {
 
@@ -607,6 +671,137 @@ _assembleBilinearOperatorTRIA3()
   }
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Assemble the scalar stiffness matrix (one DoF per node).
+ *
+ * The rows of the Dirichlet nodes are modified by the penalty method. As u1
+ * and u2 are fixed on the same nodes the matrix is the same for both steps
+ * of the segregated solve.
+ */
+void FemModule::
+_assembleScalarBilinearOperatorTRIA3()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    if (cell.type() != IT_Triangle3)
+      ARCANE_FATAL("Only Triangle3 cell type is supported");
+
+    Real3 m0 = m_node_coord[cell.nodeId(0)];
+    Real3 m1 = m_node_coord[cell.nodeId(1)];
+    Real3 m2 = m_node_coord[cell.nodeId(2)];
+    Real area = _computeAreaTriangle3(cell);
+    Real2 dPhi[3] = { Real2(m1.y - m2.y, m2.x - m1.x),
+                      Real2(m2.y - m0.y, m0.x - m2.x),
+                      Real2(m0.y - m1.y, m1.x - m0.x) };
+
+    // K_e(i,j) = int_Omega_e grad(phi_i).grad(phi_j)
+    for (Int32 i = 0; i < 3; ++i) {
+      Node node1 = cell.node(i);
+      if (!node1.isOwn())
+        continue;
+      for (Int32 j = 0; j < 3; ++j) {
+        Real v = (dPhi[i].x * dPhi[j].x + dPhi[i].y * dPhi[j].y) / (4.0 * area);
+        m_linear_system.matrixAddValue(node_dof.dofId(node1, 0), node_dof.dofId(cell.node(j), 0), v);
+      }
+    }
+  }
+
+  Real Penalty = options()->penalty(); // 1.0e30 is the default
+  bool is_weak_penalty = (options()->enforceDirichletMethod() == "WeakPenalty");
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    NodeLocalId node_id = *inode;
+    if (!m_u1_fixed[node_id])
+      continue;
+    DoFLocalId dof_id = node_dof.dofId(node_id, 0);
+    if (is_weak_penalty)
+      m_linear_system.matrixAddValue(dof_id, dof_id, Penalty);
+    else
+      m_linear_system.matrixSetValue(dof_id, dof_id, Penalty);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Assemble the RHS of one step of the segregated solve.
+ *
+ * If \a is_u2_step is true, the RHS is the source term f (and the Neumann
+ * flux) and the Dirichlet value is the one of u2. Otherwise the RHS is
+ * -M u2 and the Dirichlet value is the one of u1.
+ */
+void FemModule::
+_assembleSegregatedLinearOperator(bool is_u2_step)
+{
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
+  rhs_values.fill(0.0);
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  Real Penalty = options()->penalty();
+  VariableNodeReal& u_fixed_value = (is_u2_step) ? m_u2 : m_u1;
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    NodeLocalId node_id = *inode;
+    if (m_u1_fixed[node_id])
+      rhs_values[node_dof.dofId(node_id, 0)] = Penalty * u_fixed_value[node_id];
+  }
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    Real area = _computeAreaTriangle3(cell);
+    // Consistent mass matrix: M_e(i,j) = area/12 * (1 + delta_ij)
+    Real sum_u2 = 0.0;
+    if (!is_u2_step)
+      for (Node node : cell.nodes())
+        sum_u2 += m_u2[node];
+    for (Node node : cell.nodes()) {
+      if (m_u1_fixed[node] || !node.isOwn())
+        continue;
+      DoFLocalId dof_id = node_dof.dofId(node, 0);
+      if (is_u2_step)
+        rhs_values[dof_id] += f * area / 3;
+      else
+        rhs_values[dof_id] -= area / 12 * (m_u2[node] + sum_u2);
+    }
+  }
+
+  if (!is_u2_step)
+    return;
+  for (const auto& bs : options()->neumannBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+    Real value = bs->value();
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+      Real length = _computeEdgeLength2(face);
+      for (Node node : iface->nodes()) {
+        if (!(m_u1_fixed[node]) && node.isOwn())
+          rhs_values[node_dof.dofId(node, 0)] += value * length / 2.;
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_solveSegregatedStep(VariableNodeReal& u)
+{
+  m_linear_system.solve();
+
+  VariableDoFReal& dof_u(m_linear_system.solutionVariable());
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    // The Dirichlet values are kept as they are
+    if (!m_u1_fixed[node])
+      u[node] = dof_u[node_dof.dofId(node, 0)];
+  }
+  u.synchronize();
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
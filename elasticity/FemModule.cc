@@ -1,11 +1,11 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
 /*---------------------------------------------------------------------------*/
-/* FemModule.cc                                                (C) 2022-2023 */
+/* FemModule.cc                                                (C) 2022-2024 */
 /*                                                                           */
 /* FEM code to test vectorial FE for Elasticity problem.                     */
 /*---------------------------------------------------------------------------*/
@@ -17,11 +17,14 @@
 #include <arcane/ItemGroup.h>
 #include <arcane/ICaseMng.h>
 
+#include <algorithm>
+
 #include "IDoFLinearSystemFactory.h"
 #include "Fem_axl.h"
 #include "FemUtils.h"
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
+#include "FemMaterialTable.h"
 
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -42,6 +45,7 @@ class FemModule
   explicit FemModule(const ModuleBuildInfo& mbi)
   : ArcaneFemObject(mbi)
   , m_dofs_on_nodes(mbi.subDomain()->traceMng())
+  , m_materials(mbi.subDomain()->traceMng())
   {
     ICaseMng* cm = mbi.subDomain()->caseMng();
     cm->setTreatWarningAsError(true);
@@ -72,10 +76,38 @@ class FemModule
 
   DoFLinearSystem m_linear_system;
   FemDoFsOnNodes m_dofs_on_nodes;
+  //! Material of each cell and Lame parameters of each material
+  FemMaterialTable m_materials;
+  static constexpr Int32 MAT_LAMBDA = 0;
+  static constexpr Int32 MAT_MU2 = 1;
+
+  /*!
+   * \brief Stiffness matrix split in its lambda and mu parts.
+   *
+   * The element matrix is linear in the Lame parameters, so the stiffness of
+   * material m is K_m = lambda_m K_lambda_m + mu2_m K_mu_m. The two parts are
+   * assembled once per material on the CSR pattern of the own DoFs (columns
+   * are DoF local ids) and any set of parameters is then a combination of
+   * the stored values.
+   */
+  struct SplitStiffness
+  {
+    UniqueArray<Int32> rows_index;
+    UniqueArray<Int32> columns;
+    //! Values of K_lambda_m and K_mu_m: material m uses [m*nnz, (m+1)*nnz)
+    UniqueArray<Real> lambda_values;
+    UniqueArray<Real> mu2_values;
+  };
+  SplitStiffness m_split_stiffness;
 
  private:
 
   void _doStationarySolve();
+  void _doParameterSweepSolve(Int32 index);
+  void _buildSplitStiffnessPattern();
+  Int32 _splitStiffnessIndex(DoFLocalId row, DoFLocalId column) const;
+  void _assembleSplitStiffnessTRIA3();
+  void _addSplitStiffness();
   void _getMaterialParameters();
   void _updateBoundayConditions();
   void _assembleBilinearOperatorTRIA3();
@@ -100,8 +132,10 @@ compute()
 {
   info() << "Module Fem COMPUTE";
 
-  // Stop code after computations
-  if (m_global_iteration() > 0)
+  // Stop code after computations. In a parameter sweep each iteration gives
+  // the solution for one (E, nu) point.
+  Int32 nb_sweep_point = options()->parameterSweep().size();
+  if (m_global_iteration() >= math::max(nb_sweep_point, 1))
     subDomain()->timeLoopMng()->stopComputeLoop(true);
 
   m_linear_system.reset();
@@ -109,7 +143,10 @@ compute()
   m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
 
   info() << "NB_CELL=" << allCells().size() << " NB_FACE=" << allFaces().size();
-  _doStationarySolve();
+  if (nb_sweep_point > 0)
+    _doParameterSweepSolve(m_global_iteration() - 1);
+  else
+    _doStationarySolve();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -149,8 +186,49 @@ _doStationarySolve()
   // Solve for [u1,u2]
   _solve();
 
-  // Check results TODO
-  // _checkResultFile();
+  // Check results
+  _checkResultFile();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Solve for the point \a index of the parameter sweep.
+ *
+ * At the first point the split stiffness is assembled with one element loop.
+ * For each point the Lame parameters of the default material (material 0)
+ * are replaced by the ones of the sweep point and the matrix is formed from
+ * the split stiffness, without element loop.
+ *
+ * The 'result-file' is checked with the solution of the first point, which
+ * can so be compared with the one of the element assembly.
+ */
+void FemModule::
+_doParameterSweepSolve(Int32 index)
+{
+  if (options()->meshType == "QUAD4")
+    ARCANE_FATAL("'parameter-sweep' is only available for TRIA3 meshes");
+
+  if (index == 0) {
+    _getMaterialParameters();
+    _assembleSplitStiffnessTRIA3();
+  }
+
+  const auto& point = options()->parameterSweep()[index];
+  E = point->E();
+  nu = point->nu();
+  mu2 = ( E/(2*(1+nu)) )*2;
+  lambda = E*nu/((1+nu)*(1-2*nu));
+  m_materials.setValue(MAT_LAMBDA, 0, lambda);
+  m_materials.setValue(MAT_MU2, 0, mu2);
+  info() << "Parameter sweep point=" << index << " E=" << E << " nu=" << nu;
+
+  _addSplitStiffness();
+  _assembleLinearOperator();
+  _solve();
+
+  if (index == 0)
+    _checkResultFile();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -167,6 +245,23 @@ _getMaterialParameters()
 
   mu2 = ( E/(2*(1+nu)) )*2;                // lame parameter mu * 2
   lambda = E*nu/((1+nu)*(1-2*nu));         // lame parameter lambda
+
+  // Lame parameters are computed once per material. Material 0 is used by
+  // the cells which are not in a 'material-property'
+  m_materials.initialize(mesh(), "Elasticity", 2);
+  m_materials.setValue(MAT_LAMBDA, 0, lambda);
+  m_materials.setValue(MAT_MU2, 0, mu2);
+
+  for (const auto& bs : options()->materialProperty()) {
+    CellGroup group = bs->volume();
+    Real mat_E = bs->E();
+    Real mat_nu = bs->nu();
+    info() << "E for group=" << group.name() << " v=" << mat_E << " nu=" << mat_nu;
+
+    Int32 mat_index = m_materials.addMaterial(group);
+    m_materials.setValue(MAT_LAMBDA, mat_index, mat_E*mat_nu/((1+mat_nu)*(1-2*mat_nu)));
+    m_materials.setValue(MAT_MU2, mat_index, ( mat_E/(2*(1+mat_nu)) )*2);
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -954,6 +1049,8 @@ _assembleBilinearOperatorQUAD4()
     if (cell.type() != IT_Quad4)
       ARCANE_FATAL("Only Quad4 cell type is supported");
 
+    lambda = m_materials.cellValue(MAT_LAMBDA, cell);
+    mu2 = m_materials.cellValue(MAT_MU2, cell);
     auto K_e = _computeElementMatrixQUAD4(cell);  // element stiffness matrix
     // assemble elementary matrix into the global one elementary terms are
     // positioned into  K according to the rank of associated  node in the
@@ -1005,6 +1102,8 @@ _assembleBilinearOperatorTRIA3()
     if (cell.type() != IT_Triangle3)
       ARCANE_FATAL("Only Triangle3 cell type is supported");
 
+    lambda = m_materials.cellValue(MAT_LAMBDA, cell);
+    mu2 = m_materials.cellValue(MAT_MU2, cell);
     auto K_e = _computeElementMatrixTRIA3(cell);  // element stiffness matrix
     // assemble elementary matrix into the global one elementary terms are
     // positioned into K according to the rank  of  associated  node in the
@@ -1039,6 +1138,162 @@ _assembleBilinearOperatorTRIA3()
   }
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Build the CSR pattern of the split stiffness.
+ *
+ * The rows are the DoFs of the own nodes. The row of a DoF of the node n has
+ * the two DoFs of each node sharing a cell with n.
+ */
+void FemModule::
+_buildSplitStiffnessPattern()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Int32 nb_row = m_dofs_on_nodes.dofFamily()->maxLocalId();
+
+  UniqueArray<Int32>& rows_index = m_split_stiffness.rows_index;
+  UniqueArray<Int32>& columns = m_split_stiffness.columns;
+  rows_index.resize(nb_row + 1);
+  rows_index.fill(0);
+
+  // Sorted local ids of the nodes sharing a cell with \a node
+  UniqueArray<Int32> neighbours;
+  auto compute_neighbours = [&](Node node) {
+    neighbours.clear();
+    for (Cell cell : node.cells())
+      for (Node node2 : cell.nodes())
+        neighbours.add(node2.localId());
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.resize(static_cast<Int32>(std::unique(neighbours.begin(), neighbours.end()) - neighbours.begin()));
+  };
+
+  // First pass: size of the rows, then offsets of the rows
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    compute_neighbours(node);
+    for (Int32 component = 0; component < 2; ++component)
+      rows_index[node_dof.dofId(node, component) + 1] = 2 * neighbours.size();
+  }
+  for (Int32 i = 0; i < nb_row; ++i)
+    rows_index[i + 1] += rows_index[i];
+
+  // Second pass: columns
+  columns.resize(rows_index[nb_row]);
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    compute_neighbours(node);
+    for (Int32 component = 0; component < 2; ++component) {
+      Int32 index = rows_index[node_dof.dofId(node, component)];
+      for (Int32 node2_lid : neighbours) {
+        NodeLocalId node2(node2_lid);
+        columns[index++] = node_dof.dofId(node2, 0);
+        columns[index++] = node_dof.dofId(node2, 1);
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Int32 FemModule::
+_splitStiffnessIndex(DoFLocalId row, DoFLocalId column) const
+{
+  const SplitStiffness& k = m_split_stiffness;
+  for (Int32 i = k.rows_index[row]; i < k.rows_index[row + 1]; ++i)
+    if (k.columns[i] == column)
+      return i;
+  ARCANE_FATAL("Entry ({0},{1}) is not in the split stiffness pattern", row, column);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Assemble K_lambda and K_mu of each material.
+ *
+ * The element matrix is computed with (lambda=1, mu2=0) and (lambda=0,
+ * mu2=1) and added to the parts of the material of the cell.
+ */
+void FemModule::
+_assembleSplitStiffnessTRIA3()
+{
+  info() << "Assembling the split stiffness (K_lambda, K_mu) of "
+         << m_materials.nbMaterial() << " material(s)";
+  _buildSplitStiffnessPattern();
+
+  SplitStiffness& k = m_split_stiffness;
+  Int32 nnz = k.columns.size();
+  k.lambda_values.resize(static_cast<Int64>(nnz) * m_materials.nbMaterial());
+  k.lambda_values.fill(0.0);
+  k.mu2_values.resize(k.lambda_values.size());
+  k.mu2_values.fill(0.0);
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    if (cell.type() != IT_Triangle3)
+      ARCANE_FATAL("Only Triangle3 cell type is supported");
+
+    lambda = 1.0;
+    mu2 = 0.0;
+    auto K_lambda_e = _computeElementMatrixTRIA3(cell);
+    lambda = 0.0;
+    mu2 = 1.0;
+    auto K_mu_e = _computeElementMatrixTRIA3(cell);
+
+    Int64 offset = static_cast<Int64>(nnz) * m_materials.materialIndex(cell);
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      if (node1.isOwn()) {
+        Int32 n2_index = 0;
+        for (Node node2 : cell.nodes()) {
+          for (Int32 c1 = 0; c1 < 2; ++c1) {
+            for (Int32 c2 = 0; c2 < 2; ++c2) {
+              Int64 i = offset + _splitStiffnessIndex(node_dof.dofId(node1, c1), node_dof.dofId(node2, c2));
+              k.lambda_values[i] += K_lambda_e(2 * n1_index + c1, 2 * n2_index + c2);
+              k.mu2_values[i] += K_mu_e(2 * n1_index + c1, 2 * n2_index + c2);
+            }
+          }
+          ++n2_index;
+        }
+      }
+      ++n1_index;
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add K = sum_m (lambda_m K_lambda_m + mu2_m K_mu_m) to the matrix.
+ *
+ * The values are combined in a CSR array and then added to the linear
+ * system with one matrixAddValue() call per non zero entry.
+ */
+void FemModule::
+_addSplitStiffness()
+{
+  const SplitStiffness& k = m_split_stiffness;
+  Int32 nnz = k.columns.size();
+
+  UniqueArray<Real> values(nnz);
+  values.fill(0.0);
+  for (Int32 mat = 0, nb_material = m_materials.nbMaterial(); mat < nb_material; ++mat) {
+    Real mat_lambda = m_materials.value(MAT_LAMBDA, mat);
+    Real mat_mu2 = m_materials.value(MAT_MU2, mat);
+    ConstArrayView<Real> lambda_values = k.lambda_values.subConstView(static_cast<Int64>(nnz) * mat, nnz);
+    ConstArrayView<Real> mu2_values = k.mu2_values.subConstView(static_cast<Int64>(nnz) * mat, nnz);
+    for (Int32 i = 0; i < nnz; ++i)
+      values[i] += mat_lambda * lambda_values[i] + mat_mu2 * mu2_values[i];
+  }
+
+  for (Int32 row = 0, nb_row = k.rows_index.size() - 1; row < nb_row; ++row)
+    for (Int32 i = k.rows_index[row]; i < k.rows_index[row + 1]; ++i)
+      m_linear_system.matrixAddValue(DoFLocalId(row), DoFLocalId(k.columns[i]), values[i]);
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -1095,8 +1350,7 @@ _checkResultFile()
   if (filename.empty())
     return;
   const double epsilon = 1.0e-4;
-  // TODO
-  //Arcane::FemUtils::checkNodeResultFile(traceMng(), filename, m_U.x, epsilon);
+  checkNodeResultFile(traceMng(), filename, m_U, epsilon);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -23,6 +23,8 @@
 #include "FemUtils.h"
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
+#include "FemLoadPipeline.h"
+#include "FemMaterialTable.h"
 
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -43,6 +45,8 @@ class FemModule
   explicit FemModule(const ModuleBuildInfo& mbi)
   : ArcaneFemObject(mbi)
   , m_dofs_on_nodes(mbi.subDomain()->traceMng())
+  , m_materials(mbi.subDomain()->traceMng())
+  , m_load_pipeline(mbi.subDomain()->traceMng())
   {
     ICaseMng* cm = mbi.subDomain()->caseMng();
     cm->setTreatWarningAsError(true);
@@ -104,6 +108,12 @@ class FemModule
   DoFLinearSystem m_linear_system;
   FemDoFsOnNodes m_dofs_on_nodes;
 
+  //! Material of each cell and constants c0..c10 of each material
+  FemMaterialTable m_materials;
+  //! Index of the constants in m_materials (MAT_C0 + i is ci)
+  static constexpr Int32 MAT_C0 = 0;
+  static constexpr Int32 MAT_NB_COEFFICIENT = 11;
+
   // Struct to make sure we are using a CaseTable associated
   // to the right file
   struct CaseTableInfo
@@ -114,6 +124,23 @@ class FemModule
   // List of CaseTable for traction boundary conditions
   UniqueArray<CaseTableInfo> m_traction_case_table_list;
 
+  // Loads which only depend on the time (body forces and traction). They
+  // are computed from the arrays below, which are built at the
+  // initialisation, so that the next time step can be prepared in another
+  // thread during the solve (see 'async-loads' option).
+  FemLoadPipeline m_load_pipeline;
+  //! Body force term of the DoFs
+  UniqueArray<Real> m_body_force_loads;
+  //! Traction input of each traction boundary condition (null for a constant traction)
+  UniqueArray<CaseTable*> m_traction_load_case_table;
+  //! Constant traction of each traction boundary condition
+  UniqueArray<Real3> m_traction_load_value;
+  //! Boundary condition, DoF, direction (0 for x, 1 for y) and weight of the traction terms
+  UniqueArray<Int32> m_traction_load_condition;
+  UniqueArray<Int32> m_traction_load_dof;
+  UniqueArray<Int32> m_traction_load_direction;
+  UniqueArray<Real> m_traction_load_weight;
+
  private:
 
   void _doStationarySolve();
@@ -133,6 +160,10 @@ class FemModule
   void _applyDirichletBoundaryConditions();
   void _checkResultFile();
   void _readCaseTables();
+  void _initLoads();
+  void _computeLoads(Real time, ArrayView<Real> loads) const;
+  void _computeMaterialConstants(Int32 mat_index, Real mat_rho, Real mat_lambda, Real mat_mu);
+  void _setCellConstants(Cell cell);
 };
 
 /*---------------------------------------------------------------------------*/
@@ -144,19 +175,30 @@ compute()
   info() << "Module Fem COMPUTE";
 
   // Stop code after computations
-  if (t >= tmax)
+  bool is_last_step = (t >= tmax);
+  if (is_last_step)
     subDomain()->timeLoopMng()->stopComputeLoop(true);
 
   info() << "Time iteration at t : " << t << " (s) ";
 
-  m_linear_system.reset();
-  m_linear_system.setLinearSystemFactory(options()->linearSystem());
-  m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
+  // With a frozen matrix the linear system is kept between time steps and
+  // only the RHS vector is assembled again.
+  if (!m_linear_system.isInitialized() || !options()->freezeMatrix()) {
+    m_linear_system.reset();
+    m_linear_system.setLinearSystemFactory(options()->linearSystem());
+    m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
+    if (options()->freezeMatrix())
+      m_linear_system.setMatrixFrozen(true);
+  }
 
   _doStationarySolve();
 
   _updateVariables();
 
+  // Displacements of the last time step
+  if (is_last_step)
+    _checkResultFile();
+
   _updateTime();
 }
 
@@ -180,6 +222,7 @@ startInit()
   m_global_deltat.assign(dt);
 
   _readCaseTables();
+  _initLoads();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -200,19 +243,21 @@ _doStationarySolve()
 {
 
   // Assemble the FEM bilinear operator (LHS - matrix A)
-  if (options()->meshType == "QUAD4")
-    _assembleBilinearOperatorQUAD4();
-  else
-    _assembleBilinearOperatorTRIA3();
+  if (!m_linear_system.hasFrozenMatrix()) {
+    if (options()->meshType == "QUAD4")
+      _assembleBilinearOperatorQUAD4();
+    else
+      _assembleBilinearOperatorTRIA3();
+  }
 
   // Assemble the FEM linear operator (RHS - vector b)
   _assembleLinearOperator();
 
+  // Loads of the next time step, computed during the solve with 'async-loads'
+  m_load_pipeline.prepare(t + dt);
+
   // Solve for [u1,u2]
   _solve();
-
-  // Check results TODO
-  // _checkResultFile();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -262,18 +307,6 @@ _getParameters()
     gamma = 0.5;
     beta  = (1./4.)*(gamma+0.5)*(gamma+0.5)  ;
 
-    c0 =   rho/(beta*dt*dt) + etam*rho*gamma/beta/dt                          ;
-    c1 =   lambda + lambda*etak*gamma/beta/dt                                 ;
-    c2 =   2.*mu + 2.*mu*etak*gamma/beta/dt                                   ;
-    c3 =   rho/beta/dt - etam*rho*(1-gamma/beta)                              ;
-    c4 =   rho*( (1.-2.*beta)/2./beta  - etam*dt*(1.-gamma/2/beta))           ;
-    c5 =  -lambda*etak*gamma/beta/dt                                          ;
-    c6 =  -2.*mu*etak*gamma/beta/dt                                           ;
-    c7 =   etak*lambda*(gamma/beta - 1)                                       ;
-    c8 =   etak*lambda*dt*((1.-2*beta)/2./beta - (1.-gamma))                  ;
-    c9 =   etak*2*mu*(gamma/beta -1)                                          ;
-    c10=   etak*2*mu*dt*((1.-2*beta)/2./beta -(1.-gamma))                     ;
-
     }
 
   else if (options()->timeDiscretization == "Generalized-alpha") {
@@ -283,18 +316,6 @@ _getParameters()
     gamma = 0.5 + alpf - alpm                ;
     beta  = (1./4.)*(gamma+0.5)*(gamma+0.5)  ;
 
-    c0 =   rho*(1.-alpm)/(beta*dt*dt) + etam*rho*gamma*(1-alpf)/beta/dt       ;
-    c1 =   lambda*(1.-alpf) + lambda*etak*gamma*(1.-alpf)/beta/dt             ;
-    c2 =   2.*mu*(1.-alpf) + 2.*mu*etak*gamma*(1.-alpf)/beta/dt               ;
-    c3 =   rho*(1.-alpm)/beta/dt - etam*rho*(1-gamma*(1-alpf)/beta)           ;
-    c4 =   rho*( (1.-alpm)*(1.-2.*beta)/2./beta - alpm - etam*dt*(1.-alpf)*(1.-gamma/2/beta))   ;
-    c5 =   lambda*alpf -    lambda*etak*gamma*(1.-alpf)/beta/dt               ;
-    c6 =   2*mu*alpf   -    2.*mu*etak*gamma*(1.-alpf)/beta/dt                ;
-    c7 =   etak*lambda*(gamma*(1.-alpf)/beta - 1)                             ;
-    c8 =   etak*lambda*dt*(1.-alpf)*((1.-2*beta)/2./beta - (1.-gamma))        ;
-    c9 =   etak*2*mu*(gamma*(1.-alpf)/beta -1)                                ;
-    c10=   etak*2*mu*dt*(1.-alpf)*((1.-2*beta)/2./beta -(1.-gamma))           ;
-
     }
 
   else {
@@ -302,6 +323,95 @@ _getParameters()
     ARCANE_FATAL("Only Newmark-beta | Generalized-alpha are supported for time-discretization ");
 
     }
+
+  //----- constants c0..c10 computed once per material -----//
+  // Material 0 is used by the cells which are not in a 'material-property'
+  m_materials.initialize(mesh(), "Elastodynamics", MAT_NB_COEFFICIENT);
+  _computeMaterialConstants(0, rho, lambda, mu);
+
+  for (const auto& bs : options()->materialProperty()) {
+    CellGroup group = bs->volume();
+    Real mat_E = bs->E();
+    Real mat_nu = bs->nu();
+    Real mat_rho = bs->rho();
+    info() << "Material for group=" << group.name() << " E=" << mat_E
+           << " nu=" << mat_nu << " rho=" << mat_rho;
+
+    Int32 mat_index = m_materials.addMaterial(group);
+    _computeMaterialConstants(mat_index, mat_rho,
+                              mat_E*mat_nu/((1+mat_nu)*(1-2*mat_nu)),
+                              mat_E/(2*(1+mat_nu)));
+  }
+
+  _setCellConstants(Cell());
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_computeMaterialConstants(Int32 mat_index, Real mat_rho, Real mat_lambda, Real mat_mu)
+{
+  Real c[MAT_NB_COEFFICIENT];
+
+  if (options()->timeDiscretization == "Newmark-beta") {
+
+    c[0] =   mat_rho/(beta*dt*dt) + etam*mat_rho*gamma/beta/dt                          ;
+    c[1] =   mat_lambda + mat_lambda*etak*gamma/beta/dt                                 ;
+    c[2] =   2.*mat_mu + 2.*mat_mu*etak*gamma/beta/dt                                   ;
+    c[3] =   mat_rho/beta/dt - etam*mat_rho*(1-gamma/beta)                              ;
+    c[4] =   mat_rho*( (1.-2.*beta)/2./beta  - etam*dt*(1.-gamma/2/beta))           ;
+    c[5] =  -mat_lambda*etak*gamma/beta/dt                                          ;
+    c[6] =  -2.*mat_mu*etak*gamma/beta/dt                                           ;
+    c[7] =   etak*mat_lambda*(gamma/beta - 1)                                       ;
+    c[8] =   etak*mat_lambda*dt*((1.-2*beta)/2./beta - (1.-gamma))                  ;
+    c[9] =   etak*2*mat_mu*(gamma/beta -1)                                          ;
+    c[10]=   etak*2*mat_mu*dt*((1.-2*beta)/2./beta -(1.-gamma))                     ;
+
+    }
+
+  else {
+
+    c[0] =   mat_rho*(1.-alpm)/(beta*dt*dt) + etam*mat_rho*gamma*(1-alpf)/beta/dt       ;
+    c[1] =   mat_lambda*(1.-alpf) + mat_lambda*etak*gamma*(1.-alpf)/beta/dt             ;
+    c[2] =   2.*mat_mu*(1.-alpf) + 2.*mat_mu*etak*gamma*(1.-alpf)/beta/dt               ;
+    c[3] =   mat_rho*(1.-alpm)/beta/dt - etam*mat_rho*(1-gamma*(1-alpf)/beta)           ;
+    c[4] =   mat_rho*( (1.-alpm)*(1.-2.*beta)/2./beta - alpm - etam*dt*(1.-alpf)*(1.-gamma/2/beta))   ;
+    c[5] =   mat_lambda*alpf -    mat_lambda*etak*gamma*(1.-alpf)/beta/dt               ;
+    c[6] =   2*mat_mu*alpf   -    2.*mat_mu*etak*gamma*(1.-alpf)/beta/dt                ;
+    c[7] =   etak*mat_lambda*(gamma*(1.-alpf)/beta - 1)                             ;
+    c[8] =   etak*mat_lambda*dt*(1.-alpf)*((1.-2*beta)/2./beta - (1.-gamma))        ;
+    c[9] =   etak*2*mat_mu*(gamma*(1.-alpf)/beta -1)                                ;
+    c[10]=   etak*2*mat_mu*dt*(1.-alpf)*((1.-2*beta)/2./beta -(1.-gamma))           ;
+
+    }
+
+  for (Int32 i = 0; i < MAT_NB_COEFFICIENT; ++i)
+    m_materials.setValue(MAT_C0 + i, mat_index, c[i]);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Load the constants c0..c10 of the material of \a cell.
+ *
+ * If \a cell is null, the constants of the default material are used.
+ */
+void FemModule::
+_setCellConstants(Cell cell)
+{
+  Int32 mat_index = (cell.null()) ? 0 : m_materials.materialIndex(cell);
+  c0  = m_materials.value(MAT_C0 + 0, mat_index);
+  c1  = m_materials.value(MAT_C0 + 1, mat_index);
+  c2  = m_materials.value(MAT_C0 + 2, mat_index);
+  c3  = m_materials.value(MAT_C0 + 3, mat_index);
+  c4  = m_materials.value(MAT_C0 + 4, mat_index);
+  c5  = m_materials.value(MAT_C0 + 5, mat_index);
+  c6  = m_materials.value(MAT_C0 + 6, mat_index);
+  c7  = m_materials.value(MAT_C0 + 7, mat_index);
+  c8  = m_materials.value(MAT_C0 + 8, mat_index);
+  c9  = m_materials.value(MAT_C0 + 9, mat_index);
+  c10 = m_materials.value(MAT_C0 + 10, mat_index);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -322,6 +432,123 @@ _readCaseTables()
   }
 }
 
+/*---------------------------------------------------------------------------*/
+// Loads which only depend on the time
+//  - The DoFs and the weights of the body force and traction terms are
+//    computed once here, only for the own nodes that are non-Dirichlet
+//  - _computeLoads() then only reads these arrays and the CaseTables, so
+//    that it can run in another thread
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_initLoads()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Int32 nb_dof = m_dofs_on_nodes.dofFamily()->maxLocalId();
+
+  //----------------------------------------------
+  // Body force term
+  //----------------------------------------------
+  //  $int_{Omega}(f1*v1^h)$
+  //  $int_{Omega}(f2*v2^h)$
+  //----------------------------------------------
+  m_body_force_loads.resize(nb_dof);
+  m_body_force_loads.fill(0.0);
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    Real area = _computeAreaTriangle3(cell);
+    for (Node node : cell.nodes()) {
+      if (!node.isOwn())
+        continue;
+      if (options()->f1.isPresent() && !(m_u1_fixed[node]))
+        m_body_force_loads[node_dof.dofId(node, 0).localId()] += f1 * area / 3;
+      if (options()->f2.isPresent() && !(m_u2_fixed[node]))
+        m_body_force_loads[node_dof.dofId(node, 1).localId()] += f2 * area / 3;
+    }
+  }
+
+  //----------------------------------------------
+  // Traction term
+  //----------------------------------------------
+  //  $int_{dOmega_N}((tx.nx)*v1^h)$
+  //  $int_{dOmega_N}((ty.ny)*v1^h)$
+  //----------------------------------------------
+  Int32 boundary_condition_index = 0;
+
+  for (const auto& bs : options()->tractionBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+    const CaseTableInfo& case_table_info = m_traction_case_table_list[boundary_condition_index];
+    const Int32 condition_index = boundary_condition_index;
+    ++boundary_condition_index;
+
+    CaseTable* inn = nullptr;
+    bool has_t1 = bs->t1.isPresent();
+    bool has_t2 = bs->t2.isPresent();
+    if (bs->tractionInputFile.isPresent()) {
+      String file_name = bs->tractionInputFile();
+      info() << "Applying traction boundary conditions for surface " << group.name()
+             << " via CaseTable" << file_name;
+      inn = case_table_info.case_table;
+      if (!inn)
+        ARCANE_FATAL("CaseTable is null. Maybe there is a missing call to _readCaseTables()");
+      if (file_name != case_table_info.file_name)
+        ARCANE_FATAL("Incoherent CaseTable. The current CaseTable is associated to file '{0}'", case_table_info.file_name);
+      has_t1 = true;
+      has_t2 = true;
+    }
+    else
+      info() << "Applying constant traction boundary conditions for surface " << group.name();
+
+    m_traction_load_case_table.add(inn);
+    m_traction_load_value.add(Real3(bs->t1(), bs->t2(), 0.));
+
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+      Real length = _computeEdgeLength2(face);
+      for (Node node : iface->nodes()) {
+        if (!node.isOwn())
+          continue;
+        for (Int32 idof = 0; idof < 2; ++idof) {
+          bool has_traction = (idof == 0) ? has_t1 : has_t2;
+          bool is_fixed = (idof == 0) ? m_u1_fixed[node] : m_u2_fixed[node];
+          if (!has_traction || is_fixed)
+            continue;
+          m_traction_load_condition.add(condition_index);
+          m_traction_load_dof.add(node_dof.dofId(node, idof).localId());
+          m_traction_load_direction.add(idof);
+          m_traction_load_weight.add(length / 2.);
+        }
+      }
+    }
+  }
+
+  m_load_pipeline.initialize(nb_dof, [this](Real time, ArrayView<Real> loads) { _computeLoads(time, loads); });
+  m_load_pipeline.setAsynchronous(options()->asyncLoads());
+  if (options()->asyncLoads())
+    info() << "The loads of the next time step are computed during the solve";
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_computeLoads(Real time, ArrayView<Real> loads) const
+{
+  loads.copy(m_body_force_loads);
+
+  const Int32 nb_condition = m_traction_load_case_table.size();
+  UniqueArray<Real3> trac(nb_condition);
+  for (Int32 i = 0; i < nb_condition; ++i) {
+    if (m_traction_load_case_table[i])
+      m_traction_load_case_table[i]->value(time, trac[i]);
+    else
+      trac[i] = m_traction_load_value[i];
+  }
+
+  for (Int32 i = 0, n = m_traction_load_dof.size(); i < n; ++i)
+    loads[m_traction_load_dof[i]] += trac[m_traction_load_condition[i]][m_traction_load_direction[i]] * m_traction_load_weight[i];
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -640,43 +867,25 @@ _assembleLinearOperator()
     ARCANE_FATAL( "Dirichlet boundary conditions were not applied " );
   }
   //----------------------------------------------
-  // Body force term assembly
+  // Body force and traction terms (see _initLoads())
   //----------------------------------------------
   //
   //  $int_{Omega}(f1*v1^h)$
-  //  $int_{Omega}(f2*v2^h)$
+  //  $int_{dOmega_N}((tx.nx)*v1^h)$
   //  only for nodes that are non-Dirichlet
   //----------------------------------------------
 
-  if ( options()->f1.isPresent()) {
-    ENUMERATE_ (Cell, icell, allCells()) {
-      Cell cell = *icell;
-      Real area = _computeAreaTriangle3(cell);
-      for (Node node : cell.nodes()) {
-        if (!(m_u1_fixed[node]) && node.isOwn()) {
-          DoFLocalId dof_id1 = node_dof.dofId(node, 0);
-          rhs_values[dof_id1] += f1 * area / 3;
-        }
-      }
-    }
-  }
-
-  if ( options()->f2.isPresent()) {
-    ENUMERATE_ (Cell, icell, allCells()) {
-      Cell cell = *icell;
-      Real area = _computeAreaTriangle3(cell);
-      for (Node node : cell.nodes()) {
-        if (!(m_u2_fixed[node]) && node.isOwn()) {
-          DoFLocalId dof_id2 = node_dof.dofId(node, 1);
-          rhs_values[dof_id2] += f2 * area / 3;
-        }
-      }
+  {
+    ConstArrayView<Real> loads = m_load_pipeline.loads(t);
+    ENUMERATE_ (DoF, idof, m_dofs_on_nodes.dofFamily()->allItems().own()) {
+      rhs_values[idof] += loads[idof.itemLocalId()];
     }
   }
 
   ENUMERATE_ (Cell, icell, allCells()) {
     Cell cell = *icell;
     Real area = _computeAreaTriangle3(cell);
+    _setCellConstants(cell);
 
     Real3 m0 = m_node_coord[cell.nodeId(0)];
     Real3 m1 = m_node_coord[cell.nodeId(1)];
@@ -855,125 +1064,6 @@ $$
       i++;
     }
   }
-
-  //----------------------------------------------
-  // Traction term assembly
-  //----------------------------------------------
-  //
-  //  $int_{dOmega_N}((tx.nx)*v1^h)$
-  //  $int_{dOmega_N}((ty.ny)*v1^h)$
-  //  only for noded that are non-Dirichlet
-  //----------------------------------------------
-
-  // Index of the boundary condition. Needed to associate a CaseTable
-  Int32 boundary_condition_index = 0;
-  for (const auto& bs : options()->tractionBoundaryCondition()) {
-    FaceGroup group = bs->surface();
-    const CaseTableInfo& case_table_info = m_traction_case_table_list[boundary_condition_index];
-    ++boundary_condition_index;
-
-    Real3 trac;  // traction in x, y and z
-
-    if (bs->tractionInputFile.isPresent()){
-
-      String file_name = bs->tractionInputFile();
-      info() << "Applying traction boundary conditions for surface "<< group.name()
-             << " via CaseTable" <<  file_name;
-      CaseTable* inn = case_table_info.case_table;
-      if (!inn)
-        ARCANE_FATAL("CaseTable is null. Maybe there is a missing call to _readCaseTables()");
-      if (file_name!=case_table_info.file_name)
-        ARCANE_FATAL("Incoherent CaseTable. The current CaseTable is associated to file '{0}'",case_table_info.file_name);
-      inn->value(t, trac);
-
-      ENUMERATE_ (Face, iface, group) {
-        Face face = *iface;
-        Real length = _computeEdgeLength2(face);
-        for (Node node : iface->nodes()) {
-          if (!(m_u1_fixed[node]) && node.isOwn()) {
-            DoFLocalId dof_id1 = node_dof.dofId(node, 0);
-            rhs_values[dof_id1] += trac.x * length / 2.;
-          }
-          if (!(m_u2_fixed[node]) && node.isOwn()) {
-            DoFLocalId dof_id2 = node_dof.dofId(node, 1);
-            rhs_values[dof_id2] += trac.y * length / 2.;
-          }
-        }
-      }
-      continue;
-    }
-    else {
-
-      info() << "Applying constant traction boundary conditions for surface "<< group.name();
-
-      trac.x = bs->t1();
-      trac.y = bs->t2();
-      if( bs->t1.isPresent() && bs->t2.isPresent()) {
-        ENUMERATE_ (Face, iface, group) {
-          Face face = *iface;
-          Real length = _computeEdgeLength2(face);
-          for (Node node : iface->nodes()) {
-            if (!(m_u1_fixed[node]) && node.isOwn()) {
-              DoFLocalId dof_id1 = node_dof.dofId(node, 0);
-              rhs_values[dof_id1] += trac.x * length / 2.;
-            }
-            if (!(m_u2_fixed[node]) && node.isOwn()) {
-              DoFLocalId dof_id2 = node_dof.dofId(node, 1);
-              rhs_values[dof_id2] += trac.y * length / 2.;
-            }
-          }
-        }
-        continue;
-      }
-
-      if( bs->t1.isPresent()) {
-        ENUMERATE_ (Face, iface, group) {
-          Face face = *iface;
-          Real length = _computeEdgeLength2(face);
-          for (Node node : iface->nodes()) {
-            if (!(m_u1_fixed[node]) && node.isOwn()) {
-              DoFLocalId dof_id1 = node_dof.dofId(node, 0);
-              rhs_values[dof_id1] += trac.x * length / 2.;
-            }
-          }
-        }
-        continue;
-      }
-
-      if( bs->t2.isPresent()) {
-        ENUMERATE_ (Face, iface, group) {
-          Face face = *iface;
-          Real length = _computeEdgeLength2(face);
-          for (Node node : iface->nodes()) {
-            if (!(m_u2_fixed[node]) && node.isOwn()) {
-              DoFLocalId dof_id2 = node_dof.dofId(node, 1);
-              rhs_values[dof_id2] += trac.y * length / 2. ;
-            }
-          }
-        }
-        continue;
-      }
-
-    }
-
-   /*
-   // tt/0.8*(tt <= 0.8)+ 0.*(tt > 0.8)
-    trac.x = bs->t1();
-    trac.y = bs->t2();
-    trac.y = (t - dt);
-    Real toto = 0.0;
-    std::cout.precision(17);
-    if(trac.y <=0.8){
-      trac.y = trac.y/0.8;
-      cout << std::scientific<<"tttt " << t << "\t"<< trac.x << "\t"<< trac.y << "\t" << toto << endl;
-    }
-    else{
-      trac.y = 0.;
-      cout << std::scientific<<"tttt " << t << "\t"<< trac.x << "\t"<< trac.y << "\t" << toto <<endl;
-    }
-    */
-
-  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1408,6 +1498,7 @@ _assembleBilinearOperatorQUAD4()
     if (cell.type() != IT_Quad4)
       ARCANE_FATAL("Only Quad4 cell type is supported");
 
+    _setCellConstants(cell);
     auto K_e = _computeElementMatrixQUAD4(cell);  // element stiffness matrix
     // assemble elementary  matrix into the global one elementary terms are
     // positioned into K  according to the rank  of associated  node in the
@@ -1459,6 +1550,7 @@ _assembleBilinearOperatorTRIA3()
     if (cell.type() != IT_Triangle3)
       ARCANE_FATAL("Only Triangle3 cell type is supported");
 
+    _setCellConstants(cell);
     auto K_e = _computeElementMatrixTRIA3(cell);  // element stiffness matrix
     // assemble elementary matrix into  the global one elementary terms are
     // positioned into  K according  to the rank of associated  node in the
@@ -1547,13 +1639,14 @@ _solve()
 void FemModule::
 _checkResultFile()
 {
+  if (options()->writeResultFile.isPresent())
+    writeNodeResultFile(traceMng(), options()->writeResultFile(), m_U);
   String filename = options()->resultFile();
   info() << "CheckResultFile filename=" << filename;
   if (filename.empty())
     return;
   const double epsilon = 1.0e-4;
-  // TODO
-  //Arcane::FemUtils::checkNodeResultFile(traceMng(), filename, m_U.x, epsilon);
+  checkNodeResultFile(traceMng(), filename, m_U, epsilon);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1,11 +1,11 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
 /*---------------------------------------------------------------------------*/
-/* FemModule.cc                                                (C) 2022-2023 */
+/* FemModule.cc                                                (C) 2022-2024 */
 /*                                                                           */
 /* Simple module to test simple FEM mechanism.                               */
 /*---------------------------------------------------------------------------*/
@@ -14,12 +14,15 @@
 #include <arcane/utils/NumArray.h>
 #include <arcane/utils/CommandLineArguments.h>
 #include <arcane/utils/StringList.h>
+#include <arcane/utils/OStringStream.h>
+#include <arcane/utils/ValueConvert.h>
 
 #include <arcane/ITimeLoopMng.h>
 #include <arcane/IMesh.h>
 #include <arcane/IItemFamily.h>
 #include <arcane/ItemGroup.h>
 #include <arcane/ICaseMng.h>
+#include <arcane/IParallelMng.h>
 
 #include "IDoFLinearSystemFactory.h"
 #include "Fem_axl.h"
@@ -27,6 +30,8 @@
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
 
+#include <fstream>
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -93,6 +98,9 @@ class FemModule
   Real _computeEdgeLength2(Face face);
   Real2 _computeEdgeNormal2(Face face);
   Real2 _computeDxDyOfRealTRIA3(Cell cell);
+  void _computeCapacitanceMatrix();
+  void _computeElectrodeCharges(ConstArrayView<Int32> node_electrode, Int32 nb_electrode);
+  void _checkCapacitanceResultFile(ConstArrayView<Real> charges, Int32 nb_electrode);
 
 };
 
@@ -121,7 +129,10 @@ compute()
     m_linear_system.setSolverCommandLineArguments(args);
   }
   info() << "NB_CELL=" << allCells().size() << " NB_FACE=" << allFaces().size();
-  _doStationarySolve();
+  if (options()->capacitanceElectrode().size() > 0)
+    _computeCapacitanceMatrix();
+  else
+    _doStationarySolve();
   _getE();
 }
 
@@ -164,6 +175,175 @@ _doStationarySolve()
   _checkResultFile();
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Compute the capacitance matrix of the electrodes.
+ *
+ * The potential phi_j of the unit excitation of the electrode j (1 on j, 0
+ * on the other electrodes and on the Dirichlet surfaces, no charge density)
+ * is computed for each electrode. All these problems have the same matrix,
+ * which is assembled once and frozen: only the RHS changes between solves.
+ *
+ * The charge of the electrode i is the sum of the residuals of the rows of
+ * its nodes: Q_i = epsilon (K phi_j)_i, so that C_ij = epsilon phi_i^T K phi_j.
+ */
+void FemModule::
+_computeCapacitanceMatrix()
+{
+  _getMaterialParameters();
+  String method = options()->enforceDirichletMethod();
+  if (method != "Penalty" && method != "WeakPenalty")
+    ARCANE_FATAL("Only 'Penalty' and 'WeakPenalty' Dirichlet methods are supported for the capacitance matrix (method={0})", method);
+
+  // Electrode index of each node (-1 if not on an electrode)
+  Int32 nb_electrode = options()->capacitanceElectrode().size();
+  UniqueArray<Int32> node_electrode(mesh()->nodeFamily()->maxLocalId(), -1);
+  for (Int32 i = 0; i < nb_electrode; ++i) {
+    FaceGroup group = options()->capacitanceElectrode()[i];
+    info() << "Capacitance electrode index=" << i << " surface=" << group.name();
+    ENUMERATE_ (Face, iface, group) {
+      for (Node node : iface->nodes()) {
+        node_electrode[node.localId()] = i;
+        m_phi_dirichlet[node] = true;
+      }
+    }
+  }
+
+  m_linear_system.setMatrixFrozen(true);
+  _assembleBilinearOperatorTRIA3();
+
+  m_phi_excitation.resize(nb_electrode);
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Real Penalty = options()->penalty(); // 1.0e30 is the default
+
+  // The diagonal terms of the penalty method are the same for all the
+  // excitations: they are set once, before the first solve
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    if (!m_phi_dirichlet[node])
+      continue;
+    DoFLocalId dof_id = node_dof.dofId(node, 0);
+    if (method == "Penalty")
+      m_linear_system.matrixSetValue(dof_id, dof_id, Penalty);
+    else
+      m_linear_system.matrixAddValue(dof_id, dof_id, Penalty);
+  }
+
+  for (Int32 j = 0; j < nb_electrode; ++j) {
+    VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
+    rhs_values.fill(0.0);
+    ENUMERATE_ (Node, inode, ownNodes()) {
+      Node node = *inode;
+      if (node_electrode[node.localId()] == j)
+        rhs_values[node_dof.dofId(node, 0)] = Penalty;
+    }
+    m_linear_system.solve();
+
+    VariableDoFReal& dof_u(m_linear_system.solutionVariable());
+    ENUMERATE_ (Node, inode, ownNodes()) {
+      Node node = *inode;
+      Real v = dof_u[node_dof.dofId(node, 0)];
+      if (m_phi_dirichlet[node])
+        v = (node_electrode[node.localId()] == j) ? 1.0 : 0.0;
+      m_phi_excitation[node][j] = v;
+    }
+  }
+  m_phi_excitation.synchronize();
+
+  _computeElectrodeCharges(node_electrode, nb_electrode);
+
+  // The potential of the first excitation is kept for the post-processing
+  ENUMERATE_ (Node, inode, allNodes()) {
+    m_phi[inode] = m_phi_excitation[inode][0];
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Compute the charges of all the electrodes for all the excitations.
+ *
+ * The element residuals K_e phi_j of all the excitations are computed in the
+ * same loop on the cells, so that each element matrix is computed once.
+ */
+void FemModule::
+_computeElectrodeCharges(ConstArrayView<Int32> node_electrode, Int32 nb_electrode)
+{
+  // charges[i * nb_electrode + j]: charge of electrode i for the excitation j
+  UniqueArray<Real> charges(nb_electrode * nb_electrode, 0.0);
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    auto K_e = _computeElementMatrixTRIA3(cell);
+    for (Int32 n1 = 0; n1 < 3; ++n1) {
+      Node node1 = cell.node(n1);
+      Int32 i = node_electrode[node1.localId()];
+      if (i < 0 || !node1.isOwn())
+        continue;
+      for (Int32 j = 0; j < nb_electrode; ++j) {
+        Real r = 0.0;
+        for (Int32 n2 = 0; n2 < 3; ++n2)
+          r += K_e(n1, n2) * m_phi_excitation[cell.node(n2)][j];
+        charges[i * nb_electrode + j] += epsilon * r;
+      }
+    }
+  }
+  parallelMng()->reduce(Parallel::ReduceSum, charges);
+
+  info() << "Capacitance matrix (C_ij = charge of electrode i for a unit potential on electrode j):";
+  for (Int32 i = 0; i < nb_electrode; ++i) {
+    OStringStream ostr;
+    for (Int32 j = 0; j < nb_electrode; ++j)
+      ostr() << " " << charges[i * nb_electrode + j];
+    info() << "C[" << options()->capacitanceElectrode()[i].name() << "] =" << ostr.str();
+  }
+
+  _checkCapacitanceResultFile(charges, nb_electrode);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Check the capacitance matrix against a reference file.
+ *
+ * Each line of the file contains the indexes 'i j' of the electrodes and the
+ * reference value of C_ij. Only the listed coefficients are checked.
+ */
+void FemModule::
+_checkCapacitanceResultFile(ConstArrayView<Real> charges, Int32 nb_electrode)
+{
+  String filename = options()->capacitanceResultFile();
+  info() << "CheckCapacitanceResultFile filename=" << filename;
+  if (filename.empty())
+    return;
+  const double epsilon = 1.0e-4;
+
+  std::ifstream sbuf(filename.localstr());
+  if (!sbuf)
+    ARCANE_FATAL("Can not open file '{0}'", filename);
+  Int32 nb_error = 0;
+  Int32 i = 0;
+  Int32 j = 0;
+  Real ref_v = 0.0;
+  sbuf >> std::ws;
+  while (!sbuf.eof()) {
+    sbuf >> i >> std::ws >> j >> std::ws >> ref_v;
+    if (sbuf.fail() || sbuf.bad())
+      ARCANE_FATAL("Error during parsing of file '{0}'", filename);
+    if (i < 0 || i >= nb_electrode || j < 0 || j >= nb_electrode)
+      ARCANE_FATAL("Invalid electrode index i={0} j={1} in file '{2}'", i, j, filename);
+    Real v = charges[i * nb_electrode + j];
+    if (!TypeEqualT<double>::isNearlyEqualWithEpsilon(ref_v, v, epsilon)) {
+      ++nb_error;
+      info() << String::format("ERROR: i={0} j={1} ref={2} v={3} diff={4}",
+                               i, j, ref_v, v, ref_v - v);
+    }
+    sbuf >> std::ws;
+  }
+  if (nb_error > 0)
+    ARCANE_FATAL("Error checking the capacitance matrix nb_error={0}", nb_error);
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
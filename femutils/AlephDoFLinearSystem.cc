@@ -1,11 +1,11 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
 /*---------------------------------------------------------------------------*/
-/* AlephDoFLinearSystem.cc                                     (C) 2022-2023 */
+/* AlephDoFLinearSystem.cc                                     (C) 2022-2024 */
 /*                                                                           */
 /* Linear system: Matrix A + Vector x + Vector b for Ax=b.                   */
 /*---------------------------------------------------------------------------*/
@@ -95,6 +95,19 @@ class AlephDoFLinearSystemImpl
    */
   using RowColumnMap = std::map<RowColumn, Real>;
 
+  /*!
+   * \brief Entry A[row,column] of the matrix where \a row is eliminated
+   * with a Row+Column elimination.
+   *
+   * These entries are needed to compute the lifting of the RHS vector.
+   */
+  struct EliminatedColumnEntry
+  {
+    Int32 row_id = 0;
+    Int32 column_id = 0;
+    Real value = 0.0;
+  };
+
  public:
 
   // TODO: do not use subDomain() but we need to modify aleph before
@@ -194,6 +207,8 @@ class AlephDoFLinearSystemImpl
       ARCANE_FATAL("Column is null");
     if (value == 0.0)
       return;
+    if (m_has_frozen_matrix)
+      return;
     if (m_use_value_map) {
       RowColumn rc{ row.localId(), column.localId() };
       auto x = m_values_map.find(rc);
@@ -217,6 +232,8 @@ class AlephDoFLinearSystemImpl
       ARCANE_FATAL("Column is null");
     if (!m_use_value_map)
       ARCANE_FATAL("matrixSetValue() is only allowed if 'm_use_value_map' is true");
+    if (m_has_frozen_matrix)
+      return;
     m_forced_set_values_map[{ row.localId(), column.localId() }] = value;
   }
 
@@ -226,6 +243,7 @@ class AlephDoFLinearSystemImpl
       ARCANE_FATAL("Row is null");
     if (!m_use_value_map)
       ARCANE_FATAL("matrixEliminateRow() is only allowed if 'm_use_value_map' is true");
+    _checkFrozenElimination(row, ELIMINATE_ROW);
     m_dof_elimination_info[row] = ELIMINATE_ROW;
     m_dof_elimination_value[row] = value;
     info() << "EliminateRow row=" << row.localId() << " v=" << value;
@@ -237,6 +255,7 @@ class AlephDoFLinearSystemImpl
       ARCANE_FATAL("Row is null");
     if (!m_use_value_map)
       ARCANE_FATAL("matrixEliminateRowColumn() is only allowed if 'm_use_value_map' is true");
+    _checkFrozenElimination(row, ELIMINATE_ROW_COLUMN);
     m_dof_elimination_info[row] = ELIMINATE_ROW_COLUMN;
     m_dof_elimination_value[row] = value;
     info() << "EliminateRowColumn row=" << row.localId() << " v=" << value;
@@ -246,22 +265,40 @@ class AlephDoFLinearSystemImpl
   {
     UniqueArray<Real> aleph_result;
 
-    // _fillMatrix() may change the values of RHS vector
-    // with row or row-column elimination so we has to fill the RHS vector
-    // before the matrix.
-    _fillMatrix();
-    _fillRHSVector();
-
-    info() << "[AlephFem] Assemble matrix ptr=" << m_aleph_matrix;
-    m_aleph_matrix->assemble();
-    m_aleph_rhs_vector->assemble();
+    if (m_has_frozen_matrix) {
+      // The matrix is already assembled. Only the RHS vector changes with
+      // the new values of the eliminated DoFs.
+      info() << "[AlephFem] Reuse frozen matrix ptr=" << m_aleph_matrix;
+      _applyEliminationToRHSVector();
+      _fillRHSVector();
+      m_aleph_rhs_vector->assemble();
+    }
+    else {
+      // _fillMatrix() may change the values of RHS vector
+      // with row or row-column elimination so we has to fill the RHS vector
+      // before the matrix.
+      _fillMatrix();
+      _fillRHSVector();
+
+      info() << "[AlephFem] Assemble matrix ptr=" << m_aleph_matrix;
+      m_aleph_matrix->assemble();
+      m_aleph_rhs_vector->assemble();
+      if (m_is_matrix_frozen)
+        m_has_frozen_matrix = true;
+    }
     auto* aleph_solution_vector = m_aleph_solution_vector;
     DoFGroup own_dofs = m_dof_family->allItems().own();
     const Int32 nb_dof = own_dofs.size();
-    UniqueArray<Real> vector_zero(nb_dof);
-    vector_zero.fill(0.0);
+    UniqueArray<Real> initial_values(nb_dof);
+    initial_values.fill(0.0);
+    // Use the same ordering as in _fillRHSVector()
+    if (m_use_solution_as_initial_guess) {
+      ENUMERATE_ (DoF, idof, own_dofs) {
+        initial_values[idof.index()] = m_dof_variable[idof];
+      }
+    }
 
-    aleph_solution_vector->setLocalComponents(vector_zero);
+    aleph_solution_vector->setLocalComponents(initial_values);
     aleph_solution_vector->assemble();
 
     Int32 nb_iteration = 0;
@@ -324,6 +361,8 @@ class AlephDoFLinearSystemImpl
     m_dof_elimination_info.fill(0.0);
     m_values_map.clear();
     m_forced_set_values_map.clear();
+    m_eliminated_column_entries.clear();
+    m_has_frozen_matrix = false;
     _computeMatrixInfo();
   }
 
@@ -336,6 +375,36 @@ class AlephDoFLinearSystemImpl
   void setRunner(Runner* r) override { m_runner = r; }
   Runner* runner() const { return m_runner; }
 
+  void setMatrixFrozen(bool v) override
+  {
+    if (!m_use_value_map)
+      ARCANE_FATAL("setMatrixFrozen() is only allowed if 'm_use_value_map' is true");
+    m_is_matrix_frozen = v;
+    if (!v)
+      m_has_frozen_matrix = false;
+  }
+  bool hasFrozenMatrix() const override { return m_has_frozen_matrix; }
+  void setSolutionAsInitialGuess(bool v) override
+  {
+    m_use_solution_as_initial_guess = v;
+    m_aleph_params->setXoUser(v);
+  }
+  void setEpsilon(Real v) override { m_aleph_params->setEpsilon(v); }
+  // Aleph solvers only have their own preconditioners (see 'preconditioner' option)
+  void setPMultigridProlongation(const CSRFormatView&, Int32) override
+  {
+    ARCANE_THROW(NotImplementedException, "p-multigrid preconditioner is not available with Aleph");
+  }
+  // Aleph has no API for the null space: only the RHS and the solution are
+  // projected (see DoFLinearSystem::setNullSpace())
+  void setNullSpace(Int32, ConstArrayView<Real>) override {}
+  // The members are solved one after the other by DoFLinearSystem::solveEnsemble()
+  void solveEnsemble(Int32, ConstArrayView<Real>, ArrayView<Real>) override
+  {
+    ARCANE_THROW(NotImplementedException, "");
+  }
+  bool hasSolveEnsemble() const override { return false; }
+
  private:
 
   AlephParams* _createAlephParam()
@@ -410,10 +479,25 @@ class AlephDoFLinearSystemImpl
 
   Runner* m_runner = nullptr;
 
+  //! Entries of the eliminated columns, computed during _fillMatrix()
+  UniqueArray<EliminatedColumnEntry> m_eliminated_column_entries;
+  //! True if the matrix has to be kept after the next solve()
+  bool m_is_matrix_frozen = false;
+  //! True if the matrix has been kept by a previous solve()
+  bool m_has_frozen_matrix = false;
+  //! True if the solver starts from the values of 'm_dof_variable'
+  bool m_use_solution_as_initial_guess = false;
+
  private:
 
   void _fillMatrix();
   void _fillRHSVector();
+  void _applyEliminationToRHSVector();
+  void _checkFrozenElimination(DoFLocalId row, Byte elimination_info)
+  {
+    if (m_has_frozen_matrix && m_dof_elimination_info[row] != elimination_info)
+      ARCANE_FATAL("Can not change the elimination of row '{0}' when the matrix is frozen", row.localId());
+  }
   void _setMatrixValue(DoF row, DoF column, Real value)
   {
     if (m_do_print_filling)
@@ -508,35 +592,65 @@ _fillMatrix()
   }
 
   // Apply Row+Column elimination
-  // Phase 1:
-  // - substract values of the RHS vector if Row+Column elimination
+  // Phase 1: keep the entries of the eliminated columns. They are needed to
+  // substract values of the RHS vector and are reused as is if the matrix
+  // is frozen.
+  m_eliminated_column_entries.clear();
   for (const auto& rc_value : row_column_elimination_map) {
     RowColumn rc = rc_value.first;
-    Real matrix_value = rc_value.second;
     DoF dof_row = item_list_view[rc.row_id];
     DoF dof_column = item_list_view[rc.column_id];
     if (dof_row == dof_column)
       continue;
     if (!dof_column.isOwn())
       continue;
-    Byte row_elimination_info = m_dof_elimination_info[dof_row];
-    Real elimination_value = m_dof_elimination_value[dof_row];
-    // Substract the value of RHS vector for current column.
-    if (row_elimination_info == ELIMINATE_ROW_COLUMN) {
-      Real v = m_rhs_variable[dof_column];
-      m_rhs_variable[dof_column] = v - matrix_value * elimination_value;
-      if (m_do_print_filling)
-        info() << "EliminateRowColumn (" << std::setw(4) << rc.row_id
-               << "," << std::setw(4) << rc.column_id << ")"
-               << " elimination_value=" << std::setw(25) << elimination_value
-               << "  old_rhs=" << std::setw(25) << v
-               << "  new_rhs=" << std::setw(25) << m_rhs_variable[dof_column];
-    }
+    if (m_dof_elimination_info[dof_row] == ELIMINATE_ROW_COLUMN)
+      m_eliminated_column_entries.add(EliminatedColumnEntry{ rc.row_id, rc.column_id, rc_value.second });
   }
 
+  _applyEliminationToRHSVector();
+
   // Apply Row or Row+Column elimination
-  // Phase 2: set the value of the RHS if Row elimination
   // Phase 2: fill the diagonal with 1.0
+  ENUMERATE_ (DoF, idof, m_dof_family->allItems()) {
+    DoF dof = *idof;
+    if (!dof.isOwn())
+      continue;
+    Byte elimination_info = m_dof_elimination_info[dof];
+    if (elimination_info == ELIMINATE_ROW || elimination_info == ELIMINATE_ROW_COLUMN)
+      _setMatrixValue(dof, dof, 1.0);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Apply the values of the eliminated DoFs to the RHS vector.
+ *
+ * - substract A[rc,i] * value from RHS[i] for each Row+Column elimination
+ * - set RHS[rc] = value for each Row or Row+Column elimination
+ *
+ * Only the entries saved in m_eliminated_column_entries are used so this
+ * does not need the values of the matrix.
+ */
+void AlephDoFLinearSystemImpl::
+_applyEliminationToRHSVector()
+{
+  DoFInfoListView item_list_view(m_dof_family);
+  for (const EliminatedColumnEntry& entry : m_eliminated_column_entries) {
+    DoF dof_row = item_list_view[entry.row_id];
+    DoF dof_column = item_list_view[entry.column_id];
+    Real elimination_value = m_dof_elimination_value[dof_row];
+    Real v = m_rhs_variable[dof_column];
+    m_rhs_variable[dof_column] = v - entry.value * elimination_value;
+    if (m_do_print_filling)
+      info() << "EliminateRowColumn (" << std::setw(4) << entry.row_id
+             << "," << std::setw(4) << entry.column_id << ")"
+             << " elimination_value=" << std::setw(25) << elimination_value
+             << "  old_rhs=" << std::setw(25) << v
+             << "  new_rhs=" << std::setw(25) << m_rhs_variable[dof_column];
+  }
+
   ENUMERATE_ (DoF, idof, m_dof_family->allItems()) {
     DoF dof = *idof;
     if (!dof.isOwn())
@@ -547,7 +661,6 @@ _fillMatrix()
       m_rhs_variable[dof] = elimination_value;
       info() << "Eliminate info=" << (int)elimination_info << " row="
              << std::setw(4) << dof.localId() << " value=" << elimination_value;
-      _setMatrixValue(dof, dof, 1.0);
     }
   }
 }
@@ -0,0 +1,292 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* CompressedCsrFormatMatrix.cc                                (C) 2022-2024 */
+/*                                                                           */
+/* CSR matrix with column indexes compressed as 8 or 16 bits deltas.         */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "CompressedCsrFormatMatrix.h"
+
+#include <arcane/utils/FatalErrorException.h>
+#include <arcane/utils/ITraceMng.h>
+
+#include "CsrFormatMatrix.h"
+
+#include <chrono>
+#include <cstdint>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+namespace
+{
+  constexpr Int32 B = CompressedCsrFormat::BlockSize;
+
+  void _multiplyCsr(Int32 nb_row, const Int32* rows_index, const Int32* columns, const Real* values,
+                    const Real* x, Real* y)
+  {
+    for (Int32 i = 0; i < nb_row; ++i) {
+      Real s = 0.0;
+      for (Int32 k = rows_index[i]; k < rows_index[i + 1]; ++k)
+        s += values[k] * x[columns[k]];
+      y[i] = s;
+    }
+  }
+} // namespace
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+CompressedCsrFormat::
+CompressedCsrFormat(ITraceMng* tm)
+: TraceAccessor(tm)
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void CompressedCsrFormat::
+initialize(Int32 nb_row, ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+           ConstArrayView<Real> values)
+{
+  m_nb_row = nb_row;
+  m_nb_block = (nb_row + B - 1) / B;
+  m_rows_index.resize(nb_row + 1);
+  for (Int32 i = 0; i <= nb_row; ++i)
+    m_rows_index[i] = rows_index[i] - rows_index[0];
+  Int32 nnz = m_rows_index[nb_row];
+  m_values.resize(nnz);
+  for (Int32 k = 0; k < nnz; ++k)
+    m_values[k] = values[rows_index[0] + k];
+
+  // Base of each row and width of each block
+  m_row_base.resize(nb_row);
+  m_block_width.resize(m_nb_block);
+  m_block_offset.resize(m_nb_block + 1);
+  m_block_offset[0] = 0;
+  Int32 nb_block_by_width[3] = { 0, 0, 0 };
+  for (Int32 b = 0; b < m_nb_block; ++b) {
+    Int32 max_delta = 0;
+    for (Int32 i = b * B, end = math::min(i + B, nb_row); i < end; ++i) {
+      Int32 base = 0;
+      if (rows_index[i] < rows_index[i + 1]) {
+        base = columns[rows_index[i]];
+        for (Int32 k = rows_index[i]; k < rows_index[i + 1]; ++k)
+          base = math::min(base, columns[k]);
+        for (Int32 k = rows_index[i]; k < rows_index[i + 1]; ++k)
+          max_delta = math::max(max_delta, columns[k] - base);
+      }
+      m_row_base[i] = base;
+    }
+    Int32 width = 4;
+    if (max_delta <= UINT8_MAX)
+      width = 1;
+    else if (max_delta <= UINT16_MAX)
+      width = 2;
+    ++nb_block_by_width[width / 2];
+    m_block_width[b] = width;
+    // The deltas of a block are aligned on 4 bytes
+    Int32 block_nnz = m_rows_index[math::min((b + 1) * B, nb_row)] - m_rows_index[b * B];
+    m_block_offset[b + 1] = m_block_offset[b] + ((Int64(block_nnz) * width + 3) / 4) * 4;
+  }
+
+  // Deltas of the columns
+  m_indexes.resize(m_block_offset[m_nb_block]);
+  for (Int32 b = 0; b < m_nb_block; ++b) {
+    Byte* block_indexes = m_indexes.data() + m_block_offset[b];
+    Int32 first = m_rows_index[b * B];
+    for (Int32 i = b * B, end = math::min(i + B, nb_row); i < end; ++i) {
+      for (Int32 k = m_rows_index[i]; k < m_rows_index[i + 1]; ++k) {
+        Int32 delta = columns[rows_index[0] + k] - m_row_base[i];
+        switch (m_block_width[b]) {
+        case 1:
+          reinterpret_cast<std::uint8_t*>(block_indexes)[k - first] = static_cast<std::uint8_t>(delta);
+          break;
+        case 2:
+          reinterpret_cast<std::uint16_t*>(block_indexes)[k - first] = static_cast<std::uint16_t>(delta);
+          break;
+        default:
+          reinterpret_cast<Int32*>(block_indexes)[k - first] = delta;
+        }
+      }
+    }
+  }
+
+  info(4) << "CompressedCsrFormat nb_row=" << nb_row << " nnz=" << nnz
+          << " nb_block(8/16/32 bits)=" << nb_block_by_width[0] << "/" << nb_block_by_width[1]
+          << "/" << nb_block_by_width[2] << " index_bytes=" << nbIndexByte()
+          << " (CSR=" << Int64(nnz) * sizeof(Int32) << ")";
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void CompressedCsrFormat::
+initialize(const CsrFormat& csr)
+{
+  Int32 nb_row = csr.m_matrix_row.extent0();
+  Int32 csr_size = csr.m_matrix_column.extent0();
+  UniqueArray<Int32> rows_index(nb_row + 1);
+  UniqueArray<Int32> columns;
+  UniqueArray<Real> values;
+  columns.reserve(csr_size);
+  values.reserve(csr_size);
+  // Skip the unused slots (-1 column) of the rows of the csr matrix
+  for (Int32 i = 0; i < nb_row; ++i) {
+    rows_index[i] = columns.size();
+    Int32 end = (i + 1 < nb_row) ? csr.m_matrix_row(i + 1) : csr_size;
+    for (Int32 k = csr.m_matrix_row(i); k < end; ++k) {
+      if (csr.m_matrix_column(k) < 0)
+        continue;
+      columns.add(csr.m_matrix_column(k));
+      values.add(csr.m_matrix_value(k));
+    }
+  }
+  rows_index[nb_row] = columns.size();
+  initialize(nb_row, rows_index, columns, values);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+template <typename DeltaType> void CompressedCsrFormat::
+_multiplyBlock(Int32 block, const Real* x, Real* y) const
+{
+  const Int32* rows_index = m_rows_index.data();
+  const Int32* row_base = m_row_base.data();
+  const Real* values = m_values.data();
+  Int32 first_row = block * B;
+  Int32 end_row = math::min(first_row + B, m_nb_row);
+  Int32 first = rows_index[first_row];
+  const DeltaType* deltas = reinterpret_cast<const DeltaType*>(m_indexes.data() + m_block_offset[block]);
+  for (Int32 i = first_row; i < end_row; ++i) {
+    // x is shifted by the base so that the delta is directly the index
+    const Real* xb = x + row_base[i];
+    Real s = 0.0;
+    for (Int32 k = rows_index[i]; k < rows_index[i + 1]; ++k)
+      s += values[k] * xb[deltas[k - first]];
+    y[i] = s;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void CompressedCsrFormat::
+multiply(ConstArrayView<Real> x, ArrayView<Real> y) const
+{
+  for (Int32 b = 0; b < m_nb_block; ++b) {
+    switch (m_block_width[b]) {
+    case 1:
+      _multiplyBlock<std::uint8_t>(b, x.data(), y.data());
+      break;
+    case 2:
+      _multiplyBlock<std::uint16_t>(b, x.data(), y.data());
+      break;
+    default:
+      _multiplyBlock<Int32>(b, x.data(), y.data());
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Column of the entry \a index of the row \a row.
+ */
+Int32 CompressedCsrFormat::
+_column(Int32 row, Int32 index) const
+{
+  Int32 b = row / B;
+  const Byte* block_indexes = m_indexes.data() + m_block_offset[b];
+  Int32 k = index - m_rows_index[b * B];
+  switch (m_block_width[b]) {
+  case 1:
+    return m_row_base[row] + reinterpret_cast<const std::uint8_t*>(block_indexes)[k];
+  case 2:
+    return m_row_base[row] + reinterpret_cast<const std::uint16_t*>(block_indexes)[k];
+  default:
+    return m_row_base[row] + reinterpret_cast<const Int32*>(block_indexes)[k];
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Int32 CompressedCsrFormat::
+indexValue(Int32 row, Int32 column) const
+{
+  for (Int32 k = m_rows_index[row]; k < m_rows_index[row + 1]; ++k)
+    if (_column(row, k) == column)
+      return k;
+  return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void CompressedCsrFormat::
+fillInverseDiagonal(ArrayView<Real> inv_diagonal) const
+{
+  inv_diagonal.fill(1.0);
+  for (Int32 i = 0; i < m_nb_row; ++i) {
+    Int32 index = indexValue(i, i);
+    if (index >= 0 && m_values[index] != 0.0)
+      inv_diagonal[i] = 1.0 / m_values[index];
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void CompressedCsrFormat::
+benchmark(ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+          ConstArrayView<Real> values, Int32 nb_iteration) const
+{
+  using Clock = std::chrono::high_resolution_clock;
+  UniqueArray<Real> x(m_nb_row, 1.0);
+  UniqueArray<Real> y(m_nb_row, 0.0);
+  nb_iteration = math::max(nb_iteration, 1);
+
+  // Bytes read or written by one product: matrix + x + y
+  Int64 nnz = m_values.size();
+  Real vector_bytes = 2.0 * sizeof(Real) * m_nb_row;
+  Real row_bytes = Real(sizeof(Int32)) * (m_nb_row + 1);
+  Real csr_bytes = Real(nnz) * (sizeof(Real) + sizeof(Int32)) + row_bytes + vector_bytes;
+  Real compressed_bytes = Real(nnz) * sizeof(Real) + Real(nbIndexByte()) + row_bytes +
+  (sizeof(Int64) + sizeof(Int32)) * m_nb_block + vector_bytes;
+
+  auto t0 = Clock::now();
+  for (Int32 i = 0; i < nb_iteration; ++i)
+    _multiplyCsr(m_nb_row, rows_index.data(), columns.data(), values.data(), x.data(), y.data());
+  auto t1 = Clock::now();
+  for (Int32 i = 0; i < nb_iteration; ++i)
+    multiply(x, y);
+  auto t2 = Clock::now();
+
+  Real csr_time = std::chrono::duration<Real>(t1 - t0).count() / nb_iteration;
+  Real compressed_time = std::chrono::duration<Real>(t2 - t1).count() / nb_iteration;
+  info() << "SpMV benchmark nb_row=" << m_nb_row << " nnz=" << nnz
+         << " index_bytes=" << nbIndexByte() << " (CSR=" << nnz * sizeof(Int32) << ")";
+  info() << "SpMV benchmark CSR time=" << csr_time << "s bandwidth=" << csr_bytes / csr_time * 1.0e-9 << "GB/s";
+  info() << "SpMV benchmark compressed CSR time=" << compressed_time << "s bandwidth="
+         << compressed_bytes / compressed_time * 1.0e-9 << "GB/s speedup=" << csr_time / compressed_time;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
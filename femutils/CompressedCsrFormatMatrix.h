@@ -0,0 +1,119 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* CompressedCsrFormatMatrix.h                                 (C) 2022-2024 */
+/*                                                                           */
+/* CSR matrix with column indexes compressed as 8 or 16 bits deltas.         */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_COMPRESSEDCSRFORMATMATRIX_H
+#define FEMTEST_COMPRESSEDCSRFORMATMATRIX_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/TraceAccessor.h>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+class CsrFormat;
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief CSR matrix whose column indexes are stored as deltas.
+ *
+ * With a good numbering of the DoFs, the columns of a row are close to each
+ * other and the 4 bytes of a column index are mostly useless. Here each row
+ * stores its smallest column (the base) and the columns are stored as the
+ * difference with this base, on 1, 2 or 4 bytes. The width is chosen for
+ * each block of BlockSize rows from the largest difference of the block.
+ *
+ * The values and the row offsets are the same as for a CSR matrix. The
+ * indexes are decoded on the fly in multiply() and in the search of an
+ * entry (indexValue()).
+ */
+class CompressedCsrFormat
+: public TraceAccessor
+{
+ public:
+
+  //! Number of rows sharing the same index width
+  static constexpr Int32 BlockSize = 64;
+
+ public:
+
+  explicit CompressedCsrFormat(ITraceMng* tm);
+
+ public:
+
+  /*!
+   * \brief Build the matrix from a CSR matrix.
+   *
+   * \a rows_index has \a nb_row + 1 values, the row \a i has the entries
+   * [rows_index[i], rows_index[i+1]) of \a columns and \a values.
+   */
+  void initialize(Int32 nb_row, ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+                  ConstArrayView<Real> values);
+  //! Build the matrix from the values of \a csr
+  void initialize(const CsrFormat& csr);
+
+  //! y = A x
+  void multiply(ConstArrayView<Real> x, ArrayView<Real> y) const;
+
+  //! Index in values() of the entry (\a row, \a column), -1 if not in the pattern
+  Int32 indexValue(Int32 row, Int32 column) const;
+
+  ConstArrayView<Real> values() const { return m_values; }
+  ArrayView<Real> values() { return m_values; }
+  Int32 nbRow() const { return m_nb_row; }
+  //! Number of bytes of the column indexes (bases and deltas)
+  Int64 nbIndexByte() const { return m_indexes.size() + sizeof(Int32) * m_row_base.size(); }
+  //! Inverse of the diagonal (1 for a zero diagonal)
+  void fillInverseDiagonal(ArrayView<Real> inv_diagonal) const;
+
+  /*!
+   * \brief Measure the bandwidth of the CSR and compressed CSR products.
+   *
+   * Each product is done \a nb_iteration times and the rate is computed from
+   * the bytes of the matrix and of the vectors (GB/s).
+   */
+  void benchmark(ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+                 ConstArrayView<Real> values, Int32 nb_iteration) const;
+
+ private:
+
+  Int32 m_nb_row = 0;
+  Int32 m_nb_block = 0;
+  UniqueArray<Int32> m_rows_index;
+  //! Smallest column of each row
+  UniqueArray<Int32> m_row_base;
+  //! Number of bytes (1, 2 or 4) of the deltas of each block
+  UniqueArray<Int32> m_block_width;
+  //! Offset in m_indexes of the deltas of each block
+  UniqueArray<Int64> m_block_offset;
+  UniqueArray<Byte> m_indexes;
+  UniqueArray<Real> m_values;
+
+ private:
+
+  template <typename DeltaType> void
+  _multiplyBlock(Int32 block, const Real* x, Real* y) const;
+  Int32 _column(Int32 row, Int32 index) const;
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
@@ -15,9 +15,13 @@
 
 #include <arcane/VariableTypes.h>
 #include <arcane/IItemFamily.h>
+#include <arcane/IMesh.h>
+#include <arcane/ItemGroup.h>
 
 #include "CsrFormatMatrix.h"
 
+#include <algorithm>
+
 namespace Arcane::FemUtils
 {
 
@@ -46,6 +50,66 @@ initialize(IItemFamily* dof_family, Int32 nnz, Int32 nbRow)
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+namespace
+{
+  //! Fill \a columns with the sorted DoFs of the nodes sharing a cell with \a node
+  void _fillNodeNeighbours(Node node, IndexedNodeDoFConnectivityView node_dof, Int32 nb_dof_per_node,
+                           UniqueArray<Int32>& columns)
+  {
+    columns.clear();
+    for (Cell cell : node.cells())
+      for (Node node2 : cell.nodes())
+        for (Int32 i = 0; i < nb_dof_per_node; ++i)
+          columns.add(node_dof.dofId(node2, i).localId());
+    std::sort(columns.begin(), columns.end());
+    auto last = std::unique(columns.begin(), columns.end());
+    columns.resize(static_cast<Int32>(last - columns.begin()));
+  }
+} // namespace
+
+void CsrFormat::
+initializeFromNodeCellPattern(IMesh* mesh, IItemFamily* dof_family, IndexedNodeDoFConnectivityView node_dof,
+                              Int32 nb_dof_per_node)
+{
+  Int32 nb_row = dof_family->maxLocalId();
+  UniqueArray<Int32> columns;
+
+  // First pass: number of columns of each row
+  UniqueArray<Int32> rows_nb_column(nb_row, 0);
+  ENUMERATE_ (Node, inode, mesh->allNodes()) {
+    Node node = *inode;
+    _fillNodeNeighbours(node, node_dof, nb_dof_per_node, columns);
+    for (Int32 i = 0; i < nb_dof_per_node; ++i)
+      rows_nb_column[node_dof.dofId(node, i).localId()] = columns.size();
+  }
+  Int32 nnz = 0;
+  for (Int32 i = 0; i < nb_row; ++i)
+    nnz += rows_nb_column[i];
+
+  initialize(dof_family, nnz, nb_row);
+  Int32 index = 0;
+  for (Int32 i = 0; i < nb_row; ++i) {
+    m_matrix_row(i) = index;
+    m_matrix_rows_nb_column(i) = rows_nb_column[i];
+    index += rows_nb_column[i];
+  }
+
+  // Second pass: columns of each row
+  ENUMERATE_ (Node, inode, mesh->allNodes()) {
+    Node node = *inode;
+    _fillNodeNeighbours(node, node_dof, nb_dof_per_node, columns);
+    for (Int32 i = 0; i < nb_dof_per_node; ++i) {
+      Int32 begin = m_matrix_row(node_dof.dofId(node, i).localId());
+      for (Int32 j = 0, n = columns.size(); j < n; ++j)
+        m_matrix_column(begin + j) = columns[j];
+    }
+  }
+  m_last_value = nnz;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 void CsrFormat::
 translateToLinearSystem(DoFLinearSystem& linear_system)
 {
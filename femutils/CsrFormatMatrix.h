@@ -15,6 +15,7 @@
 
 #include <arcane/VariableTypes.h>
 #include <arcane/IItemFamily.h>
+#include <arcane/IndexedItemConnectivityView.h>
 
 #include <arcane/aleph/AlephTypesSolver.h>
 #include <arcane/aleph/Aleph.h>
@@ -42,6 +43,23 @@ class CsrFormat
 
   void initialize(IItemFamily* dof_family, Int32 nnz, Int32 nbRow);
 
+  /**
+   * @brief Initialize the matrix with the pattern coupling the nodes which
+   * share a cell.
+   *
+   * Unlike the nbFace() * 2 + nbNode() formula used for triangles, this
+   * pattern is valid for any kind of cell (quadrangles, 3D cells, ...).
+   * Each DoF of a node is coupled to the \a nb_dof_per_node DoFs of the
+   * neighbour nodes. The columns of each row are sorted.
+   *
+   * @param mesh
+   * @param dof_family
+   * @param node_dof
+   * @param nb_dof_per_node
+   */
+  void initializeFromNodeCellPattern(IMesh* mesh, IItemFamily* dof_family, IndexedNodeDoFConnectivityView node_dof,
+                                     Int32 nb_dof_per_node = 1);
+
   /**
    * @brief
    *
@@ -25,6 +25,11 @@
 
 #include "FemUtils.h"
 #include "IDoFLinearSystemFactory.h"
+#include "PMultigridPreconditioner.h"
+#include "MixedPrecisionSolver.h"
+#include "SellFormatMatrix.h"
+#include "CompressedCsrFormatMatrix.h"
+#include "EnsembleConjugateGradient.h"
 
 namespace Arcane::FemUtils
 {
@@ -50,6 +55,59 @@ namespace Arcane::FemUtils
 extern "C++" DoFLinearSystemImpl*
 createAlephDoFLinearSystemImpl(ISubDomain* sd, IItemFamily* dof_family, const String& solver_name);
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Preconditioner P M^-1 P, P being the orthogonal projection on the
+ * complement of a null space.
+ *
+ * With a singular matrix and a compatible RHS, the conjugate gradient then
+ * stays in the range of the matrix and converges as for a regular matrix.
+ * The vectors of the null space must be orthonormal.
+ */
+class NullSpaceProjectionPreconditioner
+: public MatVec::IPreconditioner
+{
+ public:
+
+  NullSpaceProjectionPreconditioner(MatVec::IPreconditioner* p, Int32 nb_vector, ConstArrayView<Real> null_space)
+  : m_preconditioner(p)
+  , m_nb_vector(nb_vector)
+  , m_null_space(null_space)
+  , m_work(nb_vector > 0 ? null_space.size() / nb_vector : 0)
+  {}
+
+ public:
+
+  void apply(MatVec::Vector& out, const MatVec::Vector& in) override
+  {
+    m_work.values().copy(in.values());
+    project(m_work.values());
+    m_preconditioner->apply(out, m_work);
+    project(out.values());
+  }
+
+  void project(ArrayView<Real> x) const
+  {
+    Int32 n = x.size();
+    for (Int32 k = 0; k < m_nb_vector; ++k) {
+      ConstArrayView<Real> z = m_null_space.subView(k * n, n);
+      Real c = 0.0;
+      for (Int32 i = 0; i < n; ++i)
+        c += x[i] * z[i];
+      for (Int32 i = 0; i < n; ++i)
+        x[i] -= c * z[i];
+    }
+  }
+
+ private:
+
+  MatVec::IPreconditioner* m_preconditioner = nullptr;
+  Int32 m_nb_vector = 0;
+  ConstArrayView<Real> m_null_space;
+  MatVec::Vector m_work;
+};
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -65,6 +123,11 @@ class SequentialDoFLinearSystemImpl
   , m_dof_family(dof_family)
   , m_rhs_variable(VariableBuildInfo(dof_family, solver_name + "RHSVariable"))
   , m_dof_variable(VariableBuildInfo(dof_family, solver_name + "SolutionVariable"))
+  , m_p_multigrid(sd->traceMng())
+  , m_mixed_precision(sd->traceMng())
+  , m_sell_matrix(sd->traceMng())
+  , m_compressed_matrix(sd->traceMng())
+  , m_ensemble_solver(sd->traceMng())
   {}
 
  public:
@@ -82,11 +145,15 @@ class SequentialDoFLinearSystemImpl
 
   void matrixAddValue(DoFLocalId row, DoFLocalId column, Real value) override
   {
+    if (m_has_frozen_matrix)
+      return;
     m_k_matrix(row, column) += value;
   }
 
   void matrixSetValue(DoFLocalId row, DoFLocalId column, Real value) override
   {
+    if (m_has_frozen_matrix)
+      return;
     // TODO: We should do the set() at the solving time because a following
     // call to matrixAddValue() will override this value and this is not the
     // wanted bahavior.
@@ -110,6 +177,8 @@ class SequentialDoFLinearSystemImpl
     Int32 matrix_size = m_k_matrix.extent0();
     Arcane::MatVec::Matrix matrix(matrix_size, matrix_size);
     _convertNumArrayToCSRMatrix(matrix, m_k_matrix.span());
+    if (m_is_matrix_frozen)
+      m_has_frozen_matrix = true;
     bool is_verbose = true;
     Arcane::MatVec::Vector vector_b(matrix_size);
     Arcane::MatVec::Vector vector_x(matrix_size);
@@ -122,6 +191,19 @@ class SequentialDoFLinearSystemImpl
           info() << "VectorB[" << i << "] = " << m_rhs_vector[i];
         vector_x_view(i) = 0.0;
       }
+      // The iterative solver starts from the current solution if asked
+      if (m_use_solution_as_initial_guess) {
+        ENUMERATE_ (DoF, idof, m_dof_family->allItems()) {
+          vector_x_view(idof.itemLocalId()) = m_dof_variable[idof];
+        }
+      }
+    }
+
+    if (m_use_spmv_benchmark) {
+      m_sell_matrix.initialize(matrix_size, matrix.rowsIndex(), matrix.columns(), matrix.values(), m_sell_sigma);
+      m_sell_matrix.benchmark(matrix.rowsIndex(), matrix.columns(), matrix.values(), 100);
+      m_compressed_matrix.initialize(matrix_size, matrix.rowsIndex(), matrix.columns(), matrix.values());
+      m_compressed_matrix.benchmark(matrix.rowsIndex(), matrix.columns(), matrix.values(), 100);
     }
 
     bool use_direct_solver = false;
@@ -136,6 +218,10 @@ class SequentialDoFLinearSystemImpl
       use_direct_solver = false;
       break;
     }
+    if (use_direct_solver && m_nb_null_space_vector > 0) {
+      info() << "The matrix has a null space: using the iterative solver";
+      use_direct_solver = false;
+    }
     if (use_direct_solver) {
       info() << "Using direct solver";
       Arcane::MatVec::DirectSolver solver;
@@ -143,12 +229,54 @@ class SequentialDoFLinearSystemImpl
     }
     else {
       Real epsilon = m_epsilon;
-      info() << "Using internal solver with diagonal preconditioner epsilon=" << epsilon;
-      Arcane::MatVec::DiagonalPreconditioner p(matrix);
       Arcane::MatVec::ConjugateGradientSolver solver;
-      solver.solve(matrix, vector_b, vector_x, epsilon, &p);
-      info() << "End solver nb_iteration=" << solver.nbIteration()
-             << " residual_norm=" << solver.residualNorm();
+      auto solve_with_preconditioner = [&](MatVec::IPreconditioner* p) {
+        if (m_nb_null_space_vector > 0) {
+          NullSpaceProjectionPreconditioner np(p, m_nb_null_space_vector, m_null_space);
+          solver.solve(matrix, vector_b, vector_x, epsilon, &np);
+        }
+        else
+          solver.solve(matrix, vector_b, vector_x, epsilon, p);
+        info() << "End solver nb_iteration=" << solver.nbIteration()
+               << " residual_norm=" << solver.residualNorm();
+      };
+      if (m_use_mixed_precision) {
+        info() << "Using internal mixed precision solver (float matrix) with diagonal preconditioner epsilon=" << epsilon;
+        UniqueArray<Real> initial_guess;
+        if (m_check_mixed_precision)
+          initial_guess.copy(vector_x.values());
+        m_mixed_precision.setEpsilon(epsilon);
+        m_mixed_precision.solve(matrix, vector_b, vector_x);
+        info() << "End mixed precision solver nb_outer_iteration=" << m_mixed_precision.nbOuterIteration()
+               << " nb_iteration=" << m_mixed_precision.nbIteration()
+               << " relative_residual_norm=" << m_mixed_precision.residualNorm();
+        if (m_check_mixed_precision)
+          _checkMixedPrecision(matrix, vector_b, vector_x, initial_guess);
+      }
+      else if (m_use_sell_format) {
+        info() << "Using internal solver with SELL-C-sigma matrix and diagonal preconditioner epsilon=" << epsilon;
+        m_sell_matrix.initialize(matrix_size, matrix.rowsIndex(), matrix.columns(), matrix.values(), m_sell_sigma);
+        Int32 nb_iteration = _solveJacobiConjugateGradient(m_sell_matrix, vector_b.values(), vector_x.values(), epsilon);
+        info() << "End solver nb_iteration=" << nb_iteration
+               << " kernel=" << SellFormat::kernelName(m_sell_matrix.kernel());
+      }
+      else if (m_use_compressed_csr) {
+        info() << "Using internal solver with compressed CSR matrix and diagonal preconditioner epsilon=" << epsilon;
+        m_compressed_matrix.initialize(matrix_size, matrix.rowsIndex(), matrix.columns(), matrix.values());
+        Int32 nb_iteration = _solveJacobiConjugateGradient(m_compressed_matrix, vector_b.values(), vector_x.values(), epsilon);
+        info() << "End solver nb_iteration=" << nb_iteration
+               << " index_bytes=" << m_compressed_matrix.nbIndexByte();
+      }
+      else if (m_p_multigrid.hasProlongation()) {
+        info() << "Using internal solver with p-multigrid preconditioner epsilon=" << epsilon;
+        m_p_multigrid.build(matrix);
+        solve_with_preconditioner(&m_p_multigrid);
+      }
+      else {
+        info() << "Using internal solver with diagonal preconditioner epsilon=" << epsilon;
+        Arcane::MatVec::DiagonalPreconditioner p(matrix);
+        solve_with_preconditioner(&p);
+      }
     }
 
     {
@@ -178,6 +306,7 @@ class SequentialDoFLinearSystemImpl
   void clearValues() override
   {
     // TODO: not yet tested. We need to have test for this.
+    m_has_frozen_matrix = false;
     build();
   }
 
@@ -188,11 +317,53 @@ class SequentialDoFLinearSystemImpl
   bool hasSetCSRValues() const override { return false; }
   void setRunner(Runner* r) override { m_runner = r; }
   Runner* runner() const { return m_runner; }
+  void setMatrixFrozen(bool v) override
+  {
+    m_is_matrix_frozen = v;
+    if (!v)
+      m_has_frozen_matrix = false;
+  }
+  bool hasFrozenMatrix() const override { return m_has_frozen_matrix; }
+  void setSolutionAsInitialGuess(bool v) override { m_use_solution_as_initial_guess = v; }
+  void setPMultigridProlongation(const CSRFormatView& prolongation, Int32 nb_coarse_dof) override
+  {
+    m_p_multigrid.setProlongation(prolongation, nb_coarse_dof);
+  }
+  void setNullSpace(Int32 nb_vector, ConstArrayView<Real> values) override
+  {
+    m_nb_null_space_vector = nb_vector;
+    m_null_space.copy(values);
+  }
+  void solveEnsemble(Int32 nb_member, ConstArrayView<Real> rhs, ArrayView<Real> solutions) override
+  {
+    Int32 matrix_size = m_k_matrix.extent0();
+    Arcane::MatVec::Matrix matrix(matrix_size, matrix_size);
+    _convertNumArrayToCSRMatrix(matrix, m_k_matrix.span());
+    if (m_is_matrix_frozen)
+      m_has_frozen_matrix = true;
+
+    if (!m_use_solution_as_initial_guess)
+      solutions.fill(0.0);
+    info() << "Using internal ensemble solver with diagonal preconditioner nb_member=" << nb_member
+           << " epsilon=" << m_epsilon;
+    m_ensemble_solver.setEpsilon(m_epsilon);
+    m_ensemble_solver.solve(nb_member, matrix.rowsIndex(), matrix.columns(), matrix.values(), rhs, solutions);
+    info() << "End ensemble solver nb_iteration=" << m_ensemble_solver.nbIteration();
+  }
+  bool hasSolveEnsemble() const override { return true; }
 
  public:
 
-  void setEpsilon(Real v) { m_epsilon = v; }
+  void setEpsilon(Real v) override { m_epsilon = v; }
   void setSolverMethod(eInternalSolverMethod v) { m_solver_method = v; }
+  PMultigridPreconditioner& pMultigrid() { return m_p_multigrid; }
+  MixedPrecisionSolver& mixedPrecision() { return m_mixed_precision; }
+  void setUseMixedPrecision(bool v) { m_use_mixed_precision = v; }
+  void setCheckMixedPrecision(bool v) { m_check_mixed_precision = v; }
+  void setUseSellFormat(bool v) { m_use_sell_format = v; }
+  void setSellSigma(Int32 v) { m_sell_sigma = v; }
+  void setUseSpMVBenchmark(bool v) { m_use_spmv_benchmark = v; }
+  void setUseCompressedCsr(bool v) { m_use_compressed_csr = v; }
 
  private:
 
@@ -210,8 +381,132 @@ class SequentialDoFLinearSystemImpl
 
   Runner* m_runner = nullptr;
 
+  //! Used by the iterative solver if a prolongation has been given
+  PMultigridPreconditioner m_p_multigrid;
+  //! Used by the iterative solver if 'mixed-precision' is true
+  MixedPrecisionSolver m_mixed_precision;
+  bool m_use_mixed_precision = false;
+  //! If true, the mixed precision solution is compared to the double precision one
+  bool m_check_mixed_precision = false;
+  //! Matrix used by the iterative solver if 'sell-format' is true
+  SellFormat m_sell_matrix;
+  bool m_use_sell_format = false;
+  Int32 m_sell_sigma = 64;
+  //! Matrix used by the iterative solver if 'compressed-csr' is true
+  CompressedCsrFormat m_compressed_matrix;
+  bool m_use_compressed_csr = false;
+  //! Used by solveEnsemble()
+  EnsembleConjugateGradient m_ensemble_solver;
+  //! If true, the CSR, SELL and compressed CSR products are timed before each solve
+  bool m_use_spmv_benchmark = false;
+
+  //! True if the matrix has to be kept after the next solve()
+  bool m_is_matrix_frozen = false;
+  //! True if the matrix has been kept by a previous solve()
+  bool m_has_frozen_matrix = false;
+  //! True if the iterative solver starts from the values of the solution variable
+  bool m_use_solution_as_initial_guess = false;
+
+  //! Orthonormal basis of the null space of the matrix
+  UniqueArray<Real> m_null_space;
+  Int32 m_nb_null_space_vector = 0;
+
  private:
 
+  /*!
+   * \brief Compare the mixed precision solution \a x to the solution of the
+   * double precision solver started from \a initial_guess.
+   */
+  void _checkMixedPrecision(const Arcane::MatVec::Matrix& matrix, const Arcane::MatVec::Vector& vector_b,
+                            const Arcane::MatVec::Vector& vector_x, ConstArrayView<Real> initial_guess)
+  {
+    Int32 matrix_size = initial_guess.size();
+    Arcane::MatVec::Vector vector_x_double(matrix_size);
+    vector_x_double.values().copy(initial_guess);
+    Arcane::MatVec::ConjugateGradientSolver solver;
+    Arcane::MatVec::DiagonalPreconditioner p(matrix);
+    solver.solve(matrix, vector_b, vector_x_double, m_epsilon, &p);
+
+    ConstArrayView<Real> x = vector_x.values();
+    ConstArrayView<Real> x_double = vector_x_double.values();
+    Real norm_diff = 0.0;
+    Real norm_double = 0.0;
+    for (Int32 i = 0; i < matrix_size; ++i) {
+      norm_diff += (x[i] - x_double[i]) * (x[i] - x_double[i]);
+      norm_double += x_double[i] * x_double[i];
+    }
+    Real relative_diff = (norm_double > 0.0) ? math::sqrt(norm_diff / norm_double) : math::sqrt(norm_diff);
+    info() << "Mixed precision check: double precision nb_iteration=" << solver.nbIteration()
+           << " mixed precision nb_iteration=" << m_mixed_precision.nbIteration()
+           << " relative difference |x_mixed - x_double| / |x_double|=" << relative_diff;
+  }
+
+  /*!
+   * \brief Diagonal preconditioned conjugate gradient with the products of \a a.
+   *
+   * \a a is a SellFormat or a CompressedCsrFormat (multiply() and
+   * fillInverseDiagonal() methods). It stops when |D^-1 r| <= epsilon |D^-1 b|,
+   * \a epsilon being bounded by the accuracy of the double precision. The
+   * preconditioned residuals are projected on the complement of the null
+   * space, if any. Returns the number of iterations.
+   */
+  template <typename MatrixType>
+  Int32 _solveJacobiConjugateGradient(const MatrixType& a, ConstArrayView<Real> b, ArrayView<Real> x, Real epsilon)
+  {
+    Int32 n = b.size();
+    UniqueArray<Real> inv_diagonal(n);
+    UniqueArray<Real> r(n);
+    UniqueArray<Real> z(n);
+    UniqueArray<Real> p(n);
+    UniqueArray<Real> q(n);
+    a.fillInverseDiagonal(inv_diagonal);
+    NullSpaceProjectionPreconditioner null_space(nullptr, m_nb_null_space_vector, m_null_space);
+
+    auto dot = [n](ConstArrayView<Real> u, ConstArrayView<Real> v) {
+      Real s = 0.0;
+      for (Int32 i = 0; i < n; ++i)
+        s += u[i] * v[i];
+      return s;
+    };
+    auto scaled_norm2 = [&](ConstArrayView<Real> v) {
+      Real s = 0.0;
+      for (Int32 i = 0; i < n; ++i)
+        s += (inv_diagonal[i] * v[i]) * (inv_diagonal[i] * v[i]);
+      return s;
+    };
+
+    Real tolerance = math::max(epsilon, 1.0e-14);
+    Real tolerance2 = tolerance * tolerance * scaled_norm2(b);
+    a.multiply(x, q);
+    for (Int32 i = 0; i < n; ++i) {
+      r[i] = b[i] - q[i];
+      z[i] = inv_diagonal[i] * r[i];
+    }
+    null_space.project(z);
+    for (Int32 i = 0; i < n; ++i)
+      p[i] = z[i];
+    Real rz = dot(r, z);
+    Int32 nb_iteration = 0;
+    const Int32 max_iteration = 10 * n + 100;
+    while (scaled_norm2(r) > tolerance2 && nb_iteration < max_iteration) {
+      ++nb_iteration;
+      a.multiply(p, q);
+      Real alpha = rz / dot(p, q);
+      for (Int32 i = 0; i < n; ++i) {
+        x[i] += alpha * p[i];
+        r[i] -= alpha * q[i];
+        z[i] = inv_diagonal[i] * r[i];
+      }
+      null_space.project(z);
+      Real rz_new = dot(r, z);
+      Real beta = rz_new / rz;
+      rz = rz_new;
+      for (Int32 i = 0; i < n; ++i)
+        p[i] = z[i] + beta * p[i];
+    }
+    return nb_iteration;
+  }
+
   void _fillRHSVector()
   {
     // For the LinearSystem class we need an array
@@ -386,7 +681,13 @@ void DoFLinearSystem::
 solve()
 {
   _checkInit();
+  if (m_nb_null_space_vector > 0) {
+    Real norm = _removeNullSpaceComponents(m_p->rhsVariable());
+    m_item_family->traceMng()->info() << "Null space: norm of the incompatible part of the RHS=" << norm;
+  }
   m_p->solve();
+  if (m_nb_null_space_vector > 0)
+    _removeNullSpaceComponents(m_p->solutionVariable());
 }
 
 /*---------------------------------------------------------------------------*/
@@ -442,12 +743,181 @@ hasSetCSRValues() const
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+void DoFLinearSystem::
+setMatrixFrozen(bool v)
+{
+  _checkInit();
+  m_p->setMatrixFrozen(v);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+bool DoFLinearSystem::
+hasFrozenMatrix() const
+{
+  _checkInit();
+  return m_p->hasFrozenMatrix();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void DoFLinearSystem::
+setSolutionAsInitialGuess(bool v)
+{
+  _checkInit();
+  m_p->setSolutionAsInitialGuess(v);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void DoFLinearSystem::
+setEpsilon(Real v)
+{
+  _checkInit();
+  m_p->setEpsilon(v);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void DoFLinearSystem::
+setPMultigridProlongation(const CSRFormatView& prolongation, Int32 nb_coarse_dof)
+{
+  _checkInit();
+  m_p->setPMultigridProlongation(prolongation, nb_coarse_dof);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void DoFLinearSystem::
+setNullSpace(Int32 nb_vector, ConstArrayView<Real> values)
+{
+  _checkInit();
+  IParallelMng* pm = m_item_family->parallelMng();
+  Int32 nb_dof = m_item_family->maxLocalId();
+  if (values.size() != nb_vector * nb_dof)
+    ARCANE_FATAL("Bad size for the null space values v={0} expected={1}", values.size(), nb_vector * nb_dof);
+  m_null_space.copy(values);
+  m_nb_null_space_vector = nb_vector;
+
+  // Modified Gram-Schmidt. The dot products are done on the own DoFs and the
+  // ghost DoFs are updated with the same coefficients.
+  DoFGroup own_dofs = m_item_family->allItems().own();
+  auto dot = [&](Int32 k1, Int32 k2) {
+    ConstArrayView<Real> z1 = m_null_space.subConstView(k1 * nb_dof, nb_dof);
+    ConstArrayView<Real> z2 = m_null_space.subConstView(k2 * nb_dof, nb_dof);
+    Real v = 0.0;
+    ENUMERATE_ (DoF, idof, own_dofs) {
+      v += z1[idof.itemLocalId()] * z2[idof.itemLocalId()];
+    }
+    return pm->reduce(Parallel::ReduceSum, v);
+  };
+  for (Int32 k = 0; k < nb_vector; ++k) {
+    ArrayView<Real> z = m_null_space.subView(k * nb_dof, nb_dof);
+    Real initial_norm = math::sqrt(dot(k, k));
+    for (Int32 j = 0; j < k; ++j) {
+      Real c = dot(k, j);
+      ConstArrayView<Real> zj = m_null_space.subConstView(j * nb_dof, nb_dof);
+      for (Int32 i = 0; i < nb_dof; ++i)
+        z[i] -= c * zj[i];
+    }
+    Real norm = math::sqrt(dot(k, k));
+    if (norm <= 1.0e-12 * initial_norm || norm == 0.0)
+      ARCANE_FATAL("The null space vector '{0}' is not independent of the previous ones", k);
+    for (Int32 i = 0; i < nb_dof; ++i)
+      z[i] /= norm;
+  }
+  m_p->setNullSpace(m_nb_null_space_vector, m_null_space);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void DoFLinearSystem::
+solveEnsemble(Int32 nb_member, ConstArrayView<Real> rhs, ArrayView<Real> solutions)
+{
+  _checkInit();
+  Int32 nb_dof = m_item_family->maxLocalId();
+  if (rhs.size() != nb_member * nb_dof || solutions.size() != nb_member * nb_dof)
+    ARCANE_FATAL("Bad size for the ensemble vectors rhs={0} solutions={1} expected={2}",
+                 rhs.size(), solutions.size(), nb_member * nb_dof);
+
+  if (m_p->hasSolveEnsemble() && m_nb_null_space_vector == 0) {
+    m_p->solveEnsemble(nb_member, rhs, solutions);
+    return;
+  }
+
+  // One solve per member
+  VariableDoFReal& rhs_values(m_p->rhsVariable());
+  VariableDoFReal& solution_values(m_p->solutionVariable());
+  for (Int32 k = 0; k < nb_member; ++k) {
+    ENUMERATE_ (DoF, idof, m_item_family->allItems()) {
+      Int32 i = idof.itemLocalId();
+      rhs_values[idof] = rhs[i * nb_member + k];
+      solution_values[idof] = solutions[i * nb_member + k];
+    }
+    solve();
+    solution_values.synchronize();
+    ENUMERATE_ (DoF, idof, m_item_family->allItems()) {
+      solutions[idof.itemLocalId() * nb_member + k] = solution_values[idof];
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+bool DoFLinearSystem::
+hasSolveEnsemble() const
+{
+  _checkInit();
+  return m_p->hasSolveEnsemble();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Remove the components of \a values along the null space.
+ *
+ * Returns the norm of the removed part.
+ */
+Real DoFLinearSystem::
+_removeNullSpaceComponents(VariableDoFReal& values)
+{
+  IParallelMng* pm = m_item_family->parallelMng();
+  Int32 nb_dof = m_item_family->maxLocalId();
+  DoFGroup own_dofs = m_item_family->allItems().own();
+  Real norm2 = 0.0;
+  for (Int32 k = 0; k < m_nb_null_space_vector; ++k) {
+    ConstArrayView<Real> z = m_null_space.subConstView(k * nb_dof, nb_dof);
+    Real c = 0.0;
+    ENUMERATE_ (DoF, idof, own_dofs) {
+      c += values[idof] * z[idof.itemLocalId()];
+    }
+    c = pm->reduce(Parallel::ReduceSum, c);
+    ENUMERATE_ (DoF, idof, m_item_family->allItems()) {
+      values[idof] -= c * z[idof.itemLocalId()];
+    }
+    norm2 += c * c;
+  }
+  return math::sqrt(norm2);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 void DoFLinearSystem::
 reset()
 {
   delete m_p;
   m_p = nullptr;
   m_item_family = nullptr;
+  m_null_space.clear();
+  m_nb_null_space_vector = 0;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -495,6 +965,16 @@ class SequentialBasicDoFLinearSystemFactoryService
     x->build();
     x->setEpsilon(options()->epsilon());
     x->setSolverMethod(options()->solverMethod());
+    x->pMultigrid().setSmoother(options()->pmgSmoother());
+    x->pMultigrid().setNbSmoothingStep(options()->pmgNbSmoothingStep());
+    x->pMultigrid().setCoarseSolver(options()->pmgCoarseSolver());
+    x->setUseMixedPrecision(options()->mixedPrecision());
+    x->setCheckMixedPrecision(options()->mixedPrecisionCheck());
+    x->mixedPrecision().setInnerEpsilon(options()->mixedPrecisionInnerEpsilon());
+    x->setUseSellFormat(options()->sellFormat());
+    x->setSellSigma(options()->sellSigma());
+    x->setUseSpMVBenchmark(options()->spmvBenchmark());
+    x->setUseCompressedCsr(options()->compressedCsr());
     return x;
   }
 };
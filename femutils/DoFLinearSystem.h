@@ -1,6 +1,6 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
@@ -15,6 +15,7 @@
 /*---------------------------------------------------------------------------*/
 
 #include <arcane/utils/ArrayView.h>
+#include <arcane/utils/UniqueArray.h>
 #include <arcane/ItemTypes.h>
 #include <arcane/VariableTypedef.h>
 
@@ -88,6 +89,14 @@ class DoFLinearSystemImpl
   virtual bool hasSetCSRValues() const = 0;
   virtual void setRunner(Runner* r) =0;
   virtual Runner* runner() const =0;
+  virtual void setMatrixFrozen(bool v) = 0;
+  virtual bool hasFrozenMatrix() const = 0;
+  virtual void setSolutionAsInitialGuess(bool v) = 0;
+  virtual void setEpsilon(Real v) = 0;
+  virtual void setPMultigridProlongation(const CSRFormatView& prolongation, Int32 nb_coarse_dof) = 0;
+  virtual void setNullSpace(Int32 nb_vector, ConstArrayView<Real> values) = 0;
+  virtual void solveEnsemble(Int32 nb_member, ConstArrayView<Real> rhs, ArrayView<Real> solutions) = 0;
+  virtual bool hasSolveEnsemble() const = 0;
 };
 
 /*---------------------------------------------------------------------------*/
@@ -241,6 +250,111 @@ class DoFLinearSystem
   //! Indique si l'implémentation supporte d'utiliser setCSRValue()
   bool hasSetCSRValues() const;
 
+  /*!
+   * \brief Keep the matrix between two calls to solve().
+   *
+   * If \a v is true, the next call to solve() fills the matrix as usual and
+   * keeps it. The entries A[i,rc] of the columns eliminated by
+   * eliminateRowColumn() are stored once at this time. The following calls
+   * to solve() only rebuild the RHS vector: the lifting term
+   * RHS[i] - A[i,rc] * value is computed from the stored entries for the new
+   * values given to eliminateRow() or eliminateRowColumn().
+   *
+   * While the matrix is frozen the calls to matrixAddValue() and
+   * matrixSetValue() are discarded and the set of eliminated DoFs can not
+   * change. Call clearValues() or reset() to assemble a new matrix.
+   *
+   * Backends which can not keep the matrix (Hypre) ignore this call:
+   * hasFrozenMatrix() then stays false and the matrix is assembled as usual.
+   */
+  void setMatrixFrozen(bool v);
+
+  //! Indicate if the matrix has been frozen by a previous solve() (see setMatrixFrozen())
+  bool hasFrozenMatrix() const;
+
+  /*!
+   * \brief Use the current values of solutionVariable() as the initial guess.
+   *
+   * If \a v is true, iterative solvers start from the values of
+   * solutionVariable() instead of zero. This is useful when a sequence of
+   * close linear systems is solved (for example in a non-linear loop).
+   * Direct solvers ignore this setting.
+   */
+  void setSolutionAsInitialGuess(bool v);
+
+  /*!
+   * \brief Set the relative tolerance of the iterative solvers.
+   *
+   * The value is used by the next calls to solve() and overrides the
+   * tolerance given in the options of the service. This allows inexact
+   * solves whose tolerance changes at each call (for example the forcing
+   * terms of an inexact Newton method). Direct solvers ignore this setting.
+   */
+  void setEpsilon(Real v);
+
+  /*!
+   * \brief Use a two-level p-multigrid preconditioner.
+   *
+   * \a prolongation interpolates the DoFs of the linear system (the fine
+   * level, for example the DoFs of quadratic elements) from \a nb_coarse_dof
+   * coarse DoFs (for example the DoFs of the linear elements on the vertices).
+   * Row \a i of \a prolongation is the DoF with local id \a i and its
+   * columns are in [0, nb_coarse_dof[. The values are copied.
+   *
+   * The coarse matrix is computed from the fine one at each solve() (see
+   * PMultigridPreconditioner).
+   *
+   * Currently it only works with the internal iterative solver of the
+   * 'SequentialBasicLinearSystem' service.
+   */
+  void setPMultigridProlongation(const CSRFormatView& prolongation, Int32 nb_coarse_dof);
+
+  /*!
+   * \brief Set the null space of the matrix.
+   *
+   * This is used for singular problems, for example pure Neumann problems:
+   * the null space is the constants for a scalar problem and the rigid body
+   * modes for elasticity. \a values contains \a nb_vector vectors: the value
+   * of the vector \a k for the DoF of local id \a i is
+   * values[k * nb_dof + i] with nb_dof = dof_family->maxLocalId(). The
+   * vectors only have to be independent, they are orthonormalized here.
+   *
+   * At each solve(), the components of the RHS along the null space are
+   * removed so that the system is compatible and the components of the
+   * solution along the null space are removed after the solve. In addition:
+   * - the internal iterative solver of the 'SequentialBasicLinearSystem'
+   *   service projects the preconditioned residuals on the complement of
+   *   the null space, except with 'mixed-precision' (the direct solver is
+   *   not used),
+   * - the Hypre service gives the vectors to BoomerAMG as interpolation
+   *   vectors.
+   *
+   * The matrix must not have eliminated rows. Use \a nb_vector = 0 to
+   * remove the null space. The null space is removed by reset().
+   */
+  void setNullSpace(Int32 nb_vector, ConstArrayView<Real> values);
+
+  /*!
+   * \brief Solve the current matrix for an ensemble of right hand sides.
+   *
+   * The \a nb_member members share the matrix. The vectors are stored
+   * member-contiguous: the value of the member \a k for the DoF of local id
+   * \a i is rhs[i * nb_member + k] (same for \a solutions), the size of the
+   * arrays being nb_member * dof_family->maxLocalId(). Only the values of the
+   * own DoFs of \a rhs are used, as for rhsVariable(). \a solutions are the
+   * initial guesses if setSolutionAsInitialGuess() has been called.
+   *
+   * The internal iterative solver of the 'SequentialBasicLinearSystem'
+   * service solves all the members together (see EnsembleConjugateGradient).
+   * With the other services, or if a null space has been given, the members
+   * are solved one after the other with solve(). solutionVariable() and
+   * rhsVariable() are then used as work variables.
+   */
+  void solveEnsemble(Int32 nb_member, ConstArrayView<Real> rhs, ArrayView<Real> solutions);
+
+  //! Indicate if the implementation solves the members of solveEnsemble() together
+  bool hasSolveEnsemble() const;
+
  public:
 
   IDoFLinearSystemFactory* linearSystemFactory() const
@@ -254,10 +368,14 @@ class DoFLinearSystem
   IItemFamily* m_item_family = nullptr;
   IDoFLinearSystemFactory* m_linear_system_factory = nullptr;
   IDoFLinearSystemFactory* m_default_linear_system_factory = nullptr;
+  //! Orthonormal basis of the null space (see setNullSpace())
+  UniqueArray<Real> m_null_space;
+  Int32 m_nb_null_space_vector = 0;
 
  private:
 
   void _checkInit() const;
+  Real _removeNullSpaceComponents(VariableDoFReal& values);
 };
 
 /*---------------------------------------------------------------------------*/
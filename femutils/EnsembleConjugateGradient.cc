@@ -0,0 +1,198 @@
+﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* EnsembleConjugateGradient.cc                                (C) 2022-2024 */
+/*                                                                           */
+/* Conjugate gradient on several right hand sides with the same matrix.      */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "EnsembleConjugateGradient.h"
+
+#include <arcane/utils/ITraceMng.h>
+#include <arcane/utils/FatalErrorException.h>
+
+#include <cmath>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+EnsembleConjugateGradient::
+EnsembleConjugateGradient(ITraceMng* tm)
+: TraceAccessor(tm)
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void EnsembleConjugateGradient::
+multiply(Int32 nb_member, ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+         ConstArrayView<Real> values, ConstArrayView<Real> x, ArrayView<Real> y)
+{
+  const Int32 nb_row = rows_index.size() - 1;
+  const Real* x_data = x.data();
+  for (Int32 i = 0; i < nb_row; ++i) {
+    Real* y_row = y.data() + static_cast<Int64>(i) * nb_member;
+    for (Int32 k = 0; k < nb_member; ++k)
+      y_row[k] = 0.0;
+    for (Int32 j = rows_index[i]; j < rows_index[i + 1]; ++j) {
+      const Real a = values[j];
+      const Real* x_row = x_data + static_cast<Int64>(columns[j]) * nb_member;
+      for (Int32 k = 0; k < nb_member; ++k)
+        y_row[k] += a * x_row[k];
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void EnsembleConjugateGradient::
+solve(Int32 nb_member, ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+      ConstArrayView<Real> values, ConstArrayView<Real> b, ArrayView<Real> x)
+{
+  const Int32 n = rows_index.size() - 1;
+  const Int64 size = static_cast<Int64>(n) * nb_member;
+  if (b.size() < size || x.size() < size)
+    ARCANE_FATAL("Bad size for the ensemble vectors b={0} x={1} expected={2}", b.size(), x.size(), size);
+
+  m_inv_diagonal.resize(n);
+  for (Int32 i = 0; i < n; ++i) {
+    m_inv_diagonal[i] = 1.0;
+    for (Int32 j = rows_index[i]; j < rows_index[i + 1]; ++j)
+      if (columns[j] == i && values[j] != 0.0)
+        m_inv_diagonal[i] = 1.0 / values[j];
+  }
+  m_r.resize(size);
+  m_z.resize(size);
+  m_p.resize(size);
+  m_q.resize(size);
+  m_member_nb_iteration.resize(nb_member);
+  m_member_nb_iteration.fill(0);
+
+  // Scalars of each member
+  UniqueArray<Real> tolerance2(nb_member, 0.0);
+  UniqueArray<Real> rz(nb_member, 0.0);
+  UniqueArray<Real> pq(nb_member, 0.0);
+  UniqueArray<Real> alpha(nb_member, 0.0);
+  UniqueArray<Real> rz_new(nb_member, 0.0);
+  UniqueArray<Real> residual2(nb_member, 0.0);
+  UniqueArray<Byte> is_active(nb_member, 1);
+
+  Real tolerance = math::max(m_epsilon, 1.0e-14);
+  for (Int32 i = 0; i < n; ++i) {
+    const Real d = m_inv_diagonal[i];
+    for (Int32 k = 0; k < nb_member; ++k) {
+      const Real v = d * b[i * nb_member + k];
+      tolerance2[k] += v * v;
+    }
+  }
+  for (Int32 k = 0; k < nb_member; ++k)
+    tolerance2[k] *= tolerance * tolerance;
+
+  multiply(nb_member, rows_index, columns, values, x, m_q);
+  for (Int32 i = 0; i < n; ++i) {
+    const Real d = m_inv_diagonal[i];
+    for (Int32 k = 0; k < nb_member; ++k) {
+      const Int64 ik = static_cast<Int64>(i) * nb_member + k;
+      m_r[ik] = b[ik] - m_q[ik];
+      m_z[ik] = d * m_r[ik];
+      m_p[ik] = m_z[ik];
+      rz[k] += m_r[ik] * m_z[ik];
+      residual2[k] += m_z[ik] * m_z[ik];
+    }
+  }
+
+  const Int32 max_iteration = (m_max_iteration > 0) ? m_max_iteration : 10 * n + 100;
+  Int32 nb_active = 0;
+  for (Int32 k = 0; k < nb_member; ++k) {
+    if (residual2[k] <= tolerance2[k])
+      is_active[k] = 0;
+    else
+      ++nb_active;
+  }
+
+  m_nb_iteration = 0;
+  while (nb_active > 0 && m_nb_iteration < max_iteration) {
+    ++m_nb_iteration;
+    // The converged members keep a zero search direction
+    multiply(nb_member, rows_index, columns, values, m_p, m_q);
+    pq.fill(0.0);
+    for (Int32 i = 0; i < n; ++i) {
+      const Int64 offset = static_cast<Int64>(i) * nb_member;
+      for (Int32 k = 0; k < nb_member; ++k)
+        pq[k] += m_p[offset + k] * m_q[offset + k];
+    }
+
+    // alpha = 0 for the converged members
+    for (Int32 k = 0; k < nb_member; ++k)
+      alpha[k] = (is_active[k] && pq[k] != 0.0) ? rz[k] / pq[k] : 0.0;
+
+    rz_new.fill(0.0);
+    residual2.fill(0.0);
+    for (Int32 i = 0; i < n; ++i) {
+      const Real d = m_inv_diagonal[i];
+      for (Int32 k = 0; k < nb_member; ++k) {
+        const Int64 ik = static_cast<Int64>(i) * nb_member + k;
+        x[ik] += alpha[k] * m_p[ik];
+        m_r[ik] -= alpha[k] * m_q[ik];
+        m_z[ik] = d * m_r[ik];
+        rz_new[k] += m_r[ik] * m_z[ik];
+        residual2[k] += m_z[ik] * m_z[ik];
+      }
+    }
+
+    // beta for the active members, the direction of a converged member is cleared
+    for (Int32 k = 0; k < nb_member; ++k) {
+      if (!is_active[k])
+        continue;
+      if (residual2[k] <= tolerance2[k]) {
+        is_active[k] = 0;
+        m_member_nb_iteration[k] = m_nb_iteration;
+        --nb_active;
+        rz_new[k] = 0.0;
+        rz[k] = 0.0;
+      }
+    }
+    for (Int32 i = 0; i < n; ++i) {
+      for (Int32 k = 0; k < nb_member; ++k) {
+        const Int64 ik = static_cast<Int64>(i) * nb_member + k;
+        if (is_active[k])
+          m_p[ik] = m_z[ik] + (rz_new[k] / rz[k]) * m_p[ik];
+        else
+          m_p[ik] = 0.0;
+      }
+    }
+    for (Int32 k = 0; k < nb_member; ++k)
+      if (is_active[k])
+        rz[k] = rz_new[k];
+  }
+
+  for (Int32 k = 0; k < nb_member; ++k) {
+    if (is_active[k]) {
+      m_member_nb_iteration[k] = m_nb_iteration;
+      warning() << "EnsembleConjugateGradient: member " << k << " did not converge after "
+             << m_nb_iteration << " iterations relative_residual="
+             << ((tolerance2[k] > 0.0) ? tolerance * std::sqrt(residual2[k] / tolerance2[k]) : 0.0);
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
@@ -1,11 +1,11 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
 /*---------------------------------------------------------------------------*/
-/* FemDoFsOnNodes.cc                                           (C) 2022-2023 */
+/* FemDoFsOnNodes.cc                                           (C) 2022-2024 */
 /*                                                                           */
 /* Utilitary classes for FEM.                                                */
 /*---------------------------------------------------------------------------*/
@@ -17,6 +17,7 @@
 #include "arcane/IIndexedIncrementalItemConnectivityMng.h"
 #include "arcane/IIndexedIncrementalItemConnectivity.h"
 #include "arcane/IndexedItemConnectivityView.h"
+#include "arcane/ItemInfoListView.h"
 
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -40,11 +41,18 @@ class FemDoFsOnNodes::Impl
  public:
 
   void initialize(IMesh* mesh, Int32 nb_dof_per_node);
+  Int32UniqueArray addDoFsOnNewNodes();
 
  public:
 
   Ref<IIndexedIncrementalItemConnectivity> m_node_dof_connectivity;
   IItemFamily* m_dof_family = nullptr;
+  IMesh* m_mesh = nullptr;
+  Int32 m_nb_dof_per_node = 0;
+
+ private:
+
+  void _addDoFs(Int32ConstArrayView node_lids);
 };
 
 /*---------------------------------------------------------------------------*/
@@ -71,18 +79,65 @@ FemDoFsOnNodes::
 void FemDoFsOnNodes::Impl::
 initialize(IMesh* mesh, Int32 nb_dof_per_node)
 {
-  IItemFamily* dof_family_interface = mesh->findItemFamily(Arcane::IK_DoF, "DoFNodeFamily", true);
-  mesh::DoFFamily* dof_family = ARCANE_CHECK_POINTER(dynamic_cast<mesh::DoFFamily*>(dof_family_interface));
-  m_dof_family = dof_family_interface;
+  m_mesh = mesh;
+  m_nb_dof_per_node = nb_dof_per_node;
+  m_dof_family = mesh->findItemFamily(Arcane::IK_DoF, "DoFNodeFamily", true);
+
+  Int32UniqueArray node_lids;
+  node_lids.reserve(mesh->allNodes().size());
+  ENUMERATE_NODE (inode, mesh->allNodes()) {
+    node_lids.add(inode.itemLocalId());
+  }
+  _addDoFs(node_lids);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Int32UniqueArray FemDoFsOnNodes::Impl::
+addDoFsOnNewNodes()
+{
+  // A node is new if the uniqueId of its first DoF is not in the family.
+  NodeGroup all_nodes = m_mesh->allNodes();
+  Int64UniqueArray uids(all_nodes.size());
+  Int32UniqueArray node_lids(all_nodes.size());
+  {
+    Integer index = 0;
+    ENUMERATE_NODE (inode, all_nodes) {
+      uids[index] = inode->uniqueId().asInt64() * m_nb_dof_per_node;
+      node_lids[index] = inode.itemLocalId();
+      ++index;
+    }
+  }
+  Int32UniqueArray dof_lids(uids.size());
+  m_dof_family->itemsUniqueIdToLocalId(dof_lids, uids, false);
+
+  Int32UniqueArray new_node_lids;
+  for (Integer i = 0, n = dof_lids.size(); i < n; ++i)
+    if (dof_lids[i] == NULL_ITEM_LOCAL_ID)
+      new_node_lids.add(node_lids[i]);
+
+  _addDoFs(new_node_lids);
+  return new_node_lids;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemDoFsOnNodes::Impl::
+_addDoFs(Int32ConstArrayView node_lids)
+{
+  IMesh* mesh = m_mesh;
+  Int32 nb_dof_per_node = m_nb_dof_per_node;
+  mesh::DoFFamily* dof_family = ARCANE_CHECK_POINTER(dynamic_cast<mesh::DoFFamily*>(m_dof_family));
+  NodeInfoListView nodes(mesh->nodeFamily());
 
   // Create the DoFs
-  Int64UniqueArray uids(mesh->allNodes().size() * nb_dof_per_node);
-  Int64 max_node_uid = mesh::DoFUids::getMaxItemUid(mesh->nodeFamily());
+  Int64UniqueArray uids(node_lids.size() * nb_dof_per_node);
   {
     Integer dof_index = 0;
-    ENUMERATE_NODE (inode, mesh->allNodes()) {
-      Node node = *inode;
-      Int64 node_unique_id = node.uniqueId().asInt64();
+    for (Int32 node_lid : node_lids) {
+      Int64 node_unique_id = nodes[node_lid].uniqueId().asInt64();
       for (Integer i = 0; i < nb_dof_per_node; ++i) {
         uids[dof_index] = node_unique_id * nb_dof_per_node + i;
         ++dof_index;
@@ -100,8 +155,8 @@ initialize(IMesh* mesh, Int32 nb_dof_per_node)
   auto* cn = m_node_dof_connectivity->connectivity();
   {
     Integer dof_index = 0;
-    ENUMERATE_NODE (inode, mesh->allNodes()) {
-      NodeLocalId node = *inode;
+    for (Int32 node_lid : node_lids) {
+      NodeLocalId node(node_lid);
       for (Integer i = 0; i < nb_dof_per_node; ++i) {
         cn->addConnectedItem(node, DoFLocalId(dof_lids[dof_index]));
         ++dof_index;
@@ -116,8 +171,8 @@ initialize(IMesh* mesh, Int32 nb_dof_per_node)
     IParallelMng* pm = mesh->parallelMng();
     Int32 my_rank = pm->commRank();
     ItemInternalList dofs = m_dof_family->itemsInternal();
-    ENUMERATE_ (Node, inode, mesh->allNodes()) {
-      Node node = *inode;
+    for (Int32 node_lid : node_lids) {
+      Node node = nodes[node_lid];
       Int32 node_owner = node.owner();
       for (DoFLocalId dof : node_dof.dofs(node)) {
         dofs[dof]->setOwner(node_owner, my_rank);
@@ -140,6 +195,15 @@ initialize(IMesh* mesh, Int32 nb_dof_per_node)
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+Int32UniqueArray FemDoFsOnNodes::
+addDoFsOnNewNodes()
+{
+  return m_p->addDoFsOnNewNodes();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 IndexedNodeDoFConnectivityView FemDoFsOnNodes::
 nodeDoFConnectivityView() const
 {
@@ -1,11 +1,11 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
 /*---------------------------------------------------------------------------*/
-/* FemDoFsOnNodes.h                                            (C) 2022-2023 */
+/* FemDoFsOnNodes.h                                            (C) 2022-2024 */
 /*                                                                           */
 /* Manage one or more DoFs on Nodes.                                         */
 /*---------------------------------------------------------------------------*/
@@ -14,6 +14,7 @@
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+#include <arcane/utils/UniqueArray.h>
 #include <arcane/ItemTypes.h>
 #include <arcane/IndexedItemConnectivityView.h>
 
@@ -65,6 +66,14 @@ class FemDoFsOnNodes
    */
   void initialize(Arcane::IMesh* mesh, Arcane::Int32 nb_dof_per_node);
 
+  /*!
+   * \brief Add the DoFs of the nodes created since the last call.
+   *
+   * This is needed when the mesh has been refined after initialize().
+   * Returns the local ids of the new nodes.
+   */
+  Arcane::Int32UniqueArray addDoFsOnNewNodes();
+
  public:
 
   Arcane::IndexedNodeDoFConnectivityView nodeDoFConnectivityView() const;
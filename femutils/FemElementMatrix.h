@@ -0,0 +1,316 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* FemElementMatrix.h                                          (C) 2022-2023 */
+/*                                                                           */
+/* Elementary matrices and measures of scalar problems.                      */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_FEMELEMENTMATRIX_H
+#define FEMTEST_FEMELEMENTMATRIX_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/ArcaneTypes.h>
+#include <arcane/utils/Real3.h>
+
+#include <cmath>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Elementary stiffness matrix of a bilinear QUAD4 cell.
+ *
+ * Computes K_e[i * 4 + j] = int_{cell}(grad(phi_i) . grad(phi_j)) with
+ * the Q1 shape functions and a 2x2 Gauss quadrature on the reference
+ * element [-1,1]^2. The nodes \a m are given in the order of the cell nodes
+ * (counter clockwise or clockwise).
+ *
+ * These functions can be used on accelerators.
+ */
+ARCCORE_HOST_DEVICE inline void
+computeStiffnessMatrixQUAD4(const Real3 m[4], Real K_e[16])
+{
+  // Coordinates of the nodes of the reference element
+  const Real xi_n[4] = { -1., 1., 1., -1. };
+  const Real eta_n[4] = { -1., -1., 1., 1. };
+  const Real gp = 1. / std::sqrt(3.);
+
+  for (Int32 i = 0; i < 16; ++i)
+    K_e[i] = 0.;
+
+  for (Int32 ig = 0; ig < 4; ++ig) {
+    Real xi = gp * xi_n[ig];
+    Real eta = gp * eta_n[ig];
+
+    Real dphi_dxi[4], dphi_deta[4];
+    Real dx_dxi = 0., dy_dxi = 0., dx_deta = 0., dy_deta = 0.;
+    for (Int32 i = 0; i < 4; ++i) {
+      dphi_dxi[i] = 0.25 * xi_n[i] * (1. + eta * eta_n[i]);
+      dphi_deta[i] = 0.25 * eta_n[i] * (1. + xi * xi_n[i]);
+      dx_dxi += dphi_dxi[i] * m[i].x;
+      dy_dxi += dphi_dxi[i] * m[i].y;
+      dx_deta += dphi_deta[i] * m[i].x;
+      dy_deta += dphi_deta[i] * m[i].y;
+    }
+    Real det_j = dx_dxi * dy_deta - dy_dxi * dx_deta;
+
+    // Gradients of the shape functions in physical coordinates
+    Real dphi_dx[4], dphi_dy[4];
+    for (Int32 i = 0; i < 4; ++i) {
+      dphi_dx[i] = (dy_deta * dphi_dxi[i] - dy_dxi * dphi_deta[i]) / det_j;
+      dphi_dy[i] = (-dx_deta * dphi_dxi[i] + dx_dxi * dphi_deta[i]) / det_j;
+    }
+
+    // Gauss weights are all equal to 1
+    Real w = math::abs(det_j);
+    for (Int32 i = 0; i < 4; ++i)
+      for (Int32 j = 0; j < 4; ++j)
+        K_e[i * 4 + j] += (dphi_dx[i] * dphi_dx[j] + dphi_dy[i] * dphi_dy[j]) * w;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Gradients of the P1 shape functions of a linear TETRA4 cell.
+ *
+ * The gradients \a grad are constant on the cell. Returns the volume of the
+ * cell.
+ */
+ARCCORE_HOST_DEVICE inline Real
+computeGradientsTETRA4(const Real3 m[4], Real3 grad[4])
+{
+  Real3 e1 = m[1] - m[0];
+  Real3 e2 = m[2] - m[0];
+  Real3 e3 = m[3] - m[0];
+
+  // Columns of the inverse of the jacobian: grad(phi_i) for i = 1, 2, 3
+  Real3 c23(e2.y * e3.z - e2.z * e3.y, e2.z * e3.x - e2.x * e3.z, e2.x * e3.y - e2.y * e3.x);
+  Real3 c31(e3.y * e1.z - e3.z * e1.y, e3.z * e1.x - e3.x * e1.z, e3.x * e1.y - e3.y * e1.x);
+  Real3 c12(e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x);
+  Real det_j = e1.x * c23.x + e1.y * c23.y + e1.z * c23.z;
+
+  grad[1] = c23 / det_j;
+  grad[2] = c31 / det_j;
+  grad[3] = c12 / det_j;
+  grad[0] = -(grad[1] + grad[2] + grad[3]);
+
+  return math::abs(det_j) / 6.;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Elementary stiffness matrix of a linear TETRA4 cell.
+ *
+ * Computes K_e[i * 4 + j] = int_{cell}(grad(phi_i) . grad(phi_j)) with the
+ * P1 shape functions, whose gradients are constant on the cell.
+ * Returns the volume of the cell.
+ */
+ARCCORE_HOST_DEVICE inline Real
+computeStiffnessMatrixTETRA4(const Real3 m[4], Real K_e[16])
+{
+  Real3 grad[4];
+  Real volume = computeGradientsTETRA4(m, grad);
+  for (Int32 i = 0; i < 4; ++i)
+    for (Int32 j = 0; j < 4; ++j)
+      K_e[i * 4 + j] = (grad[i].x * grad[j].x + grad[i].y * grad[j].y + grad[i].z * grad[j].z) * volume;
+  return volume;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Shape functions of a trilinear HEXA8 cell at a point of the
+ * reference element [-1,1]^3.
+ *
+ * Fills the values \a phi and the gradients \a grad (in physical
+ * coordinates) of the 8 shape functions at (\a xi, \a eta, \a zeta) and
+ * returns the determinant of the jacobian. The nodes \a m are given in the
+ * order of the cell nodes (bottom face then top face).
+ */
+ARCCORE_HOST_DEVICE inline Real
+computeShapeFunctionsHEXA8(const Real3 m[8], Real xi, Real eta, Real zeta,
+                           Real phi[8], Real3 grad[8])
+{
+  // Coordinates of the nodes of the reference element
+  const Real xi_n[8] = { -1., 1., 1., -1., -1., 1., 1., -1. };
+  const Real eta_n[8] = { -1., -1., 1., 1., -1., -1., 1., 1. };
+  const Real zeta_n[8] = { -1., -1., -1., -1., 1., 1., 1., 1. };
+
+  Real3 dphi_ref[8];
+  Real3 j_xi, j_eta, j_zeta; // rows of the jacobian
+  for (Int32 i = 0; i < 8; ++i) {
+    Real a = 1. + xi * xi_n[i];
+    Real b = 1. + eta * eta_n[i];
+    Real c = 1. + zeta * zeta_n[i];
+    phi[i] = 0.125 * a * b * c;
+    dphi_ref[i] = Real3(0.125 * xi_n[i] * b * c, 0.125 * eta_n[i] * a * c, 0.125 * zeta_n[i] * a * b);
+    j_xi += dphi_ref[i].x * m[i];
+    j_eta += dphi_ref[i].y * m[i];
+    j_zeta += dphi_ref[i].z * m[i];
+  }
+
+  // Inverse of the jacobian from its cofactors
+  Real3 c0(j_eta.y * j_zeta.z - j_eta.z * j_zeta.y, j_eta.z * j_zeta.x - j_eta.x * j_zeta.z, j_eta.x * j_zeta.y - j_eta.y * j_zeta.x);
+  Real3 c1(j_zeta.y * j_xi.z - j_zeta.z * j_xi.y, j_zeta.z * j_xi.x - j_zeta.x * j_xi.z, j_zeta.x * j_xi.y - j_zeta.y * j_xi.x);
+  Real3 c2(j_xi.y * j_eta.z - j_xi.z * j_eta.y, j_xi.z * j_eta.x - j_xi.x * j_eta.z, j_xi.x * j_eta.y - j_xi.y * j_eta.x);
+  Real det_j = j_xi.x * c0.x + j_xi.y * c0.y + j_xi.z * c0.z;
+
+  for (Int32 i = 0; i < 8; ++i)
+    grad[i] = (dphi_ref[i].x * c0 + dphi_ref[i].y * c1 + dphi_ref[i].z * c2) / det_j;
+
+  return det_j;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Elementary stiffness matrix of a trilinear HEXA8 cell.
+ *
+ * Same as computeStiffnessMatrixQUAD4() with the Q1 shape functions of the
+ * hexahedron and a 2x2x2 Gauss quadrature. Returns the volume of the cell.
+ */
+ARCCORE_HOST_DEVICE inline Real
+computeStiffnessMatrixHEXA8(const Real3 m[8], Real K_e[64])
+{
+  const Real gp = 1. / std::sqrt(3.);
+
+  for (Int32 i = 0; i < 64; ++i)
+    K_e[i] = 0.;
+
+  Real volume = 0.;
+  for (Int32 ig = 0; ig < 8; ++ig) {
+    Real xi = (ig & 1) ? gp : -gp;
+    Real eta = (ig & 2) ? gp : -gp;
+    Real zeta = (ig & 4) ? gp : -gp;
+
+    Real phi[8];
+    Real3 grad[8];
+    // Gauss weights are all equal to 1
+    Real w = math::abs(computeShapeFunctionsHEXA8(m, xi, eta, zeta, phi, grad));
+    volume += w;
+    for (Int32 i = 0; i < 8; ++i)
+      for (Int32 j = 0; j < 8; ++j)
+        K_e[i * 8 + j] += (grad[i].x * grad[j].x + grad[i].y * grad[j].y + grad[i].z * grad[j].z) * w;
+  }
+  return volume;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Volume of a TETRA4 cell.
+ */
+ARCCORE_HOST_DEVICE inline Real
+computeVolumeTETRA4(const Real3 m[4])
+{
+  Real3 e1 = m[1] - m[0];
+  Real3 e2 = m[2] - m[0];
+  Real3 e3 = m[3] - m[0];
+  Real det_j = e1.x * (e2.y * e3.z - e2.z * e3.y) + e1.y * (e2.z * e3.x - e2.x * e3.z) + e1.z * (e2.x * e3.y - e2.y * e3.x);
+  return math::abs(det_j) / 6.;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Volume of a HEXA8 cell, integrated with a 2x2x2 Gauss quadrature
+ * (exact for trilinear cells).
+ */
+ARCCORE_HOST_DEVICE inline Real
+computeVolumeHEXA8(const Real3 m[8])
+{
+  const Real gp = 1. / std::sqrt(3.);
+
+  Real volume = 0.;
+  for (Int32 ig = 0; ig < 8; ++ig) {
+    Real phi[8];
+    Real3 grad[8];
+    volume += math::abs(computeShapeFunctionsHEXA8(m, (ig & 1) ? gp : -gp, (ig & 2) ? gp : -gp, (ig & 4) ? gp : -gp, phi, grad));
+  }
+  return volume;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add \a coef times the consistent mass matrix of a TETRA4 cell.
+ *
+ * M_e[i * 4 + j] += coef * int_{cell}(phi_i * phi_j)
+ *                 = coef * volume / 20 * (1 + delta_ij)
+ */
+ARCCORE_HOST_DEVICE inline void
+addMassMatrixTETRA4(Real volume, Real coef, Real M_e[16])
+{
+  for (Int32 i = 0; i < 4; ++i)
+    for (Int32 j = 0; j < 4; ++j)
+      M_e[i * 4 + j] += coef * volume / 20. * ((i == j) ? 2. : 1.);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add \a coef times the consistent mass matrix of a HEXA8 cell,
+ * integrated with a 2x2x2 Gauss quadrature.
+ */
+ARCCORE_HOST_DEVICE inline void
+addMassMatrixHEXA8(const Real3 m[8], Real coef, Real M_e[64])
+{
+  const Real gp = 1. / std::sqrt(3.);
+
+  for (Int32 ig = 0; ig < 8; ++ig) {
+    Real xi = (ig & 1) ? gp : -gp;
+    Real eta = (ig & 2) ? gp : -gp;
+    Real zeta = (ig & 4) ? gp : -gp;
+
+    Real phi[8];
+    Real3 grad[8];
+    Real w = coef * math::abs(computeShapeFunctionsHEXA8(m, xi, eta, zeta, phi, grad));
+    for (Int32 i = 0; i < 8; ++i)
+      for (Int32 j = 0; j < 8; ++j)
+        M_e[i * 8 + j] += phi[i] * phi[j] * w;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Measure of a boundary face: length of an edge (2 nodes) or area
+ * of a triangle (3 nodes) or of a quadrangle (4 nodes).
+ *
+ * It is used to integrate the boundary terms in 2D and 3D with the same
+ * code.
+ */
+ARCCORE_HOST_DEVICE inline Real
+computeFaceMeasure(const Real3 m[], Int32 nb_node)
+{
+  if (nb_node == 2)
+    return (m[1] - m[0]).normL2();
+  // Half of the norm of the cross product of the two diagonals (or of two
+  // edges for a triangle)
+  Real3 a = (nb_node == 4) ? (m[2] - m[0]) : (m[1] - m[0]);
+  Real3 b = (nb_node == 4) ? (m[3] - m[1]) : (m[2] - m[0]);
+  Real3 n(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+  return 0.5 * n.normL2();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,118 @@
+﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* FemLoadPipeline.cc                                          (C) 2022-2024 */
+/*                                                                           */
+/* Loads of the next time step computed during the current solve.            */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "FemLoadPipeline.h"
+
+#include <arcane/utils/ITraceMng.h>
+#include <arcane/utils/FatalErrorException.h>
+#include <arcane/utils/PlatformUtils.h>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+FemLoadPipeline::
+FemLoadPipeline(ITraceMng* tm)
+: TraceAccessor(tm)
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+FemLoadPipeline::
+~FemLoadPipeline()
+{
+  // The thread uses the buffers of this instance
+  if (m_future.valid())
+    m_future.wait();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemLoadPipeline::
+initialize(Int32 size, const LoadFunctor& functor)
+{
+  _wait();
+  m_functor = functor;
+  m_current_loads.resize(size);
+  m_next_loads.resize(size);
+  m_has_prepared_loads = false;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemLoadPipeline::
+_wait()
+{
+  if (!m_future.valid())
+    return;
+  Real t1 = platform::getRealTime();
+  // get() throws the exceptions of the functor
+  m_future.get();
+  m_wait_time += platform::getRealTime() - t1;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+ConstArrayView<Real> FemLoadPipeline::
+loads(Real time)
+{
+  if (!m_functor)
+    ARCANE_FATAL("No functor. You need to call initialize() before using this class");
+  _wait();
+  if (m_has_prepared_loads && m_prepared_time == time) {
+    m_current_loads.swap(m_next_loads);
+    info() << "Loads at t=" << time << " computed during the previous solve total_wait_time=" << m_wait_time;
+  }
+  else {
+    m_current_loads.fill(0.0);
+    m_functor(time, m_current_loads);
+  }
+  m_has_prepared_loads = false;
+  return m_current_loads;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemLoadPipeline::
+prepare(Real time)
+{
+  if (!m_functor)
+    ARCANE_FATAL("No functor. You need to call initialize() before using this class");
+  // Without thread the loads are computed by the next call to loads()
+  if (!m_is_asynchronous)
+    return;
+  _wait();
+  m_prepared_time = time;
+  m_has_prepared_loads = true;
+  m_next_loads.fill(0.0);
+  m_future = std::async(std::launch::async, [this, time]() { m_functor(time, m_next_loads); });
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
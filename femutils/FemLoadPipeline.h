@@ -0,0 +1,107 @@
+﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* FemLoadPipeline.h                                           (C) 2022-2024 */
+/*                                                                           */
+/* Loads of the next time step computed during the current solve.            */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_FEMLOADPIPELINE_H
+#define FEMTEST_FEMLOADPIPELINE_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/TraceAccessor.h>
+
+#include <functional>
+#include <future>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Solution-independent part of the RHS of a transient problem.
+ *
+ * The loads (time series of the boundary conditions, body forces...) only
+ * depend on the time. At each time step the module gets the loads of the
+ * current time with loads(), assembles its RHS and calls prepare() with the
+ * time of the next step before solving the linear system. If the pipeline
+ * is asynchronous, the loads of the next step are then computed by another
+ * thread (std::async) during the solve, in a second buffer. The next call to
+ * loads() waits for this computation and swaps the buffers.
+ *
+ * The functor runs outside of the main thread: it must only read data which
+ * are not modified during the time step (no Arcane item groups or variables,
+ * no traces). The modules give it arrays of DoFs and weights computed once
+ * at the initialisation.
+ */
+class FemLoadPipeline
+: public TraceAccessor
+{
+ public:
+
+  //! Computes the loads at time \a time in \a loads (filled with zeros before the call)
+  using LoadFunctor = std::function<void(Real time, ArrayView<Real> loads)>;
+
+ public:
+
+  explicit FemLoadPipeline(ITraceMng* tm);
+  ~FemLoadPipeline();
+
+ public:
+
+  //! Set the functor for vectors of \a size values
+  void initialize(Int32 size, const LoadFunctor& functor);
+  //! Compute the loads of prepare() in another thread
+  void setAsynchronous(bool v) { m_is_asynchronous = v; }
+  bool isAsynchronous() const { return m_is_asynchronous; }
+
+  /*!
+   * \brief Loads at time \a time.
+   *
+   * They are the ones of the last call to prepare() if it was done with
+   * \a time, or they are computed now. The view stays valid during
+   * prepare() and until the next call to loads().
+   */
+  ConstArrayView<Real> loads(Real time);
+
+  //! Start the computation of the loads at \a time (the next time step) if the pipeline is asynchronous
+  void prepare(Real time);
+
+ private:
+
+  LoadFunctor m_functor;
+  bool m_is_asynchronous = false;
+  bool m_has_prepared_loads = false;
+  Real m_prepared_time = 0.0;
+  std::future<void> m_future;
+  //! Loads returned by loads()
+  UniqueArray<Real> m_current_loads;
+  //! Loads computed by prepare()
+  UniqueArray<Real> m_next_loads;
+  //! Time spent in loads() waiting for the end of prepare()
+  Real m_wait_time = 0.0;
+
+ private:
+
+  void _wait();
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
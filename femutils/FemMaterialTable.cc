@@ -0,0 +1,105 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* FemMaterialTable.cc                                         (C) 2022-2023 */
+/*                                                                           */
+/* Table of material coefficients indexed by cells.                          */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "FemMaterialTable.h"
+
+#include <arcane/utils/FatalErrorException.h>
+#include <arcane/IMesh.h>
+#include <arcane/ItemGroup.h>
+#include <arcane/VariableBuildInfo.h>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+FemMaterialTable::
+FemMaterialTable(ITraceMng* tm)
+: TraceAccessor(tm)
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+FemMaterialTable::
+~FemMaterialTable()
+{
+  delete m_cell_material_index;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemMaterialTable::
+initialize(IMesh* mesh, const String& name, Int32 nb_coefficient)
+{
+  if (m_cell_material_index)
+    ARCANE_FATAL("FemMaterialTable is already initialized");
+  if (nb_coefficient <= 0)
+    ARCANE_FATAL("Invalid number of coefficients '{0}'", nb_coefficient);
+
+  m_cell_material_index = new VariableCellInt32(VariableBuildInfo(mesh, name + "MaterialIndex"));
+  m_cell_material_index->fill(0);
+  m_nb_coefficient = nb_coefficient;
+  m_nb_material = 0;
+  m_values.clear();
+  addMaterial();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Int32 FemMaterialTable::
+addMaterial()
+{
+  // Keep the SoA layout: insert a new value at the end of the values of
+  // each coefficient.
+  Int32 nb_material = m_nb_material + 1;
+  UniqueArray<Real> new_values(m_nb_coefficient * nb_material);
+  for (Int32 c = 0; c < m_nb_coefficient; ++c) {
+    for (Int32 m = 0; m < m_nb_material; ++m)
+      new_values[c * nb_material + m] = m_values[c * m_nb_material + m];
+    new_values[c * nb_material + m_nb_material] = 0.0;
+  }
+  m_values.swap(new_values);
+  m_nb_material = nb_material;
+  return nb_material - 1;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Int32 FemMaterialTable::
+addMaterial(const CellGroup& group)
+{
+  Int32 material_index = addMaterial();
+  VariableCellInt32& cell_material_index(*m_cell_material_index);
+  ENUMERATE_ (Cell, icell, group) {
+    cell_material_index[icell] = material_index;
+  }
+  info() << "Material index=" << material_index << " for group=" << group.name();
+  return material_index;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,141 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* FemMaterialTable.h                                          (C) 2022-2023 */
+/*                                                                           */
+/* Table of material coefficients indexed by cells.                          */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_FEMMATERIALTABLE_H
+#define FEMTEST_FEMMATERIALTABLE_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/TraceAccessor.h>
+#include <arcane/ItemTypes.h>
+#include <arcane/VariableTypes.h>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+/*!
+ * \brief Table of material coefficients shared by the cells.
+ *
+ * Each cell stores the index of its material and each material stores
+ * a fixed number of coefficients. The coefficients are stored by
+ * coefficient (SoA): the values of a coefficient for all the materials are
+ * contiguous. The derived coefficients (Lame parameters, time integration
+ * constants, ...) are computed once per material instead of once per cell
+ * or per element.
+ *
+ * Before using an instance of this class you need to call method
+ * initialize(). All the cells then use the material 0.
+ *
+ * \code
+ * FemMaterialTable materials(traceMng());
+ * materials.initialize(mesh(), "Fem", NB_COEFFICIENT);
+ * materials.setValue(LAMBDA, 0, default_lambda);
+ * Int32 mat_index = materials.addMaterial(cell_group);
+ * materials.setValue(LAMBDA, mat_index, lambda);
+ * ...
+ * Real lambda = materials.cellValue(LAMBDA, cell);
+ * \endcode
+ */
+class FemMaterialTable
+: public TraceAccessor
+{
+ public:
+
+  explicit FemMaterialTable(ITraceMng* tm);
+  ~FemMaterialTable();
+
+ public:
+
+  FemMaterialTable(const FemMaterialTable&) = delete;
+  FemMaterialTable(FemMaterialTable&&) = delete;
+  FemMaterialTable& operator=(FemMaterialTable&&) = delete;
+  FemMaterialTable& operator=(const FemMaterialTable&) = delete;
+
+ public:
+
+  /*!
+   * \brief Initialize the instance with one material used by all the cells.
+   *
+   * The index of the material of the cells is stored in a variable
+   * named \a name + "MaterialIndex".
+   */
+  void initialize(IMesh* mesh, const String& name, Int32 nb_coefficient);
+
+  //! Add a material whose coefficients are zero and return its index
+  Int32 addMaterial();
+
+  //! Add a material used by the cells of \a group and return its index
+  Int32 addMaterial(const CellGroup& group);
+
+  //! Set the material of cell \a cell
+  void setCellMaterial(CellLocalId cell, Int32 material_index)
+  {
+    (*m_cell_material_index)[cell] = material_index;
+  }
+
+  Int32 nbMaterial() const { return m_nb_material; }
+  Int32 nbCoefficient() const { return m_nb_coefficient; }
+
+  //! Set the value of coefficient \a coefficient for material \a material_index
+  void setValue(Int32 coefficient, Int32 material_index, Real value)
+  {
+    m_values[coefficient * m_nb_material + material_index] = value;
+  }
+
+  //! Value of coefficient \a coefficient for material \a material_index
+  Real value(Int32 coefficient, Int32 material_index) const
+  {
+    return m_values[coefficient * m_nb_material + material_index];
+  }
+
+  //! Values of coefficient \a coefficient for all the materials
+  ConstArrayView<Real> values(Int32 coefficient) const
+  {
+    return m_values.subConstView(coefficient * m_nb_material, m_nb_material);
+  }
+
+  //! Index of the material of cell \a cell
+  Int32 materialIndex(CellLocalId cell) const { return (*m_cell_material_index)[cell]; }
+
+  //! Value of coefficient \a coefficient for the material of cell \a cell
+  Real cellValue(Int32 coefficient, CellLocalId cell) const
+  {
+    return value(coefficient, materialIndex(cell));
+  }
+
+  //! Variable containing the index of the material of each cell
+  VariableCellInt32& cellMaterialIndex() { return *m_cell_material_index; }
+
+ private:
+
+  VariableCellInt32* m_cell_material_index = nullptr;
+  Int32 m_nb_coefficient = 0;
+  Int32 m_nb_material = 0;
+  //! Values of the coefficients (size is m_nb_coefficient * m_nb_material)
+  UniqueArray<Real> m_values;
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,128 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* FemNodeCellConnectivity.cc                                  (C) 2022-2023 */
+/*                                                                           */
+/* Node to cell connectivity with the local index of the node in the cell.   */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "FemNodeCellConnectivity.h"
+
+#include <arcane/utils/FatalErrorException.h>
+#include <arcane/IMesh.h>
+#include <arcane/IItemFamily.h>
+#include <arcane/ItemGroup.h>
+
+#include "CsrFormatMatrix.h"
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+FemNodeCellConnectivity::
+FemNodeCellConnectivity(ITraceMng* tm)
+: TraceAccessor(tm)
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemNodeCellConnectivity::
+initialize(IMesh* mesh)
+{
+  m_mesh = mesh;
+  IItemFamily* node_family = mesh->nodeFamily();
+  Int32 nb_node = node_family->maxLocalId();
+
+  // Count the pairs and the maximum number of nodes per cell
+  m_node_begin.resize(nb_node + 1);
+  m_node_begin.fill(0);
+  m_max_nb_node_per_cell = 0;
+  ENUMERATE_ (Node, inode, mesh->allNodes()) {
+    Node node = *inode;
+    m_node_begin(node.localId() + 1) = node.nbCell();
+  }
+  ENUMERATE_ (Cell, icell, mesh->allCells()) {
+    m_max_nb_node_per_cell = math::max(m_max_nb_node_per_cell, (*icell).nbNode());
+  }
+  for (Int32 i = 0; i < nb_node; ++i)
+    m_node_begin(i + 1) += m_node_begin(i);
+  m_nb_pair = m_node_begin(nb_node);
+
+  // Fill the pairs in the order of node.cells(), which is the order of the
+  // node-cell connectivity view used in the accelerator kernels.
+  m_pair_cell.resize(m_nb_pair);
+  m_local_index.resize(m_nb_pair);
+  ENUMERATE_ (Node, inode, mesh->allNodes()) {
+    Node node = *inode;
+    Int32 p = m_node_begin(node.localId());
+    for (Cell cell : node.cells()) {
+      Int32 local_index = -1;
+      for (Int32 i = 0, n = cell.nbNode(); i < n; ++i) {
+        if (cell.nodeId(i) == node.itemLocalId()) {
+          local_index = i;
+          break;
+        }
+      }
+      if (local_index < 0)
+        ARCANE_FATAL("Node '{0}' not found in cell '{1}'", node.uniqueId(), cell.uniqueId());
+      m_pair_cell(p) = cell.localId();
+      m_local_index(p) = local_index;
+      ++p;
+    }
+  }
+  m_csr_slot.resize(0);
+
+  info() << "FemNodeCellConnectivity: nb_pair=" << m_nb_pair
+         << " max_nb_node_per_cell=" << m_max_nb_node_per_cell;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemNodeCellConnectivity::
+computeCsrSlots(IndexedNodeDoFConnectivityView node_dof, CsrFormat& csr)
+{
+  if (!m_mesh)
+    ARCANE_FATAL("FemNodeCellConnectivity is not initialized");
+
+  const Int32 max_nb_node = m_max_nb_node_per_cell;
+  m_csr_slot.resize(m_nb_pair * max_nb_node);
+  m_csr_slot.fill(-1);
+
+  ENUMERATE_ (Node, inode, m_mesh->allNodes()) {
+    Node node = *inode;
+    DoFLocalId row = node_dof.dofId(node, 0);
+    Int32 p = m_node_begin(node.localId());
+    for (Cell cell : node.cells()) {
+      Int32 j = 0;
+      for (Node node2 : cell.nodes()) {
+        Int32 slot = csr.indexValue(row, node_dof.dofId(node2, 0));
+        if (slot < 0)
+          ARCANE_FATAL("No CSR entry for nodes '{0}' and '{1}'", node.uniqueId(), node2.uniqueId());
+        m_csr_slot(p * max_nb_node + j) = slot;
+        ++j;
+      }
+      ++p;
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,114 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* FemNodeCellConnectivity.h                                   (C) 2022-2023 */
+/*                                                                           */
+/* Node to cell connectivity with the local index of the node in the cell.   */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_FEMNODECELLCONNECTIVITY_H
+#define FEMTEST_FEMNODECELLCONNECTIVITY_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/utils/NumArray.h>
+#include <arcane/utils/TraceAccessor.h>
+#include <arcane/ItemTypes.h>
+#include <arcane/IndexedItemConnectivityView.h>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+class CsrFormat;
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+/*!
+ * \brief Node to cell connectivity for nodewise assembly.
+ *
+ * For each node, the (node, cell) pairs are stored contiguously, in the
+ * order of the cells of the node. For each pair, the connectivity keeps the
+ * cell, the local index of the node in the cell and, once computeCsrSlots()
+ * has been called, the index in the CSR arrays of the entries
+ * (row of the node, column of the j-th node of the cell).
+ *
+ * This allows a nodewise assembly without searching the position of the
+ * node in the cell nor the position of the entry in the CSR row:
+ *
+ * \code
+ * for (Int32 p = node_begin[node]; p < node_begin[node + 1]; ++p) {
+ *   Int32 i = local_index[p];
+ *   for (Int32 j = 0; j < nb_node_per_cell; ++j)
+ *     csr_value[csr_slot[p * max_nb_node + j]] += K_e(pair_cell[p], i, j);
+ * }
+ * \endcode
+ *
+ * It works for any kind of cells. The number of slots per pair is the
+ * maximum number of nodes of a cell (maxNbNodePerCell()); the unused slots
+ * are set to -1.
+ */
+class FemNodeCellConnectivity
+: public TraceAccessor
+{
+ public:
+
+  explicit FemNodeCellConnectivity(ITraceMng* tm);
+
+ public:
+
+  FemNodeCellConnectivity(const FemNodeCellConnectivity&) = delete;
+  FemNodeCellConnectivity(FemNodeCellConnectivity&&) = delete;
+  FemNodeCellConnectivity& operator=(FemNodeCellConnectivity&&) = delete;
+  FemNodeCellConnectivity& operator=(const FemNodeCellConnectivity&) = delete;
+
+ public:
+
+  //! Build the (node, cell) pairs and the local indexes
+  void initialize(IMesh* mesh);
+
+  /*!
+   * \brief Compute the CSR slots of the pairs.
+   *
+   * The non zero pattern of \a csr must contain all the entries coupling
+   * two nodes of the same cell. This method has to be called again if the
+   * pattern of \a csr changes.
+   */
+  void computeCsrSlots(IndexedNodeDoFConnectivityView node_dof, CsrFormat& csr);
+
+  bool isInitialized() const { return m_mesh != nullptr; }
+  Int32 nbPair() const { return m_nb_pair; }
+  Int32 maxNbNodePerCell() const { return m_max_nb_node_per_cell; }
+
+ public:
+
+  //! Index of the first pair of each node (size is max node local id + 1)
+  NumArray<Int32, MDDim1> m_node_begin;
+  //! Local id of the cell of each pair
+  NumArray<Int32, MDDim1> m_pair_cell;
+  //! Local index of the node in the cell of each pair
+  NumArray<Int32, MDDim1> m_local_index;
+  //! CSR slots of each pair (size is nbPair() * maxNbNodePerCell())
+  NumArray<Int32, MDDim1> m_csr_slot;
+
+ private:
+
+  IMesh* m_mesh = nullptr;
+  Int32 m_nb_pair = 0;
+  Int32 m_max_nb_node_per_cell = 0;
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,154 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* FemSourceTerm.h                                             (C) 2022-2023 */
+/*                                                                           */
+/* Elementary vectors of volume source terms.                                */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_FEMSOURCETERM_H
+#define FEMTEST_FEMSOURCETERM_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/ArcaneTypes.h>
+#include <arcane/utils/Real3.h>
+
+#include "FemElementMatrix.h"
+
+#include <cmath>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add the elementary vector of a volume source on a TRIA3 cell.
+ *
+ * The source is f = \a f_cell + f_h where \a f_cell is constant on the cell
+ * and f_h is the linear interpolation of the nodal values \a f_node.
+ * The integrals are exact:
+ *
+ *   b_e[i] += int_{cell}(f * phi_i)
+ *           = f_cell * area / 3 + area / 12 * (f_node[i] + sum_j f_node[j])
+ *
+ * The area of the cell is given by the caller, which usually computes it
+ * for the element matrix too.
+ */
+ARCCORE_HOST_DEVICE inline void
+addSourceTermTRIA3(Real area, Real f_cell, const Real f_node[3], Real b_e[3])
+{
+  Real sum_f = f_node[0] + f_node[1] + f_node[2];
+  for (Int32 i = 0; i < 3; ++i)
+    b_e[i] += f_cell * area / 3. + area / 12. * (f_node[i] + sum_f);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add the elementary vector of a volume source on a QUAD4 cell.
+ *
+ * Same source as addSourceTermTRIA3(), with f_h the bilinear interpolation
+ * of \a f_node. The integrals are computed with a 2x2 Gauss quadrature on the
+ * reference element, which is exact for parallelograms.
+ * The nodes \a m are given in the order of the cell nodes.
+ */
+ARCCORE_HOST_DEVICE inline void
+addSourceTermQUAD4(const Real3 m[4], Real f_cell, const Real f_node[4], Real b_e[4])
+{
+  // Coordinates of the nodes of the reference element
+  const Real xi_n[4] = { -1., 1., 1., -1. };
+  const Real eta_n[4] = { -1., -1., 1., 1. };
+  const Real gp = 1. / std::sqrt(3.);
+
+  for (Int32 ig = 0; ig < 4; ++ig) {
+    Real xi = gp * xi_n[ig];
+    Real eta = gp * eta_n[ig];
+
+    Real phi[4];
+    Real dxi_x = 0., dxi_y = 0., deta_x = 0., deta_y = 0.;
+    for (Int32 i = 0; i < 4; ++i) {
+      phi[i] = 0.25 * (1. + xi * xi_n[i]) * (1. + eta * eta_n[i]);
+      Real dphi_dxi = 0.25 * xi_n[i] * (1. + eta * eta_n[i]);
+      Real dphi_deta = 0.25 * eta_n[i] * (1. + xi * xi_n[i]);
+      dxi_x += dphi_dxi * m[i].x;
+      dxi_y += dphi_dxi * m[i].y;
+      deta_x += dphi_deta * m[i].x;
+      deta_y += dphi_deta * m[i].y;
+    }
+    // Gauss weights are all equal to 1
+    Real det_j = math::abs(dxi_x * deta_y - dxi_y * deta_x);
+
+    Real f = f_cell;
+    for (Int32 i = 0; i < 4; ++i)
+      f += phi[i] * f_node[i];
+
+    for (Int32 i = 0; i < 4; ++i)
+      b_e[i] += f * phi[i] * det_j;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add the elementary vector of a volume source on a TETRA4 cell.
+ *
+ * Same source as addSourceTermTRIA3(), the integrals are exact:
+ *
+ *   b_e[i] += f_cell * volume / 4 + volume / 20 * (f_node[i] + sum_j f_node[j])
+ */
+ARCCORE_HOST_DEVICE inline void
+addSourceTermTETRA4(Real volume, Real f_cell, const Real f_node[4], Real b_e[4])
+{
+  Real sum_f = f_node[0] + f_node[1] + f_node[2] + f_node[3];
+  for (Int32 i = 0; i < 4; ++i)
+    b_e[i] += f_cell * volume / 4. + volume / 20. * (f_node[i] + sum_f);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add the elementary vector of a volume source on a HEXA8 cell.
+ *
+ * Same source as addSourceTermQUAD4(), integrated with a 2x2x2 Gauss
+ * quadrature.
+ */
+ARCCORE_HOST_DEVICE inline void
+addSourceTermHEXA8(const Real3 m[8], Real f_cell, const Real f_node[8], Real b_e[8])
+{
+  const Real gp = 1. / std::sqrt(3.);
+
+  for (Int32 ig = 0; ig < 8; ++ig) {
+    Real xi = (ig & 1) ? gp : -gp;
+    Real eta = (ig & 2) ? gp : -gp;
+    Real zeta = (ig & 4) ? gp : -gp;
+
+    Real phi[8];
+    Real3 grad[8];
+    Real det_j = math::abs(computeShapeFunctionsHEXA8(m, xi, eta, zeta, phi, grad));
+
+    Real f = f_cell;
+    for (Int32 i = 0; i < 8; ++i)
+      f += phi[i] * f_node[i];
+
+    for (Int32 i = 0; i < 8; ++i)
+      b_e[i] += f * phi[i] * det_j;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
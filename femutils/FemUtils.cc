@@ -20,6 +20,7 @@
 #include <arcane/IParallelMng.h>
 #include <arcane/VariableTypes.h>
 #include <arcane/IItemFamily.h>
+#include <fstream>
 #include <map>
 
 /*---------------------------------------------------------------------------*/
@@ -142,6 +143,90 @@ void checkNodeResultFile(ITraceMng* tm, const String& filename,
     ARCANE_FATAL("Error checking values nb_error={0}", nb_error);
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void checkNodeResultFile(ITraceMng* tm, const String& filename,
+                         const VariableNodeReal3& node_values, double epsilon)
+{
+  ARCANE_CHECK_POINTER(tm);
+
+  tm->info() << "CheckNodeResultFile filename=" << filename;
+  if (filename.empty())
+    ARCANE_FATAL("Invalid empty filename");
+  IItemFamily* node_family = node_values.variable()->itemFamily();
+  if (!node_family)
+    ARCANE_FATAL("Variable '{0}' is not allocated", node_values.name());
+
+  std::map<Int64, Real3> item_reference_values;
+  {
+    std::ifstream sbuf(filename.localstr());
+    Real3 read_value;
+    Int64 read_uid = 0;
+    if (!sbuf.eof())
+      sbuf >> ws;
+    while (!sbuf.eof()) {
+      sbuf >> read_uid >> ws >> read_value.x >> ws >> read_value.y >> ws >> read_value.z;
+      if (sbuf.fail() || sbuf.bad())
+        ARCANE_FATAL("Error during parsing of file '{0}'", filename);
+      item_reference_values.insert(std::make_pair(read_uid, read_value));
+      sbuf >> ws;
+    }
+  }
+
+  tm->info() << "NB_Values=" << item_reference_values.size();
+
+  Int64 nb_error = 0;
+  ENUMERATE_ (Node, inode, node_family->allItems()) {
+    Node node = *inode;
+    auto x_ref = item_reference_values.find(node.uniqueId());
+    if (x_ref == item_reference_values.end())
+      continue;
+    Real3 ref_v = x_ref->second;
+    Real3 v = node_values[node];
+    for (Int32 i = 0; i < 3; ++i) {
+      if (!TypeEqualT<double>::isNearlyEqualWithEpsilon(ref_v[i], v[i], epsilon)) {
+        ++nb_error;
+        if (nb_error < 50)
+          tm->info() << String::format("ERROR: uid={0} component={1} ref={2} v={3} diff={4}",
+                                       node.uniqueId(), i, ref_v[i], v[i], ref_v[i] - v[i]);
+      }
+    }
+  }
+  if (nb_error > 0)
+    ARCANE_FATAL("Error checking values nb_error={0}", nb_error);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Write the values of the variable in a file readable by checkNodeResultFile().
+ */
+void writeNodeResultFile(ITraceMng* tm, const String& filename,
+                         const VariableNodeReal3& node_values)
+{
+  ARCANE_CHECK_POINTER(tm);
+
+  tm->info() << "WriteNodeResultFile filename=" << filename;
+  if (filename.empty())
+    ARCANE_FATAL("Invalid empty filename");
+  IItemFamily* node_family = node_values.variable()->itemFamily();
+  if (!node_family)
+    ARCANE_FATAL("Variable '{0}' is not allocated", node_values.name());
+  if (node_family->parallelMng()->commSize() > 1)
+    ARCANE_FATAL("writeNodeResultFile() is only available for sequential runs");
+
+  std::ofstream ofile(filename.localstr());
+  ofile.flags(ios::scientific);
+  ofile.precision(17);
+  ENUMERATE_ (Node, inode, node_family->allItems()) {
+    Real3 v = node_values[inode];
+    ofile << inode->uniqueId() << " " << v.x << " " << v.y << " " << v.z << "\n";
+  }
+  if (!ofile)
+    ARCANE_FATAL("Can not write file '{0}'", filename);
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 /*!
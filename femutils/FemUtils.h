@@ -169,6 +169,31 @@ extern "C++" void
 checkNodeResultFile(ITraceMng* tm, const String& filename,
                     const VariableNodeReal& node_values, double epsilon);
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Check the values of the Real3 variable against a reference file.
+ *
+ * Each line of the reference file \a filename contains the unique id of a
+ * node and its three components. Only the listed nodes are checked, with
+ * the relative tolerance \a epsilon on each component.
+ */
+extern "C++" void
+checkNodeResultFile(ITraceMng* tm, const String& filename,
+                    const VariableNodeReal3& node_values, double epsilon);
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Write the values of the Real3 variable in a reference file.
+ *
+ * The file can be read by checkNodeResultFile() to compare two runs. Only
+ * sequential runs are supported.
+ */
+extern "C++" void
+writeNodeResultFile(ITraceMng* tm, const String& filename,
+                    const VariableNodeReal3& node_values);
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 /*!
@@ -1,6 +1,6 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
@@ -163,6 +163,32 @@ class HypreDoFLinearSystemImpl
 
   void setRunner(Runner* r) override { m_runner = r; }
   Runner* runner() const { return m_runner; }
+  // The matrix is not kept by this backend: it is assembled again before each
+  // solve and hasFrozenMatrix() is always false.
+  void setMatrixFrozen(bool v) override
+  {
+    if (v)
+      info() << "[Hypre] Frozen matrix is not supported: the matrix is assembled at each solve";
+  }
+  bool hasFrozenMatrix() const override { return false; }
+  // The solution vector is always initialized with the values of 'm_dof_variable'
+  void setSolutionAsInitialGuess(bool) override {}
+  void setEpsilon(Real v) override { m_epsilon = v; }
+  void setPMultigridProlongation(const CSRFormatView&, Int32) override
+  {
+    ARCANE_THROW(NotImplementedException, "p-multigrid preconditioner is not available with Hypre");
+  }
+  void setNullSpace(Int32 nb_vector, ConstArrayView<Real> values) override
+  {
+    m_nb_null_space_vector = nb_vector;
+    m_null_space.copy(values);
+  }
+  // The members are solved one after the other by DoFLinearSystem::solveEnsemble()
+  void solveEnsemble(Int32, ConstArrayView<Real>, ArrayView<Real>) override
+  {
+    ARCANE_THROW(NotImplementedException, "");
+  }
+  bool hasSolveEnsemble() const override { return false; }
 
  private:
 
@@ -182,6 +208,11 @@ class HypreDoFLinearSystemImpl
   CSRFormatView m_csr_view;
   Int32 m_first_own_row = -1;
   Int32 m_nb_own_row = -1;
+  //! Relative tolerance of the PCG solver
+  Real m_epsilon = 1.0e-7;
+  //! Null space given to BoomerAMG as interpolation vectors
+  UniqueArray<Real> m_null_space;
+  Int32 m_nb_null_space_vector = 0;
 
  private:
 
@@ -454,7 +485,7 @@ solve()
 
   /* Set some parameters (See Reference Manual for more parameters) */
   HYPRE_PCGSetMaxIter(solver, 1000); /* max iterations */
-  HYPRE_PCGSetTol(solver, 1e-7); /* conv. tolerance */
+  HYPRE_PCGSetTol(solver, m_epsilon); /* conv. tolerance */
   HYPRE_PCGSetTwoNorm(solver, 1); /* use the two norm as the stopping criteria */
   HYPRE_PCGSetPrintLevel(solver, 2); /* print solve info */
   HYPRE_PCGSetLogging(solver, 1); /* needed to get run info later */
@@ -470,6 +501,27 @@ solve()
   HYPRE_BoomerAMGSetTol(precond, 0.0); /* conv. tolerance zero */
   HYPRE_BoomerAMGSetMaxIter(precond, 1); /* do only one iteration! */
 
+  // The null space is given to BoomerAMG as interpolation vectors
+  UniqueArray<HYPRE_IJVector> ij_null_space(m_nb_null_space_vector, nullptr);
+  UniqueArray<HYPRE_ParVector> parvector_null_space(m_nb_null_space_vector, nullptr);
+  const Int32 nb_dof = m_dof_family->maxLocalId();
+  for (Int32 k = 0; k < m_nb_null_space_vector; ++k) {
+    hypreCheck("IJVectorCreate", HYPRE_IJVectorCreate(mpi_comm, first_row, last_row, &ij_null_space[k]));
+    hypreCheck("IJVectorSetObjectType", HYPRE_IJVectorSetObjectType(ij_null_space[k], HYPRE_PARCSR));
+    HYPRE_IJVectorInitialize_v2(ij_null_space[k], hypre_memory);
+    hypreCheck("HYPRE_IJVectorSetValues",
+               HYPRE_IJVectorSetValues(ij_null_space[k], nb_local_row, rows_index_span.data(),
+                                       m_null_space.data() + k * nb_dof));
+    hypreCheck("HYPRE_IJVectorAssemble", HYPRE_IJVectorAssemble(ij_null_space[k]));
+    HYPRE_IJVectorGetObject(ij_null_space[k], (void**)&parvector_null_space[k]);
+  }
+  if (m_nb_null_space_vector > 0) {
+    info() << "Using " << m_nb_null_space_vector << " null space vectors as interpolation vectors of BoomerAMG";
+    hypreCheck("HYPRE_BoomerAMGSetInterpVectors",
+               HYPRE_BoomerAMGSetInterpVectors(precond, m_nb_null_space_vector, parvector_null_space.data()));
+    hypreCheck("HYPRE_BoomerAMGSetInterpVecVariant", HYPRE_BoomerAMGSetInterpVecVariant(precond, 2));
+  }
+
   hypreCheck("HYPRE_ParCSRPCGSetPrecond",
              HYPRE_ParCSRPCGSetPrecond(solver, HYPRE_BoomerAMGSolve, HYPRE_BoomerAMGSetup, precond));
   hypreCheck("HYPRE_PCGSetup",
@@ -479,6 +531,8 @@ solve()
              HYPRE_ParCSRPCGSolve(solver, parcsr_A, parvector_b, parvector_x));
   Real b1 = platform::getRealTime();
   info() << "Time to solve=" << (b1 - a1);
+  for (HYPRE_IJVector v : ij_null_space)
+    HYPRE_IJVectorDestroy(v);
 
   if (is_parallel) {
     Int32 nb_wanted_row = m_parallel_rows_index.extent0();
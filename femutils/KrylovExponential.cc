@@ -0,0 +1,237 @@
+﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* KrylovExponential.cc                                        (C) 2022-2024 */
+/*                                                                           */
+/* Action of matrix exponential functions with the Lanczos method.           */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "KrylovExponential.h"
+
+#include <arcane/utils/ITraceMng.h>
+
+#include <cmath>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+namespace
+{
+  //! phi_1(z) = (exp(z) - 1) / z
+  Real _phi1(Real z)
+  {
+    if (std::abs(z) < 1.0e-8)
+      return 1.0 + 0.5 * z;
+    return std::expm1(z) / z;
+  }
+
+  //! phi_2(z) = (exp(z) - 1 - z) / z^2
+  Real _phi2(Real z)
+  {
+    if (std::abs(z) < 1.0e-3)
+      return 0.5 + z / 6.0 + z * z / 24.0;
+    return (std::expm1(z) - z) / (z * z);
+  }
+
+  /*!
+   * \brief Eigenvalues and eigenvectors of the symmetric matrix \a a (n x n,
+   * row major) with the cyclic Jacobi method.
+   *
+   * On exit the diagonal of \a a has the eigenvalues and the column k of \a q
+   * the eigenvector of the k-th eigenvalue.
+   */
+  void _computeEigen(Int32 n, ArrayView<Real> a, ArrayView<Real> q)
+  {
+    q.fill(0.0);
+    for (Int32 i = 0; i < n; ++i)
+      q[i * n + i] = 1.0;
+
+    for (Int32 sweep = 0; sweep < 100; ++sweep) {
+      Real off = 0.0;
+      Real diag = 0.0;
+      for (Int32 i = 0; i < n; ++i) {
+        diag += a[i * n + i] * a[i * n + i];
+        for (Int32 j = i + 1; j < n; ++j)
+          off += a[i * n + j] * a[i * n + j];
+      }
+      if (off <= 1.0e-32 * diag)
+        return;
+
+      for (Int32 p = 0; p < n; ++p) {
+        for (Int32 r = p + 1; r < n; ++r) {
+          Real apr = a[p * n + r];
+          if (apr == 0.0)
+            continue;
+          Real theta = (a[r * n + r] - a[p * n + p]) / (2.0 * apr);
+          Real t = 1.0 / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+          if (theta < 0.0)
+            t = -t;
+          Real c = 1.0 / std::sqrt(t * t + 1.0);
+          Real s = t * c;
+          for (Int32 k = 0; k < n; ++k) {
+            Real akp = a[k * n + p];
+            Real akr = a[k * n + r];
+            a[k * n + p] = c * akp - s * akr;
+            a[k * n + r] = s * akp + c * akr;
+          }
+          for (Int32 k = 0; k < n; ++k) {
+            Real apk = a[p * n + k];
+            Real ark = a[r * n + k];
+            a[p * n + k] = c * apk - s * ark;
+            a[r * n + k] = s * apk + c * ark;
+          }
+          for (Int32 k = 0; k < n; ++k) {
+            Real qkp = q[k * n + p];
+            Real qkr = q[k * n + r];
+            q[k * n + p] = c * qkp - s * qkr;
+            q[k * n + r] = s * qkp + c * qkr;
+          }
+        }
+      }
+    }
+  }
+} // namespace
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+KrylovExponential::
+KrylovExponential(ITraceMng* tm)
+: TraceAccessor(tm)
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Compute phi_1(-tau T) e_1 and e_m^T phi_2(-tau T) e_1 for the
+ * tridiagonal matrix T with diagonal \a alpha and off-diagonal \a beta.
+ */
+void KrylovExponential::
+_computePhi(ConstArrayView<Real> alpha, ConstArrayView<Real> beta, Real tau,
+            ArrayView<Real> phi1_e1, Real& phi2_last)
+{
+  Int32 m = alpha.size();
+  UniqueArray<Real> a(m * m, 0.0);
+  UniqueArray<Real> q(m * m);
+  for (Int32 i = 0; i < m; ++i) {
+    a[i * m + i] = alpha[i];
+    if (i + 1 < m) {
+      a[i * m + i + 1] = beta[i];
+      a[(i + 1) * m + i] = beta[i];
+    }
+  }
+  _computeEigen(m, a, q);
+
+  // phi(-tau T) e_1 = Q phi(-tau Lambda) Q^T e_1
+  phi1_e1.fill(0.0);
+  phi2_last = 0.0;
+  for (Int32 k = 0; k < m; ++k) {
+    Real z = -tau * a[k * m + k];
+    Real c1 = _phi1(z) * q[k];
+    for (Int32 i = 0; i < m; ++i)
+      phi1_e1[i] += q[i * m + k] * c1;
+    phi2_last += q[(m - 1) * m + k] * _phi2(z) * q[k];
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+bool KrylovExponential::
+applyPhi1(const Operator& s, const DotProduct& dot, Real tau,
+          ConstArrayView<Real> v, ArrayView<Real> y)
+{
+  Int32 n = v.size();
+  y.fill(0.0);
+  m_dimension = 0;
+  m_error_estimate = 0.0;
+
+  Real v_norm = std::sqrt(dot(v, v));
+  if (v_norm == 0.0)
+    return true;
+
+  m_basis.resize(static_cast<Int64>(m_max_dimension) * n);
+  m_w.resize(n);
+  auto basis = [&](Int32 j) { return ArrayView<Real>(n, m_basis.data() + static_cast<Int64>(j) * n); };
+
+  UniqueArray<Real> alpha;
+  UniqueArray<Real> beta;
+  UniqueArray<Real> phi1_e1(m_max_dimension);
+  {
+    ArrayView<Real> v0 = basis(0);
+    for (Int32 i = 0; i < n; ++i)
+      v0[i] = v[i] / v_norm;
+  }
+
+  bool is_converged = false;
+  for (Int32 j = 0; j < m_max_dimension; ++j) {
+    ArrayView<Real> vj = basis(j);
+    ArrayView<Real> w = m_w;
+    s(vj, w);
+    Real a = dot(vj, w);
+    alpha.add(a);
+
+    // Lanczos recurrence followed by a full re-orthogonalization
+    for (Int32 i = 0; i < n; ++i)
+      w[i] -= a * vj[i];
+    if (j > 0) {
+      ArrayView<Real> vp = basis(j - 1);
+      for (Int32 i = 0; i < n; ++i)
+        w[i] -= beta[j - 1] * vp[i];
+    }
+    for (Int32 k = 0; k <= j; ++k) {
+      ArrayView<Real> vk = basis(k);
+      Real c = dot(vk, w);
+      for (Int32 i = 0; i < n; ++i)
+        w[i] -= c * vk[i];
+    }
+    Real b = std::sqrt(dot(w, w));
+
+    m_dimension = j + 1;
+    Real phi2_last = 0.0;
+    _computePhi(alpha, beta, tau, phi1_e1.subView(0, m_dimension), phi2_last);
+    Real y_norm = 0.0;
+    for (Int32 k = 0; k < m_dimension; ++k)
+      y_norm += phi1_e1[k] * phi1_e1[k];
+    y_norm = v_norm * std::sqrt(y_norm);
+    m_error_estimate = v_norm * tau * b * std::abs(phi2_last);
+    info(5) << "Krylov exponential dimension=" << m_dimension << " error_estimate=" << m_error_estimate
+            << " norm=" << y_norm;
+
+    if (m_error_estimate <= m_epsilon * y_norm) {
+      is_converged = true;
+      break;
+    }
+    if (j + 1 == m_max_dimension)
+      break;
+    beta.add(b);
+    ArrayView<Real> vn = basis(j + 1);
+    for (Int32 i = 0; i < n; ++i)
+      vn[i] = w[i] / b;
+  }
+
+  for (Int32 k = 0; k < m_dimension; ++k) {
+    ArrayView<Real> vk = basis(k);
+    Real c = v_norm * phi1_e1[k];
+    for (Int32 i = 0; i < n; ++i)
+      y[i] += c * vk[i];
+  }
+  return is_converged;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,112 @@
+﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* KrylovExponential.h                                         (C) 2022-2024 */
+/*                                                                           */
+/* Action of matrix exponential functions with the Lanczos method.           */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_KRYLOVEXPONENTIAL_H
+#define FEMTEST_KRYLOVEXPONENTIAL_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/TraceAccessor.h>
+
+#include <functional>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Action of phi_1(-tau S) on a vector for a symmetric matrix S.
+ *
+ * phi_1(z) = (exp(z) - 1) / z gives the exact solution of the linear system
+ * of ODEs u' = -S u + g over a time step tau:
+ *
+ *   u(t + tau) = u(t) + tau phi_1(-tau S) (g - S u(t))
+ *
+ * The Lanczos method builds an orthonormal basis V_m of the Krylov space of
+ * S and v and the tridiagonal matrix T_m = V_m^T S V_m. Then
+ * phi_1(-tau S) v ~ |v| V_m phi_1(-tau T_m) e_1, phi_1(-tau T_m) being
+ * computed from the eigenvalues of T_m. The basis is fully
+ * re-orthogonalized, so only a few tens of vectors are needed.
+ *
+ * The dimension grows until the error estimate
+ * |v| tau beta_m+1 |e_m^T phi_2(-tau T_m) e_1| is lower than epsilon() |y|.
+ *
+ * S is only used through its product by a vector. The dot product is given
+ * by the caller so that it can be reduced over the sub-domains.
+ */
+class KrylovExponential
+: public TraceAccessor
+{
+ public:
+
+  //! y = S x
+  using Operator = std::function<void(ConstArrayView<Real> x, ArrayView<Real> y)>;
+  //! Dot product of two vectors
+  using DotProduct = std::function<Real(ConstArrayView<Real> x, ConstArrayView<Real> y)>;
+
+ public:
+
+  explicit KrylovExponential(ITraceMng* tm);
+
+ public:
+
+  //! Maximum dimension of the Krylov space
+  void setMaxDimension(Int32 v) { m_max_dimension = v; }
+  Int32 maxDimension() const { return m_max_dimension; }
+  //! Relative tolerance of the error estimate
+  void setEpsilon(Real v) { m_epsilon = v; }
+  Real epsilon() const { return m_epsilon; }
+
+  /*!
+   * \brief Compute y = phi_1(-tau S) v.
+   *
+   * Returns false if the error estimate is still larger than the tolerance
+   * with maxDimension() vectors. \a y is then the approximation with
+   * maxDimension() vectors.
+   */
+  bool applyPhi1(const Operator& s, const DotProduct& dot, Real tau,
+                 ConstArrayView<Real> v, ArrayView<Real> y);
+
+  //! Dimension of the Krylov space of the last call to applyPhi1()
+  Int32 dimension() const { return m_dimension; }
+  //! Error estimate of the last call to applyPhi1()
+  Real errorEstimate() const { return m_error_estimate; }
+
+ private:
+
+  Int32 m_max_dimension = 30;
+  Real m_epsilon = 1.0e-8;
+  Int32 m_dimension = 0;
+  Real m_error_estimate = 0.0;
+  //! Vectors of the basis (maxDimension() vectors of size n)
+  UniqueArray<Real> m_basis;
+  UniqueArray<Real> m_w;
+
+ private:
+
+  void _computePhi(ConstArrayView<Real> alpha, ConstArrayView<Real> beta, Real tau,
+                   ArrayView<Real> phi1_e1, Real& phi2_last);
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
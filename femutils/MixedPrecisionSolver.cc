@@ -0,0 +1,220 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* MixedPrecisionSolver.cc                                     (C) 2022-2024 */
+/*                                                                           */
+/* Mixed precision conjugate gradient with iterative refinement.             */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "MixedPrecisionSolver.h"
+
+#include <arcane/utils/ITraceMng.h>
+
+#include <cmath>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+namespace
+{
+  Real _dot(ConstArrayView<Real> x, ConstArrayView<Real> y)
+  {
+    Real s = 0.0;
+    for (Int32 i = 0, n = x.size(); i < n; ++i)
+      s += x[i] * y[i];
+    return s;
+  }
+} // namespace
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Norm of \a r scaled by the inverse of the diagonal: |D^-1 r|.
+ *
+ * The penalty rows of the Dirichlet nodes are then not larger than the other
+ * ones, so that the tolerances apply to all the DoFs.
+ */
+Real MixedPrecisionSolver::
+_scaledNorm(ConstArrayView<Real> r) const
+{
+  Real s = 0.0;
+  for (Int32 i = 0; i < m_nb_row; ++i) {
+    Real z = static_cast<Real>(m_inv_diagonal[i]) * r[i];
+    s += z * z;
+  }
+  return std::sqrt(s);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+MixedPrecisionSolver::
+MixedPrecisionSolver(ITraceMng* tm)
+: TraceAccessor(tm)
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void MixedPrecisionSolver::
+_copyMatrix(const MatVec::Matrix& a)
+{
+  m_rows_index.copy(a.rowsIndex());
+  m_columns.copy(a.columns());
+  ConstArrayView<Real> values = a.values();
+  m_nb_row = m_rows_index.size() - 1;
+
+  m_values.resize(values.size());
+  for (Int32 k = 0, n = values.size(); k < n; ++k)
+    m_values[k] = static_cast<float>(values[k]);
+
+  m_inv_diagonal.resize(m_nb_row);
+  for (Int32 i = 0; i < m_nb_row; ++i) {
+    m_inv_diagonal[i] = 1.0f;
+    for (Int32 k = m_rows_index[i]; k < m_rows_index[i + 1]; ++k)
+      if (m_columns[k] == i && values[k] != 0.0)
+        m_inv_diagonal[i] = static_cast<float>(1.0 / values[k]);
+  }
+
+  m_correction.resize(m_nb_row);
+  m_residual.resize(m_nb_row);
+  m_z.resize(m_nb_row);
+  m_p.resize(m_nb_row);
+  m_q.resize(m_nb_row);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief y = A_f x with the single precision values.
+ */
+void MixedPrecisionSolver::
+_multiply(ConstArrayView<Real> x, ArrayView<Real> y) const
+{
+  const Int32* rows_index = m_rows_index.data();
+  const Int32* columns = m_columns.data();
+  const float* values = m_values.data();
+  for (Int32 i = 0; i < m_nb_row; ++i) {
+    Real s = 0.0;
+    for (Int32 k = rows_index[i]; k < rows_index[i + 1]; ++k)
+      s += static_cast<Real>(values[k]) * x[columns[k]];
+    y[i] = s;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Jacobi preconditioned conjugate gradient on A_f x = r.
+ *
+ * \a x must be zero on entry and \a r is overwritten by the residual.
+ * Returns the number of iterations.
+ */
+Int32 MixedPrecisionSolver::
+_solveSinglePrecision(ArrayView<Real> r, ArrayView<Real> x, Int32 max_iteration)
+{
+  ArrayView<Real> z = m_z;
+  ArrayView<Real> p = m_p;
+  ArrayView<Real> q = m_q;
+
+  for (Int32 i = 0; i < m_nb_row; ++i) {
+    z[i] = m_inv_diagonal[i] * r[i];
+    p[i] = z[i];
+  }
+  Real rz = _dot(r, z);
+  Real tolerance2 = m_inner_epsilon * m_inner_epsilon * _dot(z, z);
+  if (tolerance2 == 0.0)
+    return 0;
+
+  Int32 iteration = 0;
+  while (iteration < max_iteration) {
+    ++iteration;
+    _multiply(p, q);
+    Real alpha = rz / _dot(p, q);
+    for (Int32 i = 0; i < m_nb_row; ++i) {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * q[i];
+    }
+    for (Int32 i = 0; i < m_nb_row; ++i)
+      z[i] = m_inv_diagonal[i] * r[i];
+    if (_dot(z, z) <= tolerance2)
+      break;
+    Real rz_new = _dot(r, z);
+    Real beta = rz_new / rz;
+    rz = rz_new;
+    for (Int32 i = 0; i < m_nb_row; ++i)
+      p[i] = z[i] + beta * p[i];
+  }
+  return iteration;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void MixedPrecisionSolver::
+solve(const MatVec::Matrix& a, const MatVec::Vector& b, MatVec::Vector& x)
+{
+  _copyMatrix(a);
+  m_nb_outer_iteration = 0;
+  m_nb_iteration = 0;
+
+  ConstArrayView<Real> b_values = b.values();
+  ArrayView<Real> x_values = x.values();
+  ConstArrayView<Int32> rows_index = a.rowsIndex();
+  ConstArrayView<Int32> columns = a.columns();
+  ConstArrayView<Real> values = a.values();
+
+  Real norm_b = _scaledNorm(b_values);
+  if (norm_b == 0.0) {
+    x_values.fill(0.0);
+    m_residual_norm = 0.0;
+    return;
+  }
+
+  const Int32 max_outer_iteration = 100;
+  Real previous_residual_norm = 0.0;
+  for (;;) {
+    // Residual in double precision
+    for (Int32 i = 0; i < m_nb_row; ++i) {
+      Real s = b_values[i];
+      for (Int32 k = rows_index[i]; k < rows_index[i + 1]; ++k)
+        s -= values[k] * x_values[columns[k]];
+      m_residual[i] = s;
+    }
+    m_residual_norm = _scaledNorm(m_residual) / norm_b;
+    info(4) << "MixedPrecision outer_iteration=" << m_nb_outer_iteration
+            << " relative_residual=" << m_residual_norm;
+
+    if (m_residual_norm <= m_epsilon)
+      break;
+    // The refinement stops at the accuracy of the double precision residual
+    if (m_nb_outer_iteration > 0 && m_residual_norm >= 0.5 * previous_residual_norm)
+      break;
+    if (m_nb_outer_iteration >= max_outer_iteration || m_nb_iteration >= m_max_iteration)
+      break;
+    previous_residual_norm = m_residual_norm;
+
+    m_correction.fill(0.0);
+    m_nb_iteration += _solveSinglePrecision(m_residual, m_correction, m_max_iteration - m_nb_iteration);
+    for (Int32 i = 0; i < m_nb_row; ++i)
+      x_values[i] += m_correction[i];
+    ++m_nb_outer_iteration;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,112 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* MixedPrecisionSolver.h                                      (C) 2022-2024 */
+/*                                                                           */
+/* Mixed precision conjugate gradient with iterative refinement.             */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_MIXEDPRECISIONSOLVER_H
+#define FEMTEST_MIXEDPRECISIONSOLVER_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/TraceAccessor.h>
+#include <arcane/matvec/Matrix.h>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Mixed precision solver for symmetric positive definite matrices.
+ *
+ * The iterative solves are bound by the memory bandwidth of the sparse
+ * matrix-vector product. This solver keeps a copy of the values of the
+ * matrix (and of its inverse diagonal) in single precision, so that a product
+ * reads 8 bytes per non-zero (float value + Int32 column) instead of 12.
+ * The vectors stay in double precision.
+ *
+ * The full accuracy is recovered by an iterative refinement in double:
+ * - r = b - A x with the double precision matrix,
+ * - solve A_f d = r with a Jacobi preconditioned conjugate gradient using
+ *   the single precision matrix A_f, up to a relative residual
+ *   innerEpsilon(),
+ * - x = x + d,
+ * until |r| <= epsilon() |b| or until the residual does not decrease anymore.
+ * The norms are scaled by the inverse of the diagonal (|D^-1 r|) so that the
+ * penalty rows of the Dirichlet nodes do not hide the other ones.
+ */
+class MixedPrecisionSolver
+: public TraceAccessor
+{
+ public:
+
+  explicit MixedPrecisionSolver(ITraceMng* tm);
+
+ public:
+
+  //! Relative tolerance of the residual of the outer (double) iterations
+  void setEpsilon(Real v) { m_epsilon = v; }
+  Real epsilon() const { return m_epsilon; }
+  //! Relative tolerance of the inner (single precision matrix) solves
+  void setInnerEpsilon(Real v) { m_inner_epsilon = v; }
+  Real innerEpsilon() const { return m_inner_epsilon; }
+  void setMaxIteration(Int32 v) { m_max_iteration = v; }
+
+  //! Solve a.x = b. \a x is used as initial guess.
+  void solve(const MatVec::Matrix& a, const MatVec::Vector& b, MatVec::Vector& x);
+
+  Int32 nbOuterIteration() const { return m_nb_outer_iteration; }
+  Int32 nbIteration() const { return m_nb_iteration; }
+  //! Relative residual |b - A x| / |b| (scaled norms) of the solution in double precision
+  Real residualNorm() const { return m_residual_norm; }
+
+ private:
+
+  Real m_epsilon = 1.0e-15;
+  Real m_inner_epsilon = 1.0e-4;
+  Int32 m_max_iteration = 10000;
+
+  Int32 m_nb_outer_iteration = 0;
+  Int32 m_nb_iteration = 0;
+  Real m_residual_norm = 0.0;
+
+  Int32 m_nb_row = 0;
+  UniqueArray<Int32> m_rows_index;
+  UniqueArray<Int32> m_columns;
+  UniqueArray<float> m_values;
+  UniqueArray<float> m_inv_diagonal;
+
+  //! Work vectors
+  UniqueArray<Real> m_correction;
+  UniqueArray<Real> m_residual;
+  UniqueArray<Real> m_z;
+  UniqueArray<Real> m_p;
+  UniqueArray<Real> m_q;
+
+ private:
+
+  void _copyMatrix(const MatVec::Matrix& a);
+  void _multiply(ConstArrayView<Real> x, ArrayView<Real> y) const;
+  Real _scaledNorm(ConstArrayView<Real> r) const;
+  Int32 _solveSinglePrecision(ArrayView<Real> r, ArrayView<Real> x, Int32 max_iteration);
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,453 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* PMultigridPreconditioner.cc                                 (C) 2022-2024 */
+/*                                                                           */
+/* Two-level p-multigrid preconditioner for high order elements.             */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "PMultigridPreconditioner.h"
+
+#include <arcane/utils/FatalErrorException.h>
+#include <arcane/utils/ITraceMng.h>
+#include <arcane/matvec/AMG.h>
+
+#include "DoFLinearSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+PMultigridPreconditioner::
+PMultigridPreconditioner(ITraceMng* tm)
+: TraceAccessor(tm)
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+PMultigridPreconditioner::
+~PMultigridPreconditioner()
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void PMultigridPreconditioner::
+setProlongation(const CSRFormatView& p, Int32 nb_coarse_row)
+{
+  Span<const Int32> rows = p.rows();
+  Span<const Int32> rows_nb_column = p.rowsNbColumn();
+  Span<const Int32> columns = p.columns();
+  Span<const Real> values = p.values();
+
+  Int32 nb_row = static_cast<Int32>(rows.size());
+  m_p_rows_index.resize(nb_row + 1);
+  m_p_columns.clear();
+  m_p_values.clear();
+  m_p_rows_index[0] = 0;
+  for (Int32 i = 0; i < nb_row; ++i) {
+    Int32 first = rows[i];
+    for (Int32 k = 0; k < rows_nb_column[i]; ++k) {
+      Int32 c = columns[first + k];
+      if (c < 0 || c >= nb_coarse_row)
+        ARCANE_FATAL("Bad coarse column '{0}' for row '{1}' (nb_coarse_row={2})", c, i, nb_coarse_row);
+      m_p_columns.add(c);
+      m_p_values.add(values[first + k]);
+    }
+    m_p_rows_index[i + 1] = m_p_columns.size();
+  }
+  m_nb_coarse_row = nb_coarse_row;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void PMultigridPreconditioner::
+build(const MatVec::Matrix& a)
+{
+  if (!hasProlongation())
+    ARCANE_FATAL("The prolongation has not been set. Call setProlongation() before build()");
+
+  m_a_rows_index.copy(a.rowsIndex());
+  m_a_columns.copy(a.columns());
+  m_a_values.copy(a.values());
+  m_nb_row = m_a_rows_index.size() - 1;
+  if (m_nb_row != (m_p_rows_index.size() - 1))
+    ARCANE_FATAL("Bad number of rows for the prolongation n={0} expected={1}",
+                 m_p_rows_index.size() - 1, m_nb_row);
+
+  m_inv_diagonal.resize(m_nb_row);
+  m_inv_diagonal.fill(0.0);
+  for (Int32 i = 0; i < m_nb_row; ++i) {
+    for (Int32 k = m_a_rows_index[i]; k < m_a_rows_index[i + 1]; ++k)
+      if (m_a_columns[k] == i && m_a_values[k] != 0.0)
+        m_inv_diagonal[i] = 1.0 / m_a_values[k];
+  }
+
+  m_residual.resize(m_nb_row);
+  m_direction.resize(m_nb_row);
+  m_c_residual.resize(m_nb_coarse_row);
+  m_c_solution.resize(m_nb_coarse_row);
+
+  _estimateMaxEigenValue();
+  _buildCoarseMatrix();
+
+  if (m_coarse_solver == ePMultigridCoarseSolver::Direct) {
+    _factorizeCoarseMatrix();
+  }
+  else {
+    UniqueArray<Int32> rows_size(m_nb_coarse_row);
+    for (Int32 i = 0; i < m_nb_coarse_row; ++i)
+      rows_size[i] = m_c_rows_index[i + 1] - m_c_rows_index[i];
+    m_c_matrix = std::make_unique<MatVec::Matrix>(m_nb_coarse_row, m_nb_coarse_row);
+    m_c_matrix->setRowsSize(rows_size);
+    m_c_matrix->setValues(m_c_columns, m_c_values);
+    m_c_amg = std::make_unique<MatVec::AMGPreconditioner>(traceMng());
+    m_c_amg->build(*m_c_matrix);
+    m_c_amg_rhs = std::make_unique<MatVec::Vector>(m_nb_coarse_row);
+    m_c_amg_solution = std::make_unique<MatVec::Vector>(m_nb_coarse_row);
+  }
+
+  info() << "[PMultigrid] nb_fine_row=" << m_nb_row << " nb_coarse_row=" << m_nb_coarse_row
+         << " coarse_nnz=" << m_c_values.size() << " lambda_max(D^-1 A)=" << m_lambda_max
+         << " smoother=" << (m_smoother == ePMultigridSmoother::Chebyshev ? "chebyshev" : "jacobi")
+         << " nb_step=" << m_nb_smoothing_step
+         << " coarse_solver=" << (m_coarse_solver == ePMultigridCoarseSolver::Direct ? "direct" : "amg");
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void PMultigridPreconditioner::
+apply(MatVec::Vector& out, const MatVec::Vector& in)
+{
+  ConstArrayView<Real> b = in.values();
+  ArrayView<Real> x = out.values();
+  x.fill(0.0);
+
+  _smooth(b, x);
+
+  // Restriction of the residual: r_c = P^T (b - A x)
+  _computeResidual(b, x, m_residual);
+  m_c_residual.fill(0.0);
+  for (Int32 i = 0; i < m_nb_row; ++i)
+    for (Int32 k = m_p_rows_index[i]; k < m_p_rows_index[i + 1]; ++k)
+      m_c_residual[m_p_columns[k]] += m_p_values[k] * m_residual[i];
+
+  _solveCoarse();
+
+  // Prolongation of the correction: x += P x_c
+  for (Int32 i = 0; i < m_nb_row; ++i)
+    for (Int32 k = m_p_rows_index[i]; k < m_p_rows_index[i + 1]; ++k)
+      x[i] += m_p_values[k] * m_c_solution[m_p_columns[k]];
+
+  _smooth(b, x);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void PMultigridPreconditioner::
+_multiply(ConstArrayView<Real> x, ArrayView<Real> y) const
+{
+  for (Int32 i = 0; i < m_nb_row; ++i) {
+    Real v = 0.0;
+    for (Int32 k = m_a_rows_index[i]; k < m_a_rows_index[i + 1]; ++k)
+      v += m_a_values[k] * x[m_a_columns[k]];
+    y[i] = v;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void PMultigridPreconditioner::
+_computeResidual(ConstArrayView<Real> b, ConstArrayView<Real> x, ArrayView<Real> r) const
+{
+  _multiply(x, r);
+  for (Int32 i = 0; i < m_nb_row; ++i)
+    r[i] = b[i] - r[i];
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Estimate the largest eigenvalue of D^-1 A by power iterations.
+ *
+ * The estimate only has to be close: the interval of the Chebyshev
+ * smoother is enlarged by 10% and the Jacobi smoother is damped.
+ */
+void PMultigridPreconditioner::
+_estimateMaxEigenValue()
+{
+  const Int32 nb_iteration = 20;
+  ArrayView<Real> v = m_direction;
+  ArrayView<Real> w = m_residual;
+
+  // Deterministic start vector which is not an eigenvector of usual matrices
+  Real norm = 0.0;
+  for (Int32 i = 0; i < m_nb_row; ++i) {
+    v[i] = 1.0 + static_cast<Real>((7 * i) % 11) / 11.0;
+    norm += v[i] * v[i];
+  }
+  norm = std::sqrt(norm);
+
+  Real lambda = 0.0;
+  for (Int32 iter = 0; iter < nb_iteration && norm > 0.0; ++iter) {
+    for (Int32 i = 0; i < m_nb_row; ++i)
+      v[i] /= norm;
+    _multiply(v, w);
+    Real w_norm = 0.0;
+    for (Int32 i = 0; i < m_nb_row; ++i) {
+      w[i] *= m_inv_diagonal[i];
+      w_norm += w[i] * w[i];
+    }
+    norm = std::sqrt(w_norm);
+    lambda = norm;
+    v.copy(w);
+  }
+  m_lambda_max = (lambda > 0.0) ? lambda : 1.0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Smooth the error of \a x for A x = b.
+ *
+ * Chebyshev iterations preconditioned by the diagonal (Saad, Iterative
+ * Methods for Sparse Linear Systems, algorithm 12.1) or damped Jacobi
+ * iterations with a damping of 4 / (3 lambda_max).
+ */
+void PMultigridPreconditioner::
+_smooth(ConstArrayView<Real> b, ArrayView<Real> x)
+{
+  ArrayView<Real> r = m_residual;
+  ArrayView<Real> d = m_direction;
+  const Int32 nb_step = m_nb_smoothing_step;
+
+  if (m_smoother == ePMultigridSmoother::Jacobi) {
+    const Real omega = 4.0 / (3.0 * m_lambda_max);
+    for (Int32 s = 0; s < nb_step; ++s) {
+      _computeResidual(b, x, r);
+      for (Int32 i = 0; i < m_nb_row; ++i)
+        x[i] += omega * m_inv_diagonal[i] * r[i];
+    }
+    return;
+  }
+
+  const Real lambda_max = 1.1 * m_lambda_max;
+  const Real lambda_min = 0.1 * m_lambda_max;
+  const Real theta = 0.5 * (lambda_max + lambda_min);
+  const Real delta = 0.5 * (lambda_max - lambda_min);
+  const Real sigma = theta / delta;
+  Real rho = 1.0 / sigma;
+
+  _computeResidual(b, x, r);
+  for (Int32 i = 0; i < m_nb_row; ++i)
+    d[i] = m_inv_diagonal[i] * r[i] / theta;
+
+  for (Int32 s = 0; s < nb_step; ++s) {
+    for (Int32 i = 0; i < m_nb_row; ++i)
+      x[i] += d[i];
+    if (s == (nb_step - 1))
+      break;
+    // r -= A d
+    for (Int32 i = 0; i < m_nb_row; ++i) {
+      Real v = 0.0;
+      for (Int32 k = m_a_rows_index[i]; k < m_a_rows_index[i + 1]; ++k)
+        v += m_a_values[k] * d[m_a_columns[k]];
+      r[i] -= v;
+    }
+    Real rho_new = 1.0 / (2.0 * sigma - rho);
+    for (Int32 i = 0; i < m_nb_row; ++i)
+      d[i] = rho_new * rho * d[i] + 2.0 * rho_new / delta * m_inv_diagonal[i] * r[i];
+    rho = rho_new;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Compute the Galerkin coarse matrix A_c = P^T A P.
+ *
+ * Row I of A_c is the sum over the fine rows i with P(i,I) != 0 of
+ * P(i,I) * A(i,k) * P(k,J). The columns of each row are sorted.
+ */
+void PMultigridPreconditioner::
+_buildCoarseMatrix()
+{
+  const Int32 nb_coarse = m_nb_coarse_row;
+
+  // Transpose of P
+  UniqueArray<Int32> pt_rows_index(nb_coarse + 1);
+  pt_rows_index.fill(0);
+  for (Int32 c : m_p_columns)
+    ++pt_rows_index[c + 1];
+  for (Int32 c = 0; c < nb_coarse; ++c)
+    pt_rows_index[c + 1] += pt_rows_index[c];
+  UniqueArray<Int32> pt_columns(m_p_columns.size());
+  UniqueArray<Real> pt_values(m_p_columns.size());
+  {
+    UniqueArray<Int32> fill_index(pt_rows_index.subConstView(0, nb_coarse));
+    for (Int32 i = 0; i < m_nb_row; ++i)
+      for (Int32 k = m_p_rows_index[i]; k < m_p_rows_index[i + 1]; ++k) {
+        Int32 pos = fill_index[m_p_columns[k]]++;
+        pt_columns[pos] = i;
+        pt_values[pos] = m_p_values[k];
+      }
+  }
+
+  m_c_rows_index.resize(nb_coarse + 1);
+  m_c_columns.clear();
+  m_c_values.clear();
+  m_c_rows_index[0] = 0;
+
+  UniqueArray<Real> row_values(nb_coarse);
+  row_values.fill(0.0);
+  UniqueArray<Int32> row_marker(nb_coarse);
+  row_marker.fill(-1);
+  UniqueArray<Int32> row_columns;
+
+  for (Int32 c = 0; c < nb_coarse; ++c) {
+    row_columns.clear();
+    for (Int32 kt = pt_rows_index[c]; kt < pt_rows_index[c + 1]; ++kt) {
+      Int32 i = pt_columns[kt];
+      Real p_ic = pt_values[kt];
+      for (Int32 ka = m_a_rows_index[i]; ka < m_a_rows_index[i + 1]; ++ka) {
+        Int32 k = m_a_columns[ka];
+        Real v = p_ic * m_a_values[ka];
+        for (Int32 kp = m_p_rows_index[k]; kp < m_p_rows_index[k + 1]; ++kp) {
+          Int32 c2 = m_p_columns[kp];
+          if (row_marker[c2] != c) {
+            row_marker[c2] = c;
+            row_values[c2] = 0.0;
+            row_columns.add(c2);
+          }
+          row_values[c2] += v * m_p_values[kp];
+        }
+      }
+    }
+    std::sort(row_columns.begin(), row_columns.end());
+    for (Int32 c2 : row_columns) {
+      m_c_columns.add(c2);
+      m_c_values.add(row_values[c2]);
+    }
+    m_c_rows_index[c + 1] = m_c_columns.size();
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Dense LU factorization with partial pivoting of the coarse matrix.
+ *
+ * The coarse level only has the vertex DoFs so that it is much smaller
+ * than the fine level. Use the AMG coarse solver for large meshes.
+ */
+void PMultigridPreconditioner::
+_factorizeCoarseMatrix()
+{
+  const Int32 n = m_nb_coarse_row;
+  m_c_lu.resize(static_cast<Int64>(n) * n);
+  m_c_lu.fill(0.0);
+  m_c_pivot.resize(n);
+  for (Int32 i = 0; i < n; ++i)
+    for (Int32 k = m_c_rows_index[i]; k < m_c_rows_index[i + 1]; ++k)
+      m_c_lu[static_cast<Int64>(i) * n + m_c_columns[k]] = m_c_values[k];
+
+  Real* lu = m_c_lu.data();
+  for (Int32 j = 0; j < n; ++j) {
+    Int32 pivot = j;
+    Real pivot_value = std::abs(lu[static_cast<Int64>(j) * n + j]);
+    for (Int32 i = j + 1; i < n; ++i) {
+      Real v = std::abs(lu[static_cast<Int64>(i) * n + j]);
+      if (v > pivot_value) {
+        pivot = i;
+        pivot_value = v;
+      }
+    }
+    if (pivot_value == 0.0)
+      ARCANE_FATAL("Singular coarse matrix (column {0})", j);
+    m_c_pivot[j] = pivot;
+    if (pivot != j)
+      for (Int32 k = 0; k < n; ++k)
+        std::swap(lu[static_cast<Int64>(j) * n + k], lu[static_cast<Int64>(pivot) * n + k]);
+    Real* row_j = lu + static_cast<Int64>(j) * n;
+    for (Int32 i = j + 1; i < n; ++i) {
+      Real* row_i = lu + static_cast<Int64>(i) * n;
+      if (row_i[j] == 0.0)
+        continue;
+      row_i[j] /= row_j[j];
+      Real l = row_i[j];
+      for (Int32 k = j + 1; k < n; ++k)
+        row_i[k] -= l * row_j[k];
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void PMultigridPreconditioner::
+_solveCoarse()
+{
+  const Int32 n = m_nb_coarse_row;
+
+  if (m_coarse_solver == ePMultigridCoarseSolver::AMG) {
+    ArrayView<Real> rhs = m_c_amg_rhs->values();
+    for (Int32 i = 0; i < n; ++i)
+      rhs[i] = m_c_residual[i];
+    m_c_amg->apply(*m_c_amg_solution, *m_c_amg_rhs);
+    ConstArrayView<Real> x = m_c_amg_solution->values();
+    for (Int32 i = 0; i < n; ++i)
+      m_c_solution[i] = x[i];
+    return;
+  }
+
+  const Real* lu = m_c_lu.data();
+  ArrayView<Real> x = m_c_solution;
+  x.copy(m_c_residual);
+  for (Int32 j = 0; j < n; ++j)
+    if (m_c_pivot[j] != j)
+      std::swap(x[j], x[m_c_pivot[j]]);
+  // L y = b (unit diagonal)
+  for (Int32 i = 0; i < n; ++i) {
+    const Real* row_i = lu + static_cast<Int64>(i) * n;
+    Real v = x[i];
+    for (Int32 k = 0; k < i; ++k)
+      v -= row_i[k] * x[k];
+    x[i] = v;
+  }
+  // U x = y
+  for (Int32 i = n - 1; i >= 0; --i) {
+    const Real* row_i = lu + static_cast<Int64>(i) * n;
+    Real v = x[i];
+    for (Int32 k = i + 1; k < n; ++k)
+      v -= row_i[k] * x[k];
+    x[i] = v / row_i[i];
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
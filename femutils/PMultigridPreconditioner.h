@@ -0,0 +1,173 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* PMultigridPreconditioner.h                                  (C) 2022-2024 */
+/*                                                                           */
+/* Two-level p-multigrid preconditioner for high order elements.             */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_PMULTIGRIDPRECONDITIONER_H
+#define FEMTEST_PMULTIGRIDPRECONDITIONER_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/TraceAccessor.h>
+#include <arcane/matvec/Matrix.h>
+
+#include <memory>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::MatVec
+{
+class AMGPreconditioner;
+}
+
+namespace Arcane::FemUtils
+{
+class CSRFormatView;
+
+//! Smoother of the fine level of the p-multigrid preconditioner
+enum class ePMultigridSmoother
+{
+  Chebyshev,
+  Jacobi
+};
+
+//! Solver of the coarse level of the p-multigrid preconditioner
+enum class ePMultigridCoarseSolver
+{
+  Direct,
+  AMG
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Two-level p-multigrid preconditioner.
+ *
+ * The fine level is the linear system of a high order discretization
+ * (Tri6, Quad8, Tetra10...) and the coarse level is the linear system of the
+ * linear discretization (Tri3, Quad4, Tetra4...) on the vertices of the same
+ * mesh. The prolongation P interpolates the fine DoFs from the coarse DoFs
+ * with the linear shape functions: a vertex DoF is copied and a mid-node
+ * DoF is the mean of the DoFs of the vertices of its edge. It is given by
+ * the caller with setProlongation() since it depends on the discretization.
+ *
+ * The coarse matrix is the Galerkin product A_c = P^T A P. One application
+ * of the preconditioner is a symmetric V-cycle, so that it can be used with
+ * the conjugate gradient:
+ * - pre-smoothing on the fine level (Chebyshev or Jacobi, using the
+ *   diagonal of A),
+ * - restriction of the residual with P^T,
+ * - solve on the coarse level (LU factorization or AMG),
+ * - prolongation of the correction with P,
+ * - post-smoothing with the same smoother.
+ *
+ * The Chebyshev smoother damps the eigenvalues of D^-1 A in the interval
+ * [0.1 lambda_max, 1.1 lambda_max] where lambda_max is estimated by power
+ * iterations in build().
+ */
+class PMultigridPreconditioner
+: public TraceAccessor
+, public MatVec::IPreconditioner
+{
+ public:
+
+  explicit PMultigridPreconditioner(ITraceMng* tm);
+  ~PMultigridPreconditioner() override;
+
+ public:
+
+  PMultigridPreconditioner(const PMultigridPreconditioner&) = delete;
+  PMultigridPreconditioner& operator=(const PMultigridPreconditioner&) = delete;
+
+ public:
+
+  /*!
+   * \brief Set the prolongation P.
+   *
+   * Row \a i of \a p gives the weights of the coarse DoFs used to
+   * interpolate the fine DoF \a i. The columns are in [0, nb_coarse_row[.
+   * The values are copied.
+   */
+  void setProlongation(const CSRFormatView& p, Int32 nb_coarse_row);
+  bool hasProlongation() const { return m_nb_coarse_row > 0; }
+
+  void setSmoother(ePMultigridSmoother v) { m_smoother = v; }
+  //! Degree of the Chebyshev polynomial or number of Jacobi sweeps
+  void setNbSmoothingStep(Int32 v) { m_nb_smoothing_step = v; }
+  void setCoarseSolver(ePMultigridCoarseSolver v) { m_coarse_solver = v; }
+
+  //! Build the coarse level for the matrix \a a
+  void build(const MatVec::Matrix& a);
+
+  void apply(MatVec::Vector& out, const MatVec::Vector& in) override;
+
+  Int32 nbCoarseRow() const { return m_nb_coarse_row; }
+  Real maxEigenValue() const { return m_lambda_max; }
+
+ private:
+
+  Int32 m_nb_row = 0;
+  Int32 m_nb_coarse_row = 0;
+
+  ePMultigridSmoother m_smoother = ePMultigridSmoother::Chebyshev;
+  Int32 m_nb_smoothing_step = 2;
+  ePMultigridCoarseSolver m_coarse_solver = ePMultigridCoarseSolver::Direct;
+
+  //! Fine matrix (CSR)
+  UniqueArray<Int32> m_a_rows_index;
+  UniqueArray<Int32> m_a_columns;
+  UniqueArray<Real> m_a_values;
+  UniqueArray<Real> m_inv_diagonal;
+  Real m_lambda_max = 1.0;
+
+  //! Prolongation (CSR)
+  UniqueArray<Int32> m_p_rows_index;
+  UniqueArray<Int32> m_p_columns;
+  UniqueArray<Real> m_p_values;
+
+  //! Coarse matrix (CSR) and its dense LU factorization
+  UniqueArray<Int32> m_c_rows_index;
+  UniqueArray<Int32> m_c_columns;
+  UniqueArray<Real> m_c_values;
+  UniqueArray<Real> m_c_lu;
+  UniqueArray<Int32> m_c_pivot;
+
+  std::unique_ptr<MatVec::Matrix> m_c_matrix;
+  std::unique_ptr<MatVec::AMGPreconditioner> m_c_amg;
+  std::unique_ptr<MatVec::Vector> m_c_amg_rhs;
+  std::unique_ptr<MatVec::Vector> m_c_amg_solution;
+
+  //! Work vectors
+  UniqueArray<Real> m_residual;
+  UniqueArray<Real> m_direction;
+  UniqueArray<Real> m_c_residual;
+  UniqueArray<Real> m_c_solution;
+
+ private:
+
+  void _multiply(ConstArrayView<Real> x, ArrayView<Real> y) const;
+  void _computeResidual(ConstArrayView<Real> b, ConstArrayView<Real> x, ArrayView<Real> r) const;
+  void _estimateMaxEigenValue();
+  void _smooth(ConstArrayView<Real> b, ArrayView<Real> x);
+  void _buildCoarseMatrix();
+  void _factorizeCoarseMatrix();
+  void _solveCoarse();
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
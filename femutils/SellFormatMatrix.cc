@@ -0,0 +1,350 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* SellFormatMatrix.cc                                         (C) 2022-2024 */
+/*                                                                           */
+/* Sliced ELLPACK (SELL-C-sigma) matrix for vectorized products.             */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include "SellFormatMatrix.h"
+
+#include <arcane/utils/FatalErrorException.h>
+#include <arcane/utils/ITraceMng.h>
+
+#include "CsrFormatMatrix.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FEMUTILS_SELL_HAS_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+
+namespace
+{
+  constexpr Int32 C = SellFormat::ChunkSize;
+  static_assert(C == 8, "The AVX2 and AVX-512 kernels process chunks of 8 rows");
+
+  // The kernels compute the 8 rows of a chunk and write them back with the
+  // permutation. 'values' and 'columns' point on the first entry of the chunk.
+
+  void _writeChunk(const Real* acc, const Int32* permutation, Real* y)
+  {
+    for (Int32 l = 0; l < C; ++l) {
+      Int32 row = permutation[l];
+      if (row >= 0)
+        y[row] = acc[l];
+    }
+  }
+
+  void _multiplyScalar(Int32 nb_chunk, const Int64* chunk_offset, const Int32* chunk_width,
+                       const Int32* permutation, const Int32* columns, const Real* values,
+                       const Real* x, Real* y)
+  {
+    for (Int32 c = 0; c < nb_chunk; ++c) {
+      Real acc[C] = {};
+      const Int32* col = columns + chunk_offset[c];
+      const Real* val = values + chunk_offset[c];
+      for (Int32 j = 0, w = chunk_width[c]; j < w; ++j, col += C, val += C)
+        for (Int32 l = 0; l < C; ++l)
+          acc[l] += val[l] * x[col[l]];
+      _writeChunk(acc, permutation + c * C, y);
+    }
+  }
+
+#ifdef FEMUTILS_SELL_HAS_X86_KERNELS
+  __attribute__((target("avx2,fma"))) void
+  _multiplyAVX2(Int32 nb_chunk, const Int64* chunk_offset, const Int32* chunk_width,
+                const Int32* permutation, const Int32* columns, const Real* values,
+                const Real* x, Real* y)
+  {
+    for (Int32 c = 0; c < nb_chunk; ++c) {
+      __m256d acc0 = _mm256_setzero_pd();
+      __m256d acc1 = _mm256_setzero_pd();
+      const Int32* col = columns + chunk_offset[c];
+      const Real* val = values + chunk_offset[c];
+      for (Int32 j = 0, w = chunk_width[c]; j < w; ++j, col += C, val += C) {
+        __m128i idx0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(col));
+        __m128i idx1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(col + 4));
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(val), _mm256_i32gather_pd(x, idx0, 8), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(val + 4), _mm256_i32gather_pd(x, idx1, 8), acc1);
+      }
+      alignas(64) Real acc[C];
+      _mm256_store_pd(acc, acc0);
+      _mm256_store_pd(acc + 4, acc1);
+      _writeChunk(acc, permutation + c * C, y);
+    }
+  }
+
+  __attribute__((target("avx512f"))) void
+  _multiplyAVX512(Int32 nb_chunk, const Int64* chunk_offset, const Int32* chunk_width,
+                  const Int32* permutation, const Int32* columns, const Real* values,
+                  const Real* x, Real* y)
+  {
+    for (Int32 c = 0; c < nb_chunk; ++c) {
+      __m512d acc0 = _mm512_setzero_pd();
+      const Int32* col = columns + chunk_offset[c];
+      const Real* val = values + chunk_offset[c];
+      for (Int32 j = 0, w = chunk_width[c]; j < w; ++j, col += C, val += C) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col));
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(val), _mm512_i32gather_pd(idx, x, 8), acc0);
+      }
+      alignas(64) Real acc[C];
+      _mm512_store_pd(acc, acc0);
+      _writeChunk(acc, permutation + c * C, y);
+    }
+  }
+#endif
+
+  void _multiplyCsr(Int32 nb_row, const Int32* rows_index, const Int32* columns, const Real* values,
+                    const Real* x, Real* y)
+  {
+    for (Int32 i = 0; i < nb_row; ++i) {
+      Real s = 0.0;
+      for (Int32 k = rows_index[i]; k < rows_index[i + 1]; ++k)
+        s += values[k] * x[columns[k]];
+      y[i] = s;
+    }
+  }
+} // namespace
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+SellFormat::
+SellFormat(ITraceMng* tm)
+: TraceAccessor(tm)
+, m_kernel(bestKernel())
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+eSellKernel SellFormat::
+bestKernel()
+{
+#ifdef FEMUTILS_SELL_HAS_X86_KERNELS
+  if (__builtin_cpu_supports("avx512f"))
+    return eSellKernel::AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return eSellKernel::AVX2;
+#endif
+  return eSellKernel::Scalar;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+const char* SellFormat::
+kernelName(eSellKernel v)
+{
+  switch (v) {
+  case eSellKernel::Scalar:
+    return "Scalar";
+  case eSellKernel::AVX2:
+    return "AVX2";
+  case eSellKernel::AVX512:
+    return "AVX512";
+  }
+  return "Unknown";
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void SellFormat::
+initialize(Int32 nb_row, ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+           ConstArrayView<Real> values, Int32 sigma)
+{
+  m_nb_row = nb_row;
+  m_nb_chunk = (nb_row + C - 1) / C;
+  m_nnz = rows_index[nb_row] - rows_index[0];
+  // The windows contain whole chunks
+  sigma = math::max(C, ((sigma + C - 1) / C) * C);
+
+  // Sort the rows by decreasing length inside each window of sigma rows
+  m_row_permutation.resize(m_nb_chunk * C);
+  m_row_permutation.fill(-1);
+  std::iota(m_row_permutation.begin(), m_row_permutation.begin() + nb_row, 0);
+  auto row_length = [&](Int32 row) { return rows_index[row + 1] - rows_index[row]; };
+  for (Int32 begin = 0; begin < nb_row; begin += sigma) {
+    Int32 end = math::min(begin + sigma, nb_row);
+    std::stable_sort(m_row_permutation.begin() + begin, m_row_permutation.begin() + end,
+                     [&](Int32 a, Int32 b) { return row_length(a) > row_length(b); });
+  }
+
+  // Width and offset of the chunks
+  m_chunk_width.resize(m_nb_chunk);
+  m_chunk_offset.resize(m_nb_chunk + 1);
+  m_chunk_offset[0] = 0;
+  for (Int32 c = 0; c < m_nb_chunk; ++c) {
+    Int32 width = 0;
+    for (Int32 l = 0; l < C; ++l) {
+      Int32 row = m_row_permutation[c * C + l];
+      if (row >= 0)
+        width = math::max(width, row_length(row));
+    }
+    m_chunk_width[c] = width;
+    m_chunk_offset[c + 1] = m_chunk_offset[c] + Int64(width) * C;
+  }
+
+  // Entries stored column by column inside a chunk. The padding entries
+  // have a zero value and the column of their row (or 0) to stay in x.
+  Int64 nb_stored = m_chunk_offset[m_nb_chunk];
+  m_columns.resize(nb_stored);
+  m_values.resize(nb_stored);
+  for (Int32 c = 0; c < m_nb_chunk; ++c) {
+    for (Int32 l = 0; l < C; ++l) {
+      Int32 row = m_row_permutation[c * C + l];
+      Int32 begin = (row >= 0) ? rows_index[row] : 0;
+      Int32 length = (row >= 0) ? row_length(row) : 0;
+      for (Int32 j = 0; j < m_chunk_width[c]; ++j) {
+        Int64 index = m_chunk_offset[c] + Int64(j) * C + l;
+        if (j < length) {
+          m_columns[index] = columns[begin + j];
+          m_values[index] = values[begin + j];
+        }
+        else {
+          m_columns[index] = (row >= 0) ? row : 0;
+          m_values[index] = 0.0;
+        }
+      }
+    }
+  }
+
+  info(4) << "SellFormat nb_row=" << nb_row << " nnz=" << m_nnz << " nb_stored=" << nb_stored
+          << " sigma=" << sigma << " kernel=" << kernelName(m_kernel);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void SellFormat::
+initialize(const CsrFormat& csr, Int32 sigma)
+{
+  Int32 nb_row = csr.m_matrix_row.extent0();
+  Int32 csr_size = csr.m_matrix_column.extent0();
+  UniqueArray<Int32> rows_index(nb_row + 1);
+  UniqueArray<Int32> columns;
+  UniqueArray<Real> values;
+  columns.reserve(csr_size);
+  values.reserve(csr_size);
+  // The rows of the csr matrix may keep unused slots with a -1 column: only
+  // the used entries are copied.
+  for (Int32 i = 0; i < nb_row; ++i) {
+    rows_index[i] = columns.size();
+    Int32 end = (i + 1 < nb_row) ? csr.m_matrix_row(i + 1) : csr_size;
+    for (Int32 k = csr.m_matrix_row(i); k < end; ++k) {
+      if (csr.m_matrix_column(k) < 0)
+        continue;
+      columns.add(csr.m_matrix_column(k));
+      values.add(csr.m_matrix_value(k));
+    }
+  }
+  rows_index[nb_row] = columns.size();
+  initialize(nb_row, rows_index, columns, values, sigma);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void SellFormat::
+multiply(ConstArrayView<Real> x, ArrayView<Real> y) const
+{
+  const Int64* chunk_offset = m_chunk_offset.data();
+  const Int32* chunk_width = m_chunk_width.data();
+  const Int32* permutation = m_row_permutation.data();
+  const Int32* columns = m_columns.data();
+  const Real* values = m_values.data();
+
+  switch (m_kernel) {
+#ifdef FEMUTILS_SELL_HAS_X86_KERNELS
+  case eSellKernel::AVX512:
+    _multiplyAVX512(m_nb_chunk, chunk_offset, chunk_width, permutation, columns, values, x.data(), y.data());
+    return;
+  case eSellKernel::AVX2:
+    _multiplyAVX2(m_nb_chunk, chunk_offset, chunk_width, permutation, columns, values, x.data(), y.data());
+    return;
+#endif
+  default:
+    _multiplyScalar(m_nb_chunk, chunk_offset, chunk_width, permutation, columns, values, x.data(), y.data());
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void SellFormat::
+fillInverseDiagonal(ArrayView<Real> inv_diagonal) const
+{
+  inv_diagonal.fill(1.0);
+  for (Int32 c = 0; c < m_nb_chunk; ++c) {
+    for (Int32 l = 0; l < C; ++l) {
+      Int32 row = m_row_permutation[c * C + l];
+      if (row < 0)
+        continue;
+      for (Int32 j = 0; j < m_chunk_width[c]; ++j) {
+        Int64 index = m_chunk_offset[c] + Int64(j) * C + l;
+        if (m_columns[index] == row && m_values[index] != 0.0)
+          inv_diagonal[row] = 1.0 / m_values[index];
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void SellFormat::
+benchmark(ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+          ConstArrayView<Real> values, Int32 nb_iteration) const
+{
+  using Clock = std::chrono::high_resolution_clock;
+  UniqueArray<Real> x(m_nb_row, 1.0);
+  UniqueArray<Real> y(m_nb_row, 0.0);
+  nb_iteration = math::max(nb_iteration, 1);
+
+  // Bytes read or written by one product: matrix + x + y
+  Real vector_bytes = 2.0 * sizeof(Real) * m_nb_row;
+  Real csr_bytes = Real(m_nnz) * (sizeof(Real) + sizeof(Int32)) + sizeof(Int32) * (m_nb_row + 1) + vector_bytes;
+  Real sell_bytes = Real(nbStoredValue()) * (sizeof(Real) + sizeof(Int32)) +
+  (sizeof(Int64) + 2 * sizeof(Int32)) * m_nb_chunk + sizeof(Int32) * m_nb_row + vector_bytes;
+
+  auto t0 = Clock::now();
+  for (Int32 i = 0; i < nb_iteration; ++i)
+    _multiplyCsr(m_nb_row, rows_index.data(), columns.data(), values.data(), x.data(), y.data());
+  auto t1 = Clock::now();
+  for (Int32 i = 0; i < nb_iteration; ++i)
+    multiply(x, y);
+  auto t2 = Clock::now();
+
+  Real csr_time = std::chrono::duration<Real>(t1 - t0).count() / nb_iteration;
+  Real sell_time = std::chrono::duration<Real>(t2 - t1).count() / nb_iteration;
+  info() << "SpMV benchmark nb_row=" << m_nb_row << " nnz=" << m_nnz
+         << " fill_ratio=" << Real(nbStoredValue()) / math::max(Real(m_nnz), 1.0);
+  info() << "SpMV benchmark CSR time=" << csr_time << "s bandwidth=" << csr_bytes / csr_time * 1.0e-9 << "GB/s";
+  info() << "SpMV benchmark SELL-" << C << " (" << kernelName(m_kernel) << ") time=" << sell_time
+         << "s bandwidth=" << sell_bytes / sell_time * 1.0e-9 << "GB/s speedup=" << csr_time / sell_time;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,128 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* SellFormatMatrix.h                                          (C) 2022-2024 */
+/*                                                                           */
+/* Sliced ELLPACK (SELL-C-sigma) matrix for vectorized products.             */
+/*---------------------------------------------------------------------------*/
+#ifndef FEMTEST_SELLFORMATMATRIX_H
+#define FEMTEST_SELLFORMATMATRIX_H
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#include <arcane/utils/UniqueArray.h>
+#include <arcane/utils/TraceAccessor.h>
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+namespace Arcane::FemUtils
+{
+class CsrFormat;
+
+//! Kernel used for the product of a SellFormat matrix
+enum class eSellKernel
+{
+  Scalar,
+  AVX2,
+  AVX512
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Matrix in the SELL-C-sigma (sliced ELLPACK) format.
+ *
+ * The rows of a FEM matrix are short (7 non-zeros for P1 triangles) and the
+ * inner loop of a CSR product is too short to be vectorized. In this format
+ * the rows are grouped by chunks of C = ChunkSize rows and the entries of a
+ * chunk are stored column by column: the j-th entries of the C rows are
+ * contiguous, so that one SIMD instruction handles one entry of C rows.
+ * The rows of a chunk are padded to the longest one with zero values.
+ *
+ * To limit the padding, the rows are sorted by decreasing length inside
+ * windows of sigma rows before being chunked. The product writes the
+ * results back in the original order of the rows.
+ *
+ * The kernel of multiply() is selected at runtime from the instruction sets
+ * of the CPU (AVX-512, AVX2 or a scalar loop).
+ */
+class SellFormat
+: public TraceAccessor
+{
+ public:
+
+  //! Number of rows of a chunk (8 doubles fill an AVX-512 register)
+  static constexpr Int32 ChunkSize = 8;
+
+ public:
+
+  explicit SellFormat(ITraceMng* tm);
+
+ public:
+
+  /*!
+   * \brief Build the matrix from a CSR matrix.
+   *
+   * \a rows_index has \a nb_row + 1 values, the row \a i has the entries
+   * [rows_index[i], rows_index[i+1]) of \a columns and \a values.
+   */
+  void initialize(Int32 nb_row, ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+                  ConstArrayView<Real> values, Int32 sigma = 64);
+  //! Build the matrix from the values of \a csr
+  void initialize(const CsrFormat& csr, Int32 sigma = 64);
+
+  //! y = A x
+  void multiply(ConstArrayView<Real> x, ArrayView<Real> y) const;
+
+  //! Force the kernel (for benchmarks). The CPU must support it.
+  void setKernel(eSellKernel v) { m_kernel = v; }
+  eSellKernel kernel() const { return m_kernel; }
+  //! Best kernel supported by the CPU
+  static eSellKernel bestKernel();
+  static const char* kernelName(eSellKernel v);
+
+  Int32 nbRow() const { return m_nb_row; }
+  //! Number of stored entries (non-zeros and padding)
+  Int64 nbStoredValue() const { return m_values.size(); }
+  //! Inverse of the diagonal (1 for a zero diagonal)
+  void fillInverseDiagonal(ArrayView<Real> inv_diagonal) const;
+
+  /*!
+   * \brief Measure the bandwidth of the CSR and SELL products.
+   *
+   * Each product is done \a nb_iteration times and the rate is computed from
+   * the bytes of the matrix and of the vectors (GB/s).
+   */
+  void benchmark(ConstArrayView<Int32> rows_index, ConstArrayView<Int32> columns,
+                 ConstArrayView<Real> values, Int32 nb_iteration) const;
+
+ private:
+
+  Int32 m_nb_row = 0;
+  Int32 m_nb_chunk = 0;
+  Int64 m_nnz = 0;
+  eSellKernel m_kernel = eSellKernel::Scalar;
+  //! Offset of the first entry of each chunk (nb_chunk + 1 values)
+  UniqueArray<Int64> m_chunk_offset;
+  //! Number of entries of the rows of each chunk
+  UniqueArray<Int32> m_chunk_width;
+  //! Original row of each slot (-1 for the padding rows of the last chunk)
+  UniqueArray<Int32> m_row_permutation;
+  UniqueArray<Int32> m_columns;
+  UniqueArray<Real> m_values;
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+} // namespace Arcane::FemUtils
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif
@@ -26,6 +26,8 @@
 #include "FemUtils.h"
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
+#include "CsrFormatMatrix.h"
+#include "FemElementMatrix.h"
 
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -46,6 +48,7 @@ class FemModule
   explicit FemModule(const ModuleBuildInfo& mbi)
   : ArcaneFemObject(mbi)
   , m_dofs_on_nodes(mbi.subDomain()->traceMng())
+  , m_csr_matrix(mbi.subDomain())
   {
     ICaseMng* cm = mbi.subDomain()->caseMng();
     cm->setTreatWarningAsError(true);
@@ -70,10 +73,13 @@ class FemModule
   Real lambda;
   Real qdot;
   Real ElementNodes;
+  //! True for the TETRA4 and HEXA8 meshes
+  bool m_is_3d = false;
 
   DoFLinearSystem m_linear_system;
   IItemFamily* m_dof_family = nullptr;
   FemDoFsOnNodes m_dofs_on_nodes;
+  CsrFormat m_csr_matrix;
 
  private:
 
@@ -82,6 +88,8 @@ class FemModule
   void _updateBoundayConditions();
   void _assembleBilinearOperatorTRIA3();
   void _assembleBilinearOperatorQUAD4();
+  void _assembleBilinearOperator3D();
+  void _assembleCsrBilinearOperator();
   void _solve();
   void _initBoundaryconditions();
   void _assembleLinearOperator();
@@ -89,10 +97,14 @@ class FemModule
   void _checkResultFile();
   FixedMatrix<3, 3> _computeElementMatrixTRIA3(Cell cell);
   FixedMatrix<4, 4> _computeElementMatrixQUAD4(Cell cell);
+  FixedMatrix<4, 4> _computeElementMatrixTETRA4(Cell cell);
+  FixedMatrix<8, 8> _computeElementMatrixHEXA8(Cell cell);
   Real _computeAreaTriangle3(Cell cell);
   Real _computeAreaQuad4(Cell cell);
   Real _computeEdgeLength2(Face face);
   Real2 _computeEdgeNormal2(Face face);
+  Real _computeFaceMeasure(Face face);
+  Real _computeVolume3D(Cell cell);
 
 };
 
@@ -163,8 +175,12 @@ _doStationarySolve()
   _updateBoundayConditions();
 
   // Assemble the FEM bilinear operator (LHS - matrix A)
-  if (options()->meshType == "QUAD4")
+  if (options()->csr())
+    _assembleCsrBilinearOperator();
+  else if (options()->meshType == "QUAD4")
     _assembleBilinearOperatorQUAD4();
+  else if (m_is_3d)
+    _assembleBilinearOperator3D();
   else
     _assembleBilinearOperatorTRIA3();
 
@@ -189,8 +205,11 @@ _getMaterialParameters()
   qdot   = options()->qdot();
   ElementNodes = 3.;
 
-  if (options()->meshType == "QUAD4")
+  m_is_3d = (options()->meshType == "TETRA4" || options()->meshType == "HEXA8");
+  if (options()->meshType == "QUAD4" || options()->meshType == "TETRA4")
     ElementNodes = 4.;
+  else if (options()->meshType == "HEXA8")
+    ElementNodes = 8.;
 
   ENUMERATE_ (Cell, icell, allCells()) {
     Cell cell = *icell;
@@ -402,7 +421,8 @@ _assembleLinearOperator()
   //----------------------------------------------
   ENUMERATE_ (Cell, icell, allCells()) {
     Cell cell = *icell;
-    Real area = _computeAreaTriangle3(cell);
+    // Area of the cell in 2D, volume in 3D
+    Real area = (m_is_3d) ? _computeVolume3D(cell) : _computeAreaTriangle3(cell);
     for (Node node : cell.nodes()) {
       if (!(m_u_dirichlet[node]) && node.isOwn())
         rhs_values[node_dof.dofId(node, 0)] += qdot * area / ElementNodes;
@@ -425,15 +445,20 @@ _assembleLinearOperator()
       Real value = bs->value();
       ENUMERATE_ (Face, iface, group) {
         Face face = *iface;
-        Real length = _computeEdgeLength2(face);
+        // Length of the edge in 2D, area of the face in 3D
+        Real measure = _computeFaceMeasure(face);
+        Real nb_face_node = face.nbNode();
         for (Node node : iface->nodes()) {
           if (!(m_u_dirichlet[node]) && node.isOwn())
-            rhs_values[node_dof.dofId(node, 0)] += value * length / 2.;
+            rhs_values[node_dof.dofId(node, 0)] += value * measure / nb_face_node;
         }
       }
       continue;
     }
 
+    if (m_is_3d)
+      ARCANE_FATAL("Only the 'value' of the Neumann boundary condition is supported for 3D meshes");
+
 
     if(bs->valueX.isPresent()  && bs->valueY.isPresent()) {
       Real valueX = bs->valueX();
@@ -714,6 +739,177 @@ _assembleBilinearOperatorTRIA3()
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+void FemModule::
+_assembleCsrBilinearOperator()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  // The pattern is built once from the cells, so the assembly only looks up
+  // the column in the row of the csr matrix (a short linear search) instead
+  // of the sparse structure of the linear system.
+  m_csr_matrix.initializeFromNodeCellPattern(mesh(), m_dof_family, node_dof);
+
+  auto add_element_matrix = [&](Cell cell, const auto& K_e) {
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      if (node1.isOwn()) {
+        DoFLocalId row = node_dof.dofId(node1, 0);
+        Int32 n2_index = 0;
+        for (Node node2 : cell.nodes()) {
+          m_csr_matrix.matrixAddValue(row, node_dof.dofId(node2, 0), K_e(n1_index, n2_index));
+          ++n2_index;
+        }
+      }
+      ++n1_index;
+    }
+  };
+
+  bool is_quad4 = (options()->meshType == "QUAD4");
+  bool is_hexa8 = (options()->meshType == "HEXA8");
+  bool is_tetra4 = (options()->meshType == "TETRA4");
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    lambda = m_cell_lambda[cell]; // lambda is always considered cell constant
+    if (is_quad4) {
+      if (cell.type() != IT_Quad4)
+        ARCANE_FATAL("Only Quad4 cell type is supported");
+      add_element_matrix(cell, _computeElementMatrixQUAD4(cell));
+    }
+    else if (is_hexa8) {
+      if (cell.type() != IT_Hexaedron8)
+        ARCANE_FATAL("Only Hexaedron8 cell type is supported");
+      add_element_matrix(cell, _computeElementMatrixHEXA8(cell));
+    }
+    else if (is_tetra4) {
+      if (cell.type() != IT_Tetraedron4)
+        ARCANE_FATAL("Only Tetraedron4 cell type is supported");
+      add_element_matrix(cell, _computeElementMatrixTETRA4(cell));
+    }
+    else {
+      if (cell.type() != IT_Triangle3)
+        ARCANE_FATAL("Only Triangle3 cell type is supported");
+      add_element_matrix(cell, _computeElementMatrixTRIA3(cell));
+    }
+  }
+
+  m_csr_matrix.translateToLinearSystem(m_linear_system);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_assembleBilinearOperator3D()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  auto add_element_matrix = [&](Cell cell, const auto& K_e) {
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      Int32 n2_index = 0;
+      for (Node node2 : cell.nodes()) {
+        Real v = K_e(n1_index, n2_index);
+        if (node1.isOwn()) {
+          m_linear_system.matrixAddValue(node_dof.dofId(node1, 0), node_dof.dofId(node2, 0), v);
+        }
+        ++n2_index;
+      }
+      ++n1_index;
+    }
+  };
+
+  bool is_hexa8 = (options()->meshType == "HEXA8");
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    lambda = m_cell_lambda[cell]; // lambda is always considered cell constant
+    if (is_hexa8) {
+      if (cell.type() != IT_Hexaedron8)
+        ARCANE_FATAL("Only Hexaedron8 cell type is supported");
+      add_element_matrix(cell, _computeElementMatrixHEXA8(cell));
+    }
+    else {
+      if (cell.type() != IT_Tetraedron4)
+        ARCANE_FATAL("Only Tetraedron4 cell type is supported");
+      add_element_matrix(cell, _computeElementMatrixTETRA4(cell));
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+FixedMatrix<4, 4> FemModule::
+_computeElementMatrixTETRA4(Cell cell)
+{
+  Real3 m[4];
+  for (Int32 i = 0; i < 4; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
+
+  Real K_e[16];
+  computeStiffnessMatrixTETRA4(m, K_e);
+
+  FixedMatrix<4, 4> int_cdPi_dPj;
+  for (Int32 i = 0; i < 4; ++i)
+    for (Int32 j = 0; j < 4; ++j)
+      int_cdPi_dPj(i, j) = K_e[i * 4 + j];
+  int_cdPi_dPj.multInPlace(lambda);
+
+  return int_cdPi_dPj;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+FixedMatrix<8, 8> FemModule::
+_computeElementMatrixHEXA8(Cell cell)
+{
+  Real3 m[8];
+  for (Int32 i = 0; i < 8; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
+
+  Real K_e[64];
+  computeStiffnessMatrixHEXA8(m, K_e);
+
+  FixedMatrix<8, 8> int_cdPi_dPj;
+  for (Int32 i = 0; i < 8; ++i)
+    for (Int32 j = 0; j < 8; ++j)
+      int_cdPi_dPj(i, j) = K_e[i * 8 + j];
+  int_cdPi_dPj.multInPlace(lambda);
+
+  return int_cdPi_dPj;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Real FemModule::
+_computeFaceMeasure(Face face)
+{
+  Real3 m[4];
+  Int32 nb_node = face.nbNode();
+  for (Int32 i = 0; i < nb_node; ++i)
+    m[i] = m_node_coord[face.nodeId(i)];
+  return computeFaceMeasure(m, nb_node);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Real FemModule::
+_computeVolume3D(Cell cell)
+{
+  Real3 m[8];
+  Int32 nb_node = cell.nbNode();
+  for (Int32 i = 0; i < nb_node; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
+  if (nb_node == 8)
+    return computeVolumeHEXA8(m);
+  return computeVolumeTETRA4(m);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 void FemModule::
 _solve()
 {
@@ -1,11 +1,11 @@
 ﻿// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
 //-----------------------------------------------------------------------------
-// Copyright 2000-2023 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
 // See the top-level COPYRIGHT file for details.
 // SPDX-License-Identifier: Apache-2.0
 //-----------------------------------------------------------------------------
 /*---------------------------------------------------------------------------*/
-/* FemModule.cc                                                (C) 2022-2023 */
+/* FemModule.cc                                                (C) 2022-2024 */
 /*                                                                           */
 /* Simple module to test simple FEM mechanism.                               */
 /*---------------------------------------------------------------------------*/
@@ -17,12 +17,18 @@
 #include <arcane/IItemFamily.h>
 #include <arcane/ItemGroup.h>
 #include <arcane/ICaseMng.h>
+#include <arcane/IParallelMng.h>
 
 #include "IDoFLinearSystemFactory.h"
 #include "Fem_axl.h"
 #include "FemUtils.h"
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
+#include "FemSourceTerm.h"
+#include "FemElementMatrix.h"
+#include "FemMaterialTable.h"
+#include "CsrFormatMatrix.h"
+#include "KrylovExponential.h"
 
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -43,6 +49,9 @@ class FemModule
   explicit FemModule(const ModuleBuildInfo& mbi)
   : ArcaneFemObject(mbi)
   , m_dofs_on_nodes(mbi.subDomain()->traceMng())
+  , m_materials(mbi.subDomain()->traceMng())
+  , m_stiffness_matrix(mbi.subDomain())
+  , m_krylov_exponential(mbi.subDomain()->traceMng())
   {
     ICaseMng* cm = mbi.subDomain()->caseMng();
     cm->setTreatWarningAsError(true);
@@ -77,10 +86,43 @@ class FemModule
        qdot   ;
   //! FEM parameter
   Real ElementNodes;
+  //! True for the TETRA4 and HEXA8 meshes
+  bool m_is_3d = false;
+  //! Source fields added to qdot
+  bool m_use_cell_source = false;
+  bool m_use_node_source = false;
 
   DoFLinearSystem m_linear_system;
   IItemFamily* m_dof_family = nullptr;
   FemDoFsOnNodes m_dofs_on_nodes;
+  //! Material of each cell and conductivity of each material
+  FemMaterialTable m_materials;
+  static constexpr Int32 MAT_LAMBDA = 0;
+  //! Nonlinear conductivity lambda_m (1 + beta (T - T_ref)) (see _doNewtonSolve())
+  bool m_use_newton = false;
+  Real m_conductivity_coefficient = 0.0;
+  Real m_reference_temperature = 0.0;
+  //! True if the Jacobian (the frozen matrix) has to be assembled again
+  bool m_need_jacobian = true;
+  Int32 m_nb_newton_step = 0;
+  Int64 m_nb_newton_linear_solve = 0;
+
+  //! Exponential time integration (see _doExponentialStep())
+  bool m_use_exponential = false;
+  //! Stiffness matrix K (conduction and convection)
+  CsrFormat m_stiffness_matrix;
+  //! Lumped mass of each DoF
+  UniqueArray<Real> m_lumped_mass;
+  //! Source vector f (heat sources, Neumann and convection fluxes)
+  UniqueArray<Real> m_exponential_source;
+  //! Own DoFs whose temperature is not fixed
+  UniqueArray<Int32> m_free_dofs;
+  UniqueArray<Real> m_exponential_work;
+  KrylovExponential m_krylov_exponential;
+  //! Last sub-step which has converged
+  Real m_exponential_substep = 0.0;
+  Int64 m_nb_exponential_substep = 0;
+  Int64 m_nb_exponential_product = 0;
 
  private:
 
@@ -89,23 +131,43 @@ class FemModule
   void _updateVariables();
   void _initTemperature();
   void _doStationarySolve();
+  void _doNewtonSolve();
+  void _assembleNewtonJacobian();
+  Real _assembleNewtonResidual();
+  void _applyNewtonDirichletConditions();
+  void _checkNewtonLinearSolves();
+  void _doExponentialStep();
+  void _assembleExponentialOperators();
+  void _multiplyExponentialOperator(ConstArrayView<Real> x, ArrayView<Real> y);
+  void _synchronizeDoFValues(ArrayView<Real> values);
+  Real _dotFreeDoFs(ConstArrayView<Real> x, ConstArrayView<Real> y);
+  Real _cellConductivity(Cell cell);
   void _getParameters();
   void _updateBoundayConditions();
   void _assembleBilinearOperatorTRIA3();
   void _assembleBilinearOperatorQUAD4();
   void _assembleBilinearOperatorEDGE2();
+  void _assembleBilinearOperator3D();
+  void _assembleBilinearOperatorFace3D();
   void _solve();
   void _initBoundaryconditions();
   void _assembleLinearOperator();
+  void _assembleBoundaryLinearTerms(VariableDoFReal& rhs_values);
+  void _computeFlux();
   FixedMatrix<2, 2> _computeElementMatrixEDGE2(Face face);
-  FixedMatrix<3, 3> _computeElementMatrixTRIA3(Cell cell);
-  FixedMatrix<4, 4> _computeElementMatrixQUAD4(Cell cell);
+  FixedMatrix<3, 3> _computeElementMatrixTRIA3(Cell cell, Real area);
+  FixedMatrix<4, 4> _computeElementMatrixQUAD4(Cell cell, Real area);
+  void _assembleElementVolumeTerms(Cell cell, Real area, IndexedNodeDoFConnectivityView node_dof,
+                                   VariableDoFReal& rhs_values);
+  void _computeElementSourceTerms(Cell cell, Real area, Real b_e[8]);
   Real  _computeDxOfRealTRIA3(Cell cell);
   Real  _computeDyOfRealTRIA3(Cell cell);
   Real2 _computeDxDyOfRealTRIA3(Cell cell);
+  Real3 _computeTemperatureGradient(Cell cell);
   Real _computeAreaTriangle3(Cell cell);
   Real _computeAreaQuad4(Cell cell);
   Real _computeEdgeLength2(Face face);
+  Real _computeFaceMeasure(Face face);
   void _applyDirichletBoundaryConditions();
   void _checkResultFile();
 };
@@ -119,15 +181,32 @@ compute()
   info() << "Module Fem COMPUTE";
 
   // Stop code after computations
-  if (t >= tmax)
+  bool is_last_step = (t >= tmax);
+  if (is_last_step)
     subDomain()->timeLoopMng()->stopComputeLoop(true);
 
-  m_linear_system.reset();
-  m_linear_system.setLinearSystemFactory(options()->linearSystem());
-  m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
+  // The nonlinear solve keeps the Jacobian (frozen matrix) between time
+  // steps. The exponential integration only uses the RHS for its assembly.
+  if ((!m_use_newton && !m_use_exponential) || !m_linear_system.isInitialized()) {
+    m_linear_system.reset();
+    m_linear_system.setLinearSystemFactory(options()->linearSystem());
+    m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
+  }
 
   info() << "NB_CELL=" << allCells().size() << " NB_FACE=" << allFaces().size();
-  _doStationarySolve();
+  if (m_use_newton)
+    _doNewtonSolve();
+  else if (m_use_exponential)
+    _doExponentialStep();
+  else
+    _doStationarySolve();
+
+  // Check results of the last time step
+  if (is_last_step) {
+    _checkResultFile();
+    if (m_use_newton)
+      _checkNewtonLinearSolves();
+  }
   _updateVariables();
   _updateTime();
 
@@ -224,22 +303,551 @@ _doStationarySolve()
   // # update BCs
   _updateBoundayConditions();
 
-  // Assemble the FEM bilinear operator (LHS - matrix A)
+  // Assemble the FEM bilinear operator (LHS - matrix A). The volume terms of
+  // the linear operator (RHS - vector b) are assembled in the same cell loop.
+  m_linear_system.rhsVariable().fill(0.0);
   if (options()->meshType == "QUAD4")
     _assembleBilinearOperatorQUAD4();
+  else if (m_is_3d)
+    _assembleBilinearOperator3D();
   else
     _assembleBilinearOperatorTRIA3();
 
-  _assembleBilinearOperatorEDGE2();
+  if (m_is_3d)
+    _assembleBilinearOperatorFace3D();
+  else
+    _assembleBilinearOperatorEDGE2();
 
   // Assemble the FEM linear operator (RHS - vector b)
   _assembleLinearOperator();
 
   // # T=linalg.solve(K,RHS)
   _solve();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Solve a time step with a temperature dependent conductivity.
+ *
+ * The residual r(T) = b - A(T) T of the implicit time step is computed with
+ * a cell loop, A(T) being the matrix of the linear case with the conductivity
+ * of each cell evaluated at its mean temperature. The corrections are solved
+ * with A(T_k) as (Picard) Jacobian:
+ *
+ *   A(T_k) dT = r(T_k),   T_k+1 = T_k + dT
+ *
+ * The Jacobian is frozen: it is kept between the iterations and the time
+ * steps and is only assembled again when the residual does not decrease by
+ * 'newton-stall-ratio'. The linear solves are inexact, their relative
+ * tolerance is the Eisenstat-Walker forcing term (choice 2, gamma=0.9,
+ * alpha=2) bounded by 'newton-max-forcing'.
+ */
+void FemModule::
+_doNewtonSolve()
+{
+  const Real epsilon = options()->newtonEpsilon();
+  const Int32 max_iteration = options()->newtonMaxIteration();
+  const Real stall_ratio = options()->newtonStallRatio();
+  const Real max_forcing = options()->newtonMaxForcing();
+  const Real gamma = 0.9;
+
+  // The temperature of the previous time step is the initial guess
+  ENUMERATE_ (Node, inode, allNodes()) {
+    Node node = *inode;
+    if (!m_node_is_temperature_fixed[node])
+      m_node_temperature[node] = m_node_temperature_old[node];
+  }
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Real initial_residual_norm = 0.0;
+  Real previous_residual_norm = 0.0;
+  Real forcing = max_forcing;
+  Int32 nb_jacobian = 0;
+  Int32 nb_linear_solve = 0;
+
+  for (Int32 iteration = 0;; ++iteration) {
+    Real residual_norm = _assembleNewtonResidual();
+    if (iteration == 0)
+      initial_residual_norm = residual_norm;
+    info() << "Newton iteration=" << iteration << " residual_norm=" << residual_norm;
+    if (residual_norm <= epsilon * initial_residual_norm)
+      break;
+    if (iteration == max_iteration) {
+      warning() << "Newton has not converged after " << max_iteration << " iterations";
+      break;
+    }
+
+    if (iteration > 0) {
+      Real ratio = residual_norm / previous_residual_norm;
+      if (ratio > stall_ratio)
+        m_need_jacobian = true;
+      Real safeguard = gamma * forcing * forcing;
+      forcing = gamma * ratio * ratio;
+      if (safeguard > 0.1)
+        forcing = math::max(forcing, safeguard);
+      // Do not solve beyond the accuracy asked for the nonlinear iterations
+      forcing = math::max(forcing, 0.5 * epsilon * initial_residual_norm / residual_norm);
+      forcing = math::min(forcing, max_forcing);
+    }
+
+    if (m_need_jacobian) {
+      _assembleNewtonJacobian();
+      ++nb_jacobian;
+      // The assembly of the Jacobian has overwritten the RHS
+      _assembleNewtonResidual();
+    }
+    _applyNewtonDirichletConditions();
+
+    m_linear_system.setEpsilon(forcing);
+    m_linear_system.solve();
+    ++nb_linear_solve;
+
+    VariableDoFReal& dof_correction(m_linear_system.solutionVariable());
+    ENUMERATE_ (Node, inode, ownNodes()) {
+      Node node = *inode;
+      if (!m_node_is_temperature_fixed[node])
+        m_node_temperature[node] += dof_correction[node_dof.dofId(node, 0)];
+    }
+    m_node_temperature.synchronize();
+    previous_residual_norm = residual_norm;
+  }
+  ++m_nb_newton_step;
+  m_nb_newton_linear_solve += nb_linear_solve;
+  info() << "Newton t=" << t << " nb_linear_solve=" << nb_linear_solve
+         << " nb_jacobian=" << nb_jacobian
+         << " (total nb_step=" << m_nb_newton_step << " nb_linear_solve=" << m_nb_newton_linear_solve << ")";
+
+  _computeFlux();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Check the mean number of linear solves per time step of the
+ * nonlinear iterations against 'newton-max-mean-linear-solve'.
+ */
+void FemModule::
+_checkNewtonLinearSolves()
+{
+  Real max_mean = options()->newtonMaxMeanLinearSolve();
+  Real mean = static_cast<Real>(m_nb_newton_linear_solve) / m_nb_newton_step;
+  info() << "Newton mean_nb_linear_solve=" << mean << " nb_step=" << m_nb_newton_step;
+  if (max_mean > 0.0 && mean > max_mean)
+    ARCANE_FATAL("Too many linear solves per time step in the nonlinear iterations (mean={0} max={1})",
+                 mean, max_mean);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Assemble the Jacobian A(T) with the current temperature.
+ */
+void FemModule::
+_assembleNewtonJacobian()
+{
+  info() << "Assembly of the Jacobian";
+  if (m_linear_system.hasFrozenMatrix())
+    m_linear_system.clearValues();
+  m_linear_system.setMatrixFrozen(true);
+  _assembleBilinearOperatorTRIA3();
+  _assembleBilinearOperatorEDGE2();
+  m_need_jacobian = false;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Fill the RHS with the residual r(T) = b - A(T) T and return |r|.
+ *
+ * The residual is zero on the Dirichlet nodes.
+ */
+Real FemModule::
+_assembleNewtonResidual()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
+  rhs_values.fill(0.0);
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    lambda = _cellConductivity(cell);
+    Real area = _computeAreaTriangle3(cell);
+    auto K_e = _computeElementMatrixTRIA3(cell, area);
+    _assembleElementVolumeTerms(cell, area, node_dof, rhs_values);
+
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      if (node1.isOwn() && !m_node_is_temperature_fixed[node1]) {
+        Real v = 0.0;
+        Int32 n2_index = 0;
+        for (Node node2 : cell.nodes()) {
+          v += K_e(n1_index, n2_index) * m_node_temperature[node2];
+          ++n2_index;
+        }
+        rhs_values[node_dof.dofId(node1, 0)] -= v;
+      }
+      ++n1_index;
+    }
+  }
+
+  for (const auto& bs : options()->convectionBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+    h = bs->h();
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+      auto K_e = _computeElementMatrixEDGE2(face);
+      Int32 n1_index = 0;
+      for (Node node1 : face.nodes()) {
+        if (node1.isOwn() && !m_node_is_temperature_fixed[node1]) {
+          Real v = 0.0;
+          Int32 n2_index = 0;
+          for (Node node2 : face.nodes()) {
+            v += K_e(n1_index, n2_index) * m_node_temperature[node2];
+            ++n2_index;
+          }
+          rhs_values[node_dof.dofId(node1, 0)] -= v;
+        }
+        ++n1_index;
+      }
+    }
+  }
+
+  _assembleBoundaryLinearTerms(rhs_values);
+
+  Real norm2 = 0.0;
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Real r = rhs_values[node_dof.dofId(*inode, 0)];
+    norm2 += r * r;
+  }
+  norm2 = parallelMng()->reduce(Parallel::ReduceSum, norm2);
+  return math::sqrt(norm2);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Impose a zero correction on the Dirichlet nodes.
+ *
+ * The matrix part is discarded when the Jacobian is frozen, except for the
+ * eliminations which have to be given at each solve.
+ */
+void FemModule::
+_applyNewtonDirichletConditions()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  String method = options()->enforceDirichletMethod();
+  Real Penalty = options()->penalty();
+
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    if (!m_node_is_temperature_fixed[inode])
+      continue;
+    DoFLocalId dof_id = node_dof.dofId(*inode, 0);
+    if (method == "Penalty")
+      m_linear_system.matrixSetValue(dof_id, dof_id, Penalty);
+    else if (method == "WeakPenalty")
+      m_linear_system.matrixAddValue(dof_id, dof_id, Penalty);
+    else if (method == "RowElimination")
+      m_linear_system.eliminateRow(dof_id, 0.0);
+    else if (method == "RowColumnElimination")
+      m_linear_system.eliminateRowColumn(dof_id, 0.0);
+    else
+      ARCANE_FATAL("Invalid value '{0}' for 'enforce-Dirichlet-method'", method);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Conductivity of \a cell.
+ *
+ * With a nonlinear conductivity, the value of the material is multiplied by
+ * 1 + beta (T - T_ref), T being the mean temperature of the nodes of the cell.
+ */
+Real FemModule::
+_cellConductivity(Cell cell)
+{
+  Real value = m_materials.cellValue(MAT_LAMBDA, cell);
+  if (!m_use_newton)
+    return value;
+  Real mean_temperature = 0.0;
+  for (Node node : cell.nodes())
+    mean_temperature += m_node_temperature[node];
+  mean_temperature /= cell.nbNode();
+  return value * (1.0 + m_conductivity_coefficient * (mean_temperature - m_reference_temperature));
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Advance the temperature of one time step with an exponential
+ * integrator.
+ *
+ * With the lumped mass matrix M, the semi-discrete problem on the DoFs
+ * which are not fixed is M T' = f - K T, the product K T including the
+ * fixed temperatures. With S = M^-1/2 K M^-1/2 (restricted to the free
+ * DoFs, symmetric) the exact solution over tau is
+ *
+ *   T(t + tau) = T(t) + tau M^-1/2 phi_1(-tau S) M^-1/2 (f - K T(t))
+ *
+ * phi_1(-tau S) v is computed with the Lanczos method (KrylovExponential).
+ * The sources and boundary conditions do not depend on time, so the step is
+ * exact in time and dt is only limited by the output times. When the Krylov
+ * space of 'krylov-max-dimension' vectors is not accurate enough, the step
+ * is split in sub-steps.
+ */
+void FemModule::
+_doExponentialStep()
+{
+  if (m_lumped_mass.empty())
+    _assembleExponentialOperators();
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  auto rows_index = m_stiffness_matrix.m_matrix_row.to1DSpan();
+  auto rows_nb_column = m_stiffness_matrix.m_matrix_rows_nb_column.to1DSpan();
+  auto columns = m_stiffness_matrix.m_matrix_column.to1DSpan();
+  auto values = m_stiffness_matrix.m_matrix_value.to1DSpan();
+  Int32 nb_dof = m_lumped_mass.size();
+
+  UniqueArray<Real> temperature(nb_dof, 0.0);
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    temperature[node_dof.dofId(node, 0)] = m_node_is_temperature_fixed[node] ? m_node_temperature[node] : m_node_temperature_old[node];
+  }
+  _synchronizeDoFValues(temperature);
+  UniqueArray<Real> v(nb_dof, 0.0);
+  UniqueArray<Real> y(nb_dof, 0.0);
+
+  auto s = [&](ConstArrayView<Real> x, ArrayView<Real> sx) { _multiplyExponentialOperator(x, sx); };
+  auto dot = [&](ConstArrayView<Real> x1, ConstArrayView<Real> x2) { return _dotFreeDoFs(x1, x2); };
+
+  Real remaining = dt;
+  if (m_exponential_substep <= 0.0)
+    m_exponential_substep = dt;
+  Int32 nb_substep = 0;
+  Int64 nb_product_begin = m_nb_exponential_product;
+  while (remaining > 0.0) {
+    Real tau = math::min(m_exponential_substep, remaining);
+
+    // v = M^-1/2 (f - K T)
+    for (Int32 dof : m_free_dofs) {
+      Real r = m_exponential_source[dof];
+      Int32 end = rows_index[dof] + rows_nb_column[dof];
+      for (Int32 k = rows_index[dof]; k < end; ++k)
+        r -= values[k] * temperature[columns[k]];
+      v[dof] = r / math::sqrt(m_lumped_mass[dof]);
+    }
+
+    bool is_converged = m_krylov_exponential.applyPhi1(s, dot, tau, v, y);
+    if (!is_converged) {
+      m_exponential_substep = 0.5 * tau;
+      info() << "Exponential sub-step tau=" << tau << " has not converged, using tau=" << m_exponential_substep;
+      continue;
+    }
+
+    for (Int32 dof : m_free_dofs)
+      temperature[dof] += tau * y[dof] / math::sqrt(m_lumped_mass[dof]);
+    _synchronizeDoFValues(temperature);
+    remaining -= tau;
+    ++nb_substep;
+    // Try a larger sub-step when the Krylov space is small
+    if (m_krylov_exponential.dimension() < m_krylov_exponential.maxDimension() / 2)
+      m_exponential_substep = math::min(2.0 * m_exponential_substep, dt);
+  }
+
+  ENUMERATE_ (Node, inode, allNodes()) {
+    Node node = *inode;
+    if (!m_node_is_temperature_fixed[node])
+      m_node_temperature[node] = temperature[node_dof.dofId(node, 0)];
+  }
+
+  m_nb_exponential_substep += nb_substep;
+  Int64 nb_product = m_nb_exponential_product - nb_product_begin;
+  info() << "Exponential step t=" << t << " nb_substep=" << nb_substep << " nb_product=" << nb_product
+         << " (total nb_substep=" << m_nb_exponential_substep
+         << " nb_product=" << m_nb_exponential_product << ")";
+
+  _computeFlux();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Assemble K, the lumped mass and f for the exponential integration.
+ *
+ * K is assembled on the pattern of the nodes sharing a cell. The lumped mass
+ * of a node is the measure of the cells divided by their number of nodes, as
+ * for the RHS of the backward Euler scheme.
+ */
+void FemModule::
+_assembleExponentialOperators()
+{
+  info() << "Assembly of the operators of the exponential integration";
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Int32 nb_dof = m_dof_family->maxLocalId();
+
+  m_stiffness_matrix.initializeFromNodeCellPattern(mesh(), m_dof_family, node_dof);
+  m_stiffness_matrix.m_matrix_value.fill(0.0);
+  m_lumped_mass.resize(nb_dof);
+  m_lumped_mass.fill(0.0);
+  m_exponential_source.resize(nb_dof);
+  m_exponential_source.fill(0.0);
+  m_exponential_work.resize(nb_dof);
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    Int32 nb_node = cell.nbNode();
+    Real cell_lambda = _cellConductivity(cell);
+
+    Real3 m[8];
+    for (Int32 i = 0; i < nb_node; ++i)
+      m[i] = m_node_coord[cell.nodeId(i)];
+
+    Real K_e[64];
+    Real measure = 0.0;
+    if (cell.type() == IT_Triangle3) {
+      measure = _computeAreaTriangle3(cell);
+      Real2 dPhi[3] = { Real2(m[1].y - m[2].y, m[2].x - m[1].x),
+                        Real2(m[2].y - m[0].y, m[0].x - m[2].x),
+                        Real2(m[0].y - m[1].y, m[1].x - m[0].x) };
+      for (Int32 i = 0; i < 3; ++i)
+        for (Int32 j = 0; j < 3; ++j)
+          K_e[i * 3 + j] = (dPhi[i].x * dPhi[j].x + dPhi[i].y * dPhi[j].y) / (4.0 * measure);
+    }
+    else if (cell.type() == IT_Quad4) {
+      measure = _computeAreaQuad4(cell);
+      computeStiffnessMatrixQUAD4(m, K_e);
+    }
+    else if (cell.type() == IT_Tetraedron4)
+      measure = computeStiffnessMatrixTETRA4(m, K_e);
+    else if (cell.type() == IT_Hexaedron8)
+      measure = computeStiffnessMatrixHEXA8(m, K_e);
+    else
+      ARCANE_FATAL("Cell type '{0}' is not supported", cell.type());
+
+    Real b_e[8] = { 0., 0., 0., 0., 0., 0., 0., 0. };
+    _computeElementSourceTerms(cell, measure, b_e);
+
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      if (node1.isOwn()) {
+        DoFLocalId dof1 = node_dof.dofId(node1, 0);
+        m_lumped_mass[dof1] += measure / nb_node;
+        m_exponential_source[dof1] += b_e[n1_index];
+        Int32 n2_index = 0;
+        for (Node node2 : cell.nodes()) {
+          m_stiffness_matrix.matrixAddValue(dof1, node_dof.dofId(node2, 0), cell_lambda * K_e[n1_index * nb_node + n2_index]);
+          ++n2_index;
+        }
+      }
+      ++n1_index;
+    }
+  }
+
+  // Convection: h u v on the boundary (lumped in 3D, see _assembleBilinearOperatorFace3D())
+  for (const auto& bs : options()->convectionBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+    h = bs->h();
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+      if (m_is_3d) {
+        Real v = h * _computeFaceMeasure(face) / face.nbNode();
+        for (Node node : face.nodes())
+          if (node.isOwn())
+            m_stiffness_matrix.matrixAddValue(node_dof.dofId(node, 0), node_dof.dofId(node, 0), v);
+        continue;
+      }
+      auto K_e = _computeElementMatrixEDGE2(face);
+      Int32 n1_index = 0;
+      for (Node node1 : face.nodes()) {
+        Int32 n2_index = 0;
+        for (Node node2 : face.nodes()) {
+          if (node1.isOwn())
+            m_stiffness_matrix.matrixAddValue(node_dof.dofId(node1, 0), node_dof.dofId(node2, 0), K_e(n1_index, n2_index));
+          ++n2_index;
+        }
+        ++n1_index;
+      }
+    }
+  }
+
+  // Neumann and convection fluxes
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
+  rhs_values.fill(0.0);
+  _assembleBoundaryLinearTerms(rhs_values);
+
+  m_free_dofs.clear();
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    if (m_node_is_temperature_fixed[node])
+      continue;
+    DoFLocalId dof = node_dof.dofId(node, 0);
+    m_exponential_source[dof] += rhs_values[dof];
+    m_free_dofs.add(dof);
+  }
+}
 
-  // Check results
-  _checkResultFile();
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief y = M^-1/2 K M^-1/2 x on the free DoFs (zero on the other ones).
+ */
+void FemModule::
+_multiplyExponentialOperator(ConstArrayView<Real> x, ArrayView<Real> y)
+{
+  auto rows_index = m_stiffness_matrix.m_matrix_row.to1DSpan();
+  auto rows_nb_column = m_stiffness_matrix.m_matrix_rows_nb_column.to1DSpan();
+  auto columns = m_stiffness_matrix.m_matrix_column.to1DSpan();
+  auto values = m_stiffness_matrix.m_matrix_value.to1DSpan();
+
+  ArrayView<Real> z = m_exponential_work;
+  z.fill(0.0);
+  for (Int32 dof : m_free_dofs)
+    z[dof] = x[dof] / math::sqrt(m_lumped_mass[dof]);
+  _synchronizeDoFValues(z);
+
+  y.fill(0.0);
+  for (Int32 dof : m_free_dofs) {
+    Real v = 0.0;
+    Int32 end = rows_index[dof] + rows_nb_column[dof];
+    for (Int32 k = rows_index[dof]; k < end; ++k)
+      v += values[k] * z[columns[k]];
+    y[dof] = v / math::sqrt(m_lumped_mass[dof]);
+  }
+  ++m_nb_exponential_product;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Copy the values of the own DoFs to the ghost DoFs.
+ */
+void FemModule::
+_synchronizeDoFValues(ArrayView<Real> values)
+{
+  if (!parallelMng()->isParallel())
+    return;
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    m_node_exponential_work[inode] = values[node_dof.dofId(*inode, 0)];
+  }
+  m_node_exponential_work.synchronize();
+  ENUMERATE_ (Node, inode, allNodes()) {
+    if (!inode->isOwn())
+      values[node_dof.dofId(*inode, 0)] = m_node_exponential_work[inode];
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+Real FemModule::
+_dotFreeDoFs(ConstArrayView<Real> x, ConstArrayView<Real> y)
+{
+  Real v = 0.0;
+  for (Int32 dof : m_free_dofs)
+    v += x[dof] * y[dof];
+  return parallelMng()->reduce(Parallel::ReduceSum, v);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -253,24 +861,46 @@ _getParameters()
   qdot   = options()->qdot();
   ElementNodes = 3.;
 
-  if (options()->meshType == "QUAD4")
+  m_is_3d = (options()->meshType == "TETRA4" || options()->meshType == "HEXA8");
+  if (options()->meshType == "QUAD4" || options()->meshType == "TETRA4")
     ElementNodes = 4.;
-
-  ENUMERATE_ (Cell, icell, allCells()) {
-    Cell cell = *icell;
-    m_cell_lambda[cell] = lambda;
-    }
+  else if (options()->meshType == "HEXA8")
+    ElementNodes = 8.;
+
+  // Read once the kind of source field to avoid options() lookup in the cell loops
+  String source_field = options()->sourceField();
+  m_use_cell_source = (source_field == "Cell");
+  m_use_node_source = (source_field == "Node");
+  if (!m_use_cell_source && !m_use_node_source && source_field != "None")
+    ARCANE_FATAL("Invalid value '{0}' for 'source-field' (valid values are: None, Cell, Node)", source_field);
+
+  m_conductivity_coefficient = options()->conductivityTemperatureCoefficient();
+  m_reference_temperature = options()->referenceTemperature();
+  m_use_newton = (m_conductivity_coefficient != 0.0 || options()->nonlinearSolve());
+  if (m_use_newton && (m_is_3d || options()->meshType == "QUAD4"))
+    ARCANE_FATAL("The nonlinear solve ('conductivity-temperature-coefficient' or 'nonlinear-solve') is only available for TRIA3 meshes");
+
+  String time_integration = options()->timeIntegration();
+  m_use_exponential = (time_integration == "Exponential");
+  if (!m_use_exponential && time_integration != "BackwardEuler")
+    ARCANE_FATAL("Invalid value '{0}' for 'time-integration' (valid values are: BackwardEuler, Exponential)", time_integration);
+  if (m_use_exponential && m_use_newton)
+    ARCANE_FATAL("'time-integration' Exponential is only available for a linear conductivity");
+  m_krylov_exponential.setMaxDimension(options()->krylovMaxDimension());
+  m_krylov_exponential.setEpsilon(options()->krylovEpsilon());
+
+  // Material 0 is used by the cells which are not in a 'material-property'
+  m_materials.initialize(mesh(), "Heat", 1);
+  m_materials.setValue(MAT_LAMBDA, 0, lambda);
 
   for (const auto& bs : options()->materialProperty()) {
     CellGroup group = bs->volume();
     Real value = bs->lambda();
     info() << "Lambda for group=" << group.name() << " v=" << value;
 
-    ENUMERATE_ (Cell, icell, group) {
-      Cell cell = *icell;
-      m_cell_lambda[cell] = value;
-      }
-    }
+    Int32 mat_index = m_materials.addMaterial(group);
+    m_materials.setValue(MAT_LAMBDA, mat_index, value);
+  }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -350,14 +980,12 @@ _assembleLinearOperator()
 {
   info() << "Assembly of FEM linear operator ";
 
-  // Temporary variable to keep values for the RHS part of the linear system
+  // Temporary variable to keep values for the RHS part of the linear system.
+  // It already contains the volume terms (see _assembleBilinearOperatorTRIA3())
   VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
-  rhs_values.fill(0.0);
 
   auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
 
-
-
   if (options()->enforceDirichletMethod() == "Penalty") {
 
     //----------------------------------------------
@@ -485,22 +1113,18 @@ _assembleLinearOperator()
            << "  - RowColumnElimination\n";
   }
 
+  _assembleBoundaryLinearTerms(rhs_values);
+}
 
-  //----------------------------------------------
-  // Constant source term assembly
-  //----------------------------------------------
-  //
-  //  $int_{Omega}(qdot*v^h)$
-  //  only for nodes that are non-Dirichlet
-  //----------------------------------------------
-  ENUMERATE_ (Cell, icell, allCells()) {
-    Cell cell = *icell;
-    Real area = _computeAreaTriangle3(cell);
-    for (Node node : cell.nodes()) {
-      if (!(m_node_is_temperature_fixed[node]) && node.isOwn())
-        rhs_values[node_dof.dofId(node, 0)] += (m_node_temperature_old[node]/dt) * area / ElementNodes;
-    }
-  }
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add the Neumann and convection terms of the linear operator.
+ */
+void FemModule::
+_assembleBoundaryLinearTerms(VariableDoFReal& rhs_values)
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
 
   //----------------------------------------------
   // Constant flux term assembly
@@ -515,10 +1139,12 @@ _assembleLinearOperator()
     Real value = bs->value();
     ENUMERATE_ (Face, iface, group) {
       Face face = *iface;
-      Real length = _computeEdgeLength2(face);
+      // Length of the edge in 2D, area of the face in 3D
+      Real measure = _computeFaceMeasure(face);
+      Real nb_face_node = face.nbNode();
       for (Node node : iface->nodes()) {
         if (!(m_node_is_temperature_fixed[node]) && node.isOwn())
-          rhs_values[node_dof.dofId(node, 0)] += value * length / 2.;
+          rhs_values[node_dof.dofId(node, 0)] += value * measure / nb_face_node;
       }
     }
   }
@@ -536,14 +1162,14 @@ _assembleLinearOperator()
     Text = bs->Text();
     ENUMERATE_ (Face, iface, group) {
       Face face = *iface;
-      Real length = _computeEdgeLength2(face);
+      Real measure = _computeFaceMeasure(face);
+      Real nb_face_node = face.nbNode();
       for (Node node : iface->nodes()) {
         if (!(m_node_is_temperature_fixed[node]) && node.isOwn())
-          rhs_values[node_dof.dofId(node, 0)] += h * Text * length / 2.;
+          rhs_values[node_dof.dofId(node, 0)] += h * Text * measure / nb_face_node;
       }
     }
   }
-
 }
 
 /*---------------------------------------------------------------------------*/
@@ -608,6 +1234,57 @@ _computeDxDyOfRealTRIA3(Cell cell)
   return DX ;
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Gradient of the temperature in a cell.
+ *
+ * The gradient is constant on TRIA3 and TETRA4 cells. On QUAD4 and HEXA8
+ * cells it is evaluated at the center of the reference element.
+ */
+Real3 FemModule::
+_computeTemperatureGradient(Cell cell)
+{
+  if (cell.type() == IT_Triangle3) {
+    Real2 DX = _computeDxDyOfRealTRIA3(cell);
+    return Real3(DX.x, DX.y, 0.);
+  }
+
+  Int32 nb_node = cell.nbNode();
+  Real3 m[8];
+  for (Int32 i = 0; i < nb_node; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
+
+  Real3 grad[8];
+  if (cell.type() == IT_Tetraedron4)
+    computeGradientsTETRA4(m, grad);
+  else if (cell.type() == IT_Hexaedron8) {
+    Real phi[8];
+    computeShapeFunctionsHEXA8(m, 0., 0., 0., phi, grad);
+  }
+  else if (cell.type() == IT_Quad4) {
+    // Derivatives of the Q1 shape functions at the center: 0.25 * (xi_i, eta_i)
+    const Real xi_n[4] = { -1., 1., 1., -1. };
+    const Real eta_n[4] = { -1., -1., 1., 1. };
+    Real3 j_xi, j_eta;
+    for (Int32 i = 0; i < 4; ++i) {
+      j_xi += 0.25 * xi_n[i] * m[i];
+      j_eta += 0.25 * eta_n[i] * m[i];
+    }
+    Real det_j = j_xi.x * j_eta.y - j_xi.y * j_eta.x;
+    for (Int32 i = 0; i < 4; ++i)
+      grad[i] = Real3(0.25 * (j_eta.y * xi_n[i] - j_xi.y * eta_n[i]) / det_j,
+                      0.25 * (-j_eta.x * xi_n[i] + j_xi.x * eta_n[i]) / det_j, 0.);
+  }
+  else
+    ARCANE_FATAL("Cell type '{0}' is not supported", cell.type());
+
+  Real3 gradient;
+  for (Int32 i = 0; i < nb_node; ++i)
+    gradient += m_node_temperature[cell.nodeId(i)] * grad[i];
+  return gradient;
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -648,6 +1325,19 @@ _computeEdgeLength2(Face face)
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+Real FemModule::
+_computeFaceMeasure(Face face)
+{
+  Real3 m[4];
+  Int32 nb_node = face.nbNode();
+  for (Int32 i = 0; i < nb_node; ++i)
+    m[i] = m_node_coord[face.nodeId(i)];
+  return computeFaceMeasure(m, nb_node);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 FixedMatrix<2, 2> FemModule::
 _computeElementMatrixEDGE2(Face face)
 {
@@ -699,7 +1389,7 @@ _computeElementMatrixEDGE2(Face face)
 /*---------------------------------------------------------------------------*/
 
 FixedMatrix<3, 3> FemModule::
-_computeElementMatrixTRIA3(Cell cell)
+_computeElementMatrixTRIA3(Cell cell, Real area)
 {
   // Get coordinates of the triangle element  TRI3
   //------------------------------------------------
@@ -713,8 +1403,6 @@ _computeElementMatrixTRIA3(Cell cell)
   Real3 m1 = m_node_coord[cell.nodeId(1)];
   Real3 m2 = m_node_coord[cell.nodeId(2)];
 
-  Real area = _computeAreaTriangle3(cell);    // calculate area
-
   Real2 dPhi0(m1.y - m2.y, m2.x - m1.x);
   Real2 dPhi1(m2.y - m0.y, m0.x - m2.x);
   Real2 dPhi2(m0.y - m1.y, m1.x - m0.x);
@@ -796,7 +1484,7 @@ _computeElementMatrixTRIA3(Cell cell)
 /*---------------------------------------------------------------------------*/
 
 FixedMatrix<4, 4> FemModule::
-_computeElementMatrixQUAD4(Cell cell)
+_computeElementMatrixQUAD4(Cell cell, Real area)
 {
   // Get coordinates of the quadrangular element  QUAD4
   //------------------------------------------------
@@ -811,8 +1499,6 @@ _computeElementMatrixQUAD4(Cell cell)
   Real3 m2 = m_node_coord[cell.nodeId(2)];
   Real3 m3 = m_node_coord[cell.nodeId(3)];
 
-  Real area = _computeAreaQuad4(cell);    // calculate area
-
   Real2 dPhi0(m2.y - m3.y, m3.x - m2.x);
   Real2 dPhi1(m3.y - m0.y, m0.x - m3.x);
   Real2 dPhi2(m0.y - m1.y, m1.x - m0.x);
@@ -844,14 +1530,16 @@ void FemModule::
 _assembleBilinearOperatorQUAD4()
 {
   auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
 
   ENUMERATE_ (Cell, icell, allCells()) {
     Cell cell = *icell;
     if (cell.type() != IT_Quad4)
       ARCANE_FATAL("Only Quad4 cell type is supported");
 
-    lambda = m_cell_lambda[cell];                 // lambda is always considered cell constant
-    auto K_e = _computeElementMatrixQUAD4(cell);  // element stiffness matrix
+    lambda = m_materials.cellValue(MAT_LAMBDA, cell); // lambda is always considered cell constant
+    Real area = _computeAreaQuad4(cell);          // geometry is computed once per cell
+    auto K_e = _computeElementMatrixQUAD4(cell, area);  // element stiffness matrix
     Int32 n1_index = 0;
     for (Node node1 : cell.nodes()) {
       Int32 n2_index = 0;
@@ -866,6 +1554,8 @@ _assembleBilinearOperatorQUAD4()
       }
       ++n1_index;
     }
+
+    _assembleElementVolumeTerms(cell, area, node_dof, rhs_values);
   }
 }
 
@@ -876,14 +1566,16 @@ void FemModule::
 _assembleBilinearOperatorTRIA3()
 {
   auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
 
   ENUMERATE_ (Cell, icell, allCells()) {
     Cell cell = *icell;
     if (cell.type() != IT_Triangle3)
       ARCANE_FATAL("Only Triangle3 cell type is supported");
 
-    lambda = m_cell_lambda[cell];                 // lambda is always considered cell constant
-    auto K_e = _computeElementMatrixTRIA3(cell);  // element stiffness matrix
+    lambda = _cellConductivity(cell); // lambda is always considered cell constant
+    Real area = _computeAreaTriangle3(cell);      // geometry is computed once per cell
+    auto K_e = _computeElementMatrixTRIA3(cell, area);  // element stiffness matrix
     // assemble elementary matrix into the global one elementary terms are
     // positioned into K according to  the rank of associated  node in the
     // mesh.nodes list and according the dof number. For each TRIA3  there
@@ -903,10 +1595,72 @@ _assembleBilinearOperatorTRIA3()
       }
       ++n1_index;
     }
+
+    _assembleElementVolumeTerms(cell, area, node_dof, rhs_values);
   }
 }
 
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/**
+ * Adds the volume terms of the linear operator (RHS - vector b) of a cell
+ *
+ *   $int_{Omega}(T_old/dt*v^h)$ (lumped)  +  $int_{Omega}(qdot*v^h)$
+ *
+ * only for nodes that are non-Dirichlet. The heat source is the sum of 'qdot'
+ * and of the field given by 'source-field'. In 3D \a area is the volume of
+ * the cell.
+ */
+void FemModule::
+_assembleElementVolumeTerms(Cell cell, Real area, IndexedNodeDoFConnectivityView node_dof,
+                            VariableDoFReal& rhs_values)
+{
+  Real b_e[8] = { 0., 0., 0., 0., 0., 0., 0., 0. };
+  _computeElementSourceTerms(cell, area, b_e);
+
+  Int32 n_index = 0;
+  for (Node node : cell.nodes()) {
+    if (!(m_node_is_temperature_fixed[node]) && node.isOwn())
+      rhs_values[node_dof.dofId(node, 0)] += (m_node_temperature_old[node] / dt) * area / ElementNodes + b_e[n_index];
+    ++n_index;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add the integrals of the heat source times the shape functions of
+ * \a cell to \a b_e.
+ */
+void FemModule::
+_computeElementSourceTerms(Cell cell, Real area, Real b_e[8])
+{
+  Int32 nb_node = cell.nbNode();
+
+  Real qdot_cell = qdot;
+  if (m_use_cell_source)
+    qdot_cell += m_cell_qdot[cell];
+
+  Real qdot_node[8] = { 0., 0., 0., 0., 0., 0., 0., 0. };
+  if (m_use_node_source)
+    for (Int32 i = 0; i < nb_node; ++i)
+      qdot_node[i] = m_node_qdot[cell.nodeId(i)];
+
+  Real3 m[8];
+  for (Int32 i = 0; i < nb_node; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
+
+  if (cell.type() == IT_Quad4)
+    addSourceTermQUAD4(m, qdot_cell, qdot_node, b_e);
+  else if (cell.type() == IT_Hexaedron8)
+    addSourceTermHEXA8(m, qdot_cell, qdot_node, b_e);
+  else if (cell.type() == IT_Tetraedron4)
+    addSourceTermTETRA4(area, qdot_cell, qdot_node, b_e);
+  else
+    addSourceTermTRIA3(area, qdot_cell, qdot_node, b_e);
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -942,6 +1696,94 @@ _assembleBilinearOperatorEDGE2()
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+/*!
+ * \brief Assemble the bilinear operator and the volume terms of the linear
+ * operator for TETRA4 and HEXA8 cells.
+ *
+ *   lambda*(dx(u)dx(v) + dy(u)dy(v) + dz(u)dz(v)) + uv/dt
+ */
+void FemModule::
+_assembleBilinearOperator3D()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    Int32 nb_node = cell.nbNode();
+    if (cell.type() != IT_Tetraedron4 && cell.type() != IT_Hexaedron8)
+      ARCANE_FATAL("Only Tetraedron4 and Hexaedron8 cell types are supported");
+
+    lambda = m_materials.cellValue(MAT_LAMBDA, cell); // lambda is always considered cell constant
+
+    Real3 m[8];
+    for (Int32 i = 0; i < nb_node; ++i)
+      m[i] = m_node_coord[cell.nodeId(i)];
+
+    // element stiffness matrix, the volume is computed with it
+    Real K_e[64];
+    Real volume = 0.;
+    if (nb_node == 8)
+      volume = computeStiffnessMatrixHEXA8(m, K_e);
+    else
+      volume = computeStiffnessMatrixTETRA4(m, K_e);
+    for (Int32 k = 0; k < nb_node * nb_node; ++k)
+      K_e[k] *= lambda;
+    if (nb_node == 8)
+      addMassMatrixHEXA8(m, 1. / dt, K_e);
+    else
+      addMassMatrixTETRA4(volume, 1. / dt, K_e);
+
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      if (node1.isOwn()) {
+        Int32 n2_index = 0;
+        for (Node node2 : cell.nodes()) {
+          m_linear_system.matrixAddValue(node_dof.dofId(node1, 0), node_dof.dofId(node2, 0), K_e[n1_index * nb_node + n2_index]);
+          ++n2_index;
+        }
+      }
+      ++n1_index;
+    }
+
+    _assembleElementVolumeTerms(cell, volume, node_dof, rhs_values);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Assemble the convection term int_{dOmega_C}(h*u*v) on the faces
+ * of a 3D mesh.
+ *
+ * Unlike _assembleBilinearOperatorEDGE2(), the face mass matrix is lumped:
+ * each node of the face gets h * measure / nb_face_node on its diagonal.
+ * This is consistent with the lumped right hand side of the convection.
+ */
+void FemModule::
+_assembleBilinearOperatorFace3D()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  for (const auto& bs : options()->convectionBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+    h = bs->h();
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+      Real v = h * _computeFaceMeasure(face) / face.nbNode();
+      for (Node node : face.nodes()) {
+        if (node.isOwn()) {
+          DoFLocalId dof_id = node_dof.dofId(node, 0);
+          m_linear_system.matrixAddValue(dof_id, dof_id, v);
+        }
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 void FemModule::
 _solve()
 {
@@ -964,34 +1806,7 @@ _solve()
     m_node_temperature.synchronize();
     m_node_temperature_old.synchronize();
 
-    if(m_flux.tagValue("PostProcessing")=="1") {
-      ENUMERATE_ (Cell, icell, allCells()) {
-        Cell cell = *icell;
-
-        //m_dx_node_temperature[cell] = _computeDyOfRealTRIA3(cell);
-
-        Real2 DX = _computeDxDyOfRealTRIA3(cell);
-        m_flux[cell].x = -m_cell_lambda[cell] * DX.x;
-        m_flux[cell].y = -m_cell_lambda[cell] * DX.y;
-        m_flux[cell].z = 0.;
-        /*
-        Real3 x0 = m_node_coord[cell.nodeId(0)];
-        Real3 x1 = m_node_coord[cell.nodeId(1)];
-        Real3 x2 = m_node_coord[cell.nodeId(2)];
-
-        Real f0 = m_node_temperature[cell.nodeId(0)];
-        Real f1 = m_node_temperature[cell.nodeId(1)];
-        Real f2 = m_node_temperature[cell.nodeId(2)];
-
-        // Using Cramer's rule  det (adj (A)) / det (A)
-        m_dx_node_temperature[cell]  =    f0*(x1.y - x2.y) - x0.y*(f1 - f2) + (f1*x2.y - f2*x1.y);
-        m_dx_node_temperature[cell] /=  ( x0.x*(x1.y - x2.y) - x0.y*(x1.x - x2.x) + (x1.x*x2.y - x2.x*x1.y) );
-        */
-      }
-
-      m_flux.synchronize();
-    }
-
+    _computeFlux();
   }
   const bool do_print = (allNodes().size() < 200);
   if (do_print) {
@@ -1017,6 +1832,39 @@ _solve()
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+void FemModule::
+_computeFlux()
+{
+  if(m_flux.tagValue("PostProcessing")=="1") {
+    ENUMERATE_ (Cell, icell, allCells()) {
+      Cell cell = *icell;
+
+      //m_dx_node_temperature[cell] = _computeDyOfRealTRIA3(cell);
+
+      Real cell_lambda = _cellConductivity(cell);
+      m_flux[cell] = -cell_lambda * _computeTemperatureGradient(cell);
+      /*
+      Real3 x0 = m_node_coord[cell.nodeId(0)];
+      Real3 x1 = m_node_coord[cell.nodeId(1)];
+      Real3 x2 = m_node_coord[cell.nodeId(2)];
+
+      Real f0 = m_node_temperature[cell.nodeId(0)];
+      Real f1 = m_node_temperature[cell.nodeId(1)];
+      Real f2 = m_node_temperature[cell.nodeId(2)];
+
+      // Using Cramer's rule  det (adj (A)) / det (A)
+      m_dx_node_temperature[cell]  =    f0*(x1.y - x2.y) - x0.y*(f1 - f2) + (f1*x2.y - f2*x1.y);
+      m_dx_node_temperature[cell] /=  ( x0.x*(x1.y - x2.y) - x0.y*(x1.x - x2.x) + (x1.x*x2.y - x2.x*x1.y) );
+      */
+    }
+
+    m_flux.synchronize();
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 void FemModule::
 _checkResultFile()
 {
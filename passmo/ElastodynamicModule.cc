@@ -3,16 +3,25 @@
 #include <arcane/utils/NumArray.h>
 #include <arcane/utils/MultiArray2.h>
 #include "arcane/utils/ArgumentException.h"
+#include <arcane/utils/PlatformUtils.h>
+#include <arcane/utils/Numeric.h>
 #include <arcane/IParallelMng.h>
 #include <arcane/ITimeLoopMng.h>
 #include <arcane/IMesh.h>
 #include <arcane/IItemFamily.h>
+#include <arcane/ItemTypeMng.h>
+#include <arcane/ItemTypeInfo.h>
 #include <arcane/ItemGroup.h>
 #include <arcane/ICaseMng.h>
 #include <arcane/geometry/IGeometry.h>
 #include <arcane/IIOMng.h>
 #include <arcane/CaseTable.h>
 
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <tuple>
+
 #include "IDoFLinearSystemFactory.h"
 #include "Integer3std.h"
 #include "ElastodynamicModule.h"
@@ -27,6 +36,9 @@ using namespace Arcane::FemUtils;
 ElastodynamicModule::ElastodynamicModule(const ModuleBuildInfo& mbi)
         : ArcaneElastodynamicObject(mbi)
         , m_dofs_on_nodes(mbi.subDomain()->traceMng())
+        , m_materials(mbi.subDomain()->traceMng())
+        , m_stored_k(mbi.subDomain())
+        , m_stored_m(mbi.subDomain())
 {
     ICaseMng *cm = mbi.subDomain()->caseMng();
     cm->setTreatWarningAsError(true);
@@ -97,6 +109,8 @@ startInit(){
 
   cell_fem.set_node_coords(m_node_coord);
   gausspt.init_order(integ_order);
+  m_sf_kernel.init(NDIM, integ_order);
+  m_use_sum_factorization = options()->getSumFactorization();
 
   String dirichletMethod = options()->enforceDirichletMethod();
 
@@ -128,6 +142,33 @@ startInit(){
   _applyInitialNodeConditions();
   _initCells();
   _initBoundaryConditions();
+  _initContactConditions();
+
+  if (options()->getSumFactorizationBenchmark())
+    _benchmarkSumFactorization();
+
+  m_use_p_multigrid = options()->getPMultigrid();
+  if (m_use_p_multigrid)
+    _initPMultigrid();
+
+  m_use_static_pre_stress = options()->getStaticPreStress();
+  if (m_use_static_pre_stress)
+    _doStaticPreStress();
+
+  // The active set iterations of the contact conditions assemble the
+  // operator several times per time step: form it from the stored K and M
+  // instead of integrating the cells again
+  if (has_contact && !m_has_stored_operators) {
+    _assembleStoredOperators();
+    m_has_stored_operators = true;
+  }
+
+  // If requested and the operator is constant for the whole run, the matrix
+  // is kept after the first solve (not with contact conditions which modify
+  // the operator)
+  m_freeze_matrix = options()->getFreezeMatrix() && keep_constop && !has_contact;
+  if (m_freeze_matrix)
+    m_linear_system.setMatrixFrozen(true);
 }
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -136,6 +177,105 @@ _initDofs(){
   m_dofs_on_nodes.initialize(mesh(),NDIM);
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// Prolongation of the p-multigrid preconditioner: the coarse level has the
+// DoFs of the vertices of the cells (the DoFs of the linear elements Tri3,
+// Quad4, Tetra4, Hexa8), the fine level has all the DoFs of the quadratic
+// elements. A vertex DoF is copied, a mid-node DoF is interpolated with the
+// shape functions of the linear element at the reference position of the
+// mid-node.
+void ElastodynamicModule::
+_initPMultigrid(){
+
+  ItemTypeMng* type_mng = mesh()->itemTypeMng();
+  UniqueArray<Int32> coarse_node(mesh()->nodeFamily()->maxLocalId());
+  coarse_node.fill(-1);
+  Int32 nb_coarse_node{0}, nb_quadratic_cell{0};
+
+  ENUMERATE_CELL (icell, allCells()) {
+    const Cell& cell = *icell;
+    auto linear_type = getLinearItemType(cell.type());
+    if (linear_type != cell.type()) ++nb_quadratic_cell;
+    Int32 nb_vertex = type_mng->typeFromId(linear_type)->nbLocalNode();
+
+    for (Int32 inod = 0; inod < nb_vertex; ++inod) {
+      Int32 lid = cell.node(inod).localId();
+      if (coarse_node[lid] < 0) coarse_node[lid] = nb_coarse_node++;
+    }
+  }
+
+  if (!nb_quadratic_cell) {
+    info() << "No quadratic cell: the p-multigrid preconditioner is not used";
+    m_use_p_multigrid = false;
+    return;
+  }
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Int32 nb_dof = m_dofs_on_nodes.dofFamily()->allItems().size();
+  m_pmg_nb_coarse_dof = NDIM * nb_coarse_node;
+  m_pmg_rows.resize(nb_dof);
+  m_pmg_rows_nb_column.resize(nb_dof);
+  m_pmg_columns.clear();
+  m_pmg_values.clear();
+
+  Int32 vertex[8];
+  Real weight[8];
+
+  ENUMERATE_NODE (inode, allNodes()) {
+    const Node& node = *inode;
+    Int32 nb_weight{0};
+
+    if (coarse_node[node.localId()] >= 0) {
+      vertex[0] = coarse_node[node.localId()];
+      weight[0] = 1.;
+      nb_weight = 1;
+    }
+    else {
+      // Mid-node: interpolated from the vertices of the first cell
+      const Cell& cell = node.cell(0);
+      Int32 nnod = cell.nbNode(), inod{0};
+      for (; inod < nnod; ++inod)
+        if (cell.node(inod) == node) break;
+
+      auto linear_type = getLinearItemType(cell.type());
+      Int32 nb_vertex = type_mng->typeFromId(linear_type)->nbLocalNode();
+      auto ref_coord = getLinearNodeRefPosition(cell.type(), inod);
+
+      for (Int32 jnod = 0; jnod < nb_vertex; ++jnod) {
+        auto wt = cell_fem.getShapeFuncVal(linear_type, jnod, ref_coord);
+        if (math::abs(wt) < REL_PREC) continue;
+        vertex[nb_weight] = coarse_node[cell.node(jnod).localId()];
+        weight[nb_weight++] = wt;
+      }
+    }
+
+    for (Int32 i = 0; i < NDIM; ++i) {
+      DoFLocalId dof = node_dof.dofId(node, i);
+      m_pmg_rows[dof] = m_pmg_columns.size();
+      m_pmg_rows_nb_column[dof] = nb_weight;
+      for (Int32 k = 0; k < nb_weight; ++k) {
+        m_pmg_columns.add(NDIM * vertex[k] + i);
+        m_pmg_values.add(weight[k]);
+      }
+    }
+  }
+
+  info() << "p-multigrid preconditioner: nb_quadratic_cell=" << nb_quadratic_cell
+         << " nb_dof=" << nb_dof << " nb_coarse_dof=" << m_pmg_nb_coarse_dof;
+
+  m_linear_system.setPMultigridProlongation(_pMultigridProlongation(), m_pmg_nb_coarse_dof);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+CSRFormatView ElastodynamicModule::
+_pMultigridProlongation() const{
+  return { m_pmg_rows.constSpan(), m_pmg_rows_nb_column.constSpan(),
+           m_pmg_columns.constSpan(), m_pmg_values.constSpan() };
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 void ElastodynamicModule::
@@ -181,8 +321,46 @@ _initCells(){
   }
 
  _applyInitialCellConditions();
+ _initMaterials();
  }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Group the cells with the same elastic properties in materials
+// Derived coefficients (rho*cs, rho*cp) are computed once per material and
+// the kernels read them through the material index of the cell.
+void ElastodynamicModule::
+_initMaterials(){
+
+  m_materials.initialize(mesh(), "Passmo", MAT_NB_COEFFICIENT);
+  std::map<std::tuple<Real, Real, Real>, Int32> material_map;
+
+  ENUMERATE_CELL (icell, allCells()) {
+    const Cell& cell = *icell;
+    auto rho = m_rho[cell];
+    auto lambda = m_lambda[cell];
+    auto mu = m_mu[cell];
+
+    auto key = std::make_tuple(rho, lambda, mu);
+    auto iter = material_map.find(key);
+    Int32 mat_index;
+    if (iter != material_map.end())
+      mat_index = iter->second;
+    else {
+      // Material 0 is created by initialize()
+      mat_index = (material_map.empty()) ? 0 : m_materials.addMaterial();
+      material_map[key] = mat_index;
+      m_materials.setValue(MAT_RHO, mat_index, rho);
+      m_materials.setValue(MAT_LAMBDA, mat_index, lambda);
+      m_materials.setValue(MAT_MU, mat_index, mu);
+      m_materials.setValue(MAT_RHOCS, mat_index, rho * m_vs[cell]);
+      m_materials.setValue(MAT_RHOCP, mat_index, rho * m_vp[cell]);
+    }
+    m_materials.setCellMaterial(cell, mat_index);
+  }
+  info() << "Number of materials=" << m_materials.nbMaterial();
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 void ElastodynamicModule::
@@ -346,13 +524,27 @@ compute(){
   // Set if we want to keep the matrix structure between calls
   // the rate is a user input (linop_nstep)
   // The matrix has to have the same structure (same structure for non-zero)
+  // With 'freeze-matrix', the matrix is frozen in the linear system after
+  // the first solve: the imposed displacements then only change the RHS
+  // vector. The operator depends on dt2, so it is assembled again when the
+  // time step changes (last step shortened to reach the final time).
+  if (m_linear_system.hasFrozenMatrix() && dt2 != m_matrix_dt2) {
+    info() << "Time step changed: assemble the frozen matrix again";
+    m_linear_system.setMatrixFrozen(false);
+    m_linear_system.setMatrixFrozen(true);
+  }
   if (m_linear_system.isInitialized() && (linop_nstep_counter < linop_nstep || keep_constop)){
-    m_linear_system.clearValues();
+    if (!m_linear_system.hasFrozenMatrix())
+      m_linear_system.clearValues();
   }
   else {
     m_linear_system.reset();
     m_linear_system.setLinearSystemFactory(options()->linearSystem());
     m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
+    if (m_freeze_matrix)
+      m_linear_system.setMatrixFrozen(true);
+    if (m_use_p_multigrid)
+      m_linear_system.setPMultigridProlongation(_pMultigridProlongation(), m_pmg_nb_coarse_dof);
 
     // Reset the counter when the linear operator is reset
     linop_nstep_counter = 0;
@@ -363,18 +555,28 @@ compute(){
   _applyNeumannBoundaryConditions();
   info() << "NB_CELL=" << allCells().size() << " NB_FACE=" << allFaces().size();
 
-  // Assemble the FEM global operators (LHS matrix/RHS vector b)
-  if (NDIM <= 2) {
-    _assembleLinearLHS2D();
-    _assembleLinearRHS2D();
+  if (has_contact) {
+    // Active set iterations: assemble and solve until the contact status
+    // of the slave nodes does not change
+    _doContactSolve();
   }
   else {
-    _assembleLinearLHS3D();
-    _assembleLinearRHS3D();
-  }
+    // Assemble the FEM global operators (LHS matrix/RHS vector b)
+    bool has_frozen_matrix = m_linear_system.hasFrozenMatrix();
+    if (NDIM <= 2) {
+      if (!has_frozen_matrix)
+        _assembleLinearLHS2D();
+      _assembleLinearRHS2D();
+    }
+    else {
+      if (!has_frozen_matrix)
+        _assembleLinearLHS3D();
+      _assembleLinearRHS3D();
+    }
 
-  // Solve the linear system AX = B
-  _doSolve();
+    // Solve the linear system AX = B
+    _doSolve();
+  }
 
   // Update the nodal variable according to the integration scheme (e.g. Newmark)
   _updateNewmark();
@@ -1101,8 +1303,9 @@ _computeK3D(const Cell& cell,const Int32& ig, const RealUniqueArray& vec, const
   // 8 nodes for a lin element/20 nodes for a quadratic one
   FixedMatrix<3,20> Bmat;
 
-  auto lambda = m_lambda(cell);
-  auto mu = m_mu(cell);
+  auto mat_index = m_materials.materialIndex(cell);
+  auto lambda = m_materials.value(MAT_LAMBDA, mat_index);
+  auto mu = m_materials.value(MAT_MU, mat_index);
   auto a{ lambda + 2.*mu };
 
   for (int i = 0; i <  3; ++i)
@@ -1242,7 +1445,7 @@ void ElastodynamicModule::
 _computeM3D(const Cell& cell,const Int32& ig, const RealUniqueArray& vec, const Real& jacobian, FixedMatrix<60,60>& Me){
 
   Int32 nb_nodes = cell.nbNode();
-  auto rho = m_rho(cell);
+  auto rho = m_materials.cellValue(MAT_RHO, cell);
 
   auto wt = vec[ig] * jacobian;
   for (Int32 inod = 0, iig = 4; inod < nb_nodes; ++inod) {
@@ -1282,8 +1485,9 @@ _computeK2D(const Cell& cell,const Int32& ig, const RealUniqueArray& vec, const
     // 4 nodes for a lin element/9 nodes for a quadratic one
     FixedMatrix<2,9> Bmat;
 
-    auto lambda = m_lambda(cell);
-    auto mu = m_mu(cell);
+    auto mat_index = m_materials.materialIndex(cell);
+    auto lambda = m_materials.value(MAT_LAMBDA, mat_index);
+    auto mu = m_materials.value(MAT_MU, mat_index);
     auto a{ lambda + 2.*mu };
 
     for (int i = 0; i <  2; ++i)
@@ -1382,7 +1586,7 @@ void ElastodynamicModule::
 _computeM2D(const Cell& cell,const Int32& ig, const RealUniqueArray& vec, const Real& jacobian, FixedMatrix<18,18>& Me){
 
     Int32 nb_nodes = cell.nbNode();
-    auto rho = m_rho(cell);
+    auto rho = m_materials.cellValue(MAT_RHO, cell);
 
     auto wt = vec[ig] * jacobian;
     for (Int32 inod = 0, iig = 4; inod < nb_nodes; ++inod) {
@@ -1554,6 +1758,15 @@ _assembleLinearLHS3D()
     rhs_values.fill(0.0);
     auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
 
+    // Time step of the operator (also when it is formed from the stored K
+    // and M): a frozen matrix is assembled again if it changes
+    m_matrix_dt2 = dt2;
+
+    if (m_has_stored_operators) {
+      _assembleLinearLHSFromStoredOperators();
+      return;
+    }
+
     info() << "Assembly of the 3D FEM bilinear (LHS - matrix A) operator ";
 
     ENUMERATE_ (Cell, icell, allCells()) {
@@ -1574,21 +1787,8 @@ _assembleLinearLHS3D()
       }
       }
 
-      // Loop on the cell Gauss points to compute integrals terms
-      Int32 ngauss{ 0 };
-      auto vec = cell_fem.getGaussData(cell, integ_order, ngauss);
-
-      for (Int32 igauss = 0, ig = 0; igauss < ngauss; ++igauss, ig += 4*(1 + nb_nodes)) {
-
-        auto jacobian {0.};
-        auto jac = _computeJacobian3D(cell, ig, vec, jacobian);
-
-        // Computing elementary mass matrix at Gauss point ig
-        _computeM3D(cell, ig, vec, jacobian, Me);
-
-        // Computing elementary stiffness matrix at Gauss point ig
-        _computeK3D(cell, ig, vec, jac, Ke);
-
+      // Add Me/beta/dt^2 + Ke to the global bilinear operator (LHS)
+      auto add_element_lhs = [&]() {
         // Considering a simple Newmark scheme here (Generalized-alfa will be done later)
         // Computing Me/beta/dt^2 + Ke
         Int32 n1_index{ 0 };
@@ -1619,8 +1819,203 @@ _assembleLinearLHS3D()
           }
           ++n1_index;
         }
+      };
+
+      // Tensor-product cell: the matrices are integrated over all the
+      // Gauss points with the sum-factorized kernels and assembled once
+      if (m_use_sum_factorization && m_sf_kernel.isSupported(cell)) {
+        auto mat_index = m_materials.materialIndex(cell);
+        Real3 coord[8];
+        for (Int32 inod = 0; inod < nb_nodes; ++inod)
+          coord[inod] = m_node_coord[cell.node(inod)];
+        m_sf_kernel.computeElementMatrices3D(coord, m_materials.value(MAT_LAMBDA, mat_index),
+                                           m_materials.value(MAT_MU, mat_index),
+                                           m_materials.value(MAT_RHO, mat_index), Ke, Me);
+        add_element_lhs();
+        continue;
       }
+
+      // Loop on the cell Gauss points to compute integrals terms
+      Int32 ngauss{ 0 };
+      auto vec = cell_fem.getGaussData(cell, integ_order, ngauss);
+
+      for (Int32 igauss = 0, ig = 0; igauss < ngauss; ++igauss, ig += 4*(1 + nb_nodes)) {
+
+        auto jacobian {0.};
+        auto jac = _computeJacobian3D(cell, ig, vec, jacobian);
+
+        // Computing elementary mass matrix at Gauss point ig
+        _computeM3D(cell, ig, vec, jacobian, Me);
+
+        // Computing elementary stiffness matrix at Gauss point ig
+        _computeK3D(cell, ig, vec, jac, Ke);
+
+        add_element_lhs();
+      }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Benchmark of the elementary kernels on the Quad4/Hexa8 cells of the mesh
+// for integration orders 1 to 4:
+//  - dense: stiffness and mass matrices computed Gauss point by Gauss point
+//    (_computeK2D/3D, _computeM2D/3D) and summed,
+//  - sum-factorized: SumFactorizationKernel::computeElementMatrices2D/3D(),
+//  - matrix-free: SumFactorizationKernel::applyStiffness2D/3D().
+// The sum-factorized results are checked against the dense ones. This is the
+// only caller of applyStiffness2D/3D(): the linear systems are always
+// assembled, the matrix-free action is only timed here.
+void ElastodynamicModule::
+_benchmarkSumFactorization()
+{
+  info() << "Benchmark of the sum-factorized elementary kernels";
+
+  Int32 nb_cell{ 0 };
+  ENUMERATE_ (Cell, icell, allCells()) {
+    if (m_sf_kernel.isSupported(*icell))
+      ++nb_cell;
+  }
+  if (!nb_cell) {
+    info() << "No Quad4/Hexa8 cell in the mesh: nothing to benchmark";
+    return;
+  }
+
+  // Displacement field used for the matrix-free kernel
+  auto u_field = [&](const Real3& x) {
+    return Real3(sin(x.x + 2. * x.y), cos(x.y - x.z), (NDIM == 3) ? x.x * x.z : 0.);
+  };
+
+  Integer3 nint;
+  FixedMatrix<60,60> K_dense;
+  FixedMatrix<60,60> Ke, Me;
+  FixedMatrix<18,18> Ke2D, Me2D;
+
+  // Stiffness matrix summed over the Gauss points of the cell (dense kernels)
+  auto compute_dense = [&](const Cell& cell) {
+    auto size{ NDIM * cell.nbNode() };
+    for (Int32 i = 0; i < size; ++i)
+      for (Int32 j = 0; j < size; ++j)
+        K_dense(i, j) = 0.;
+
+    Int32 ngauss{ 0 };
+    auto vec = cell_fem.getGaussData(cell, nint, ngauss);
+    for (Int32 igauss = 0, ig = 0; igauss < ngauss; ++igauss, ig += 4*(1 + cell.nbNode())) {
+      auto jacobian {0.};
+      if (NDIM == 3) {
+        auto jac = _computeJacobian3D(cell, ig, vec, jacobian);
+        _computeM3D(cell, ig, vec, jacobian, Me);
+        _computeK3D(cell, ig, vec, jac, Ke);
+        for (Int32 i = 0; i < size; ++i)
+          for (Int32 j = 0; j < size; ++j)
+            K_dense(i, j) += Ke(i, j);
+      }
+      else {
+        auto jac = _computeJacobian2D(cell, ig, vec, jacobian);
+        _computeM2D(cell, ig, vec, jacobian, Me2D);
+        _computeK2D(cell, ig, vec, jac, Ke2D);
+        for (Int32 i = 0; i < size; ++i)
+          for (Int32 j = 0; j < size; ++j)
+            K_dense(i, j) += Ke2D(i, j);
+      }
+    }
+  };
+
+  auto get_coords = [&](const Cell& cell, Real3 coord[8]) {
+    for (Int32 inod = 0; inod < cell.nbNode(); ++inod)
+      coord[inod] = m_node_coord[cell.node(inod)];
+  };
+
+  auto compute_sum_factorized = [&](const Cell& cell) {
+    auto mat_index = m_materials.materialIndex(cell);
+    Real3 coord[8];
+    get_coords(cell, coord);
+    if (NDIM == 3)
+      m_sf_kernel.computeElementMatrices3D(coord, m_materials.value(MAT_LAMBDA, mat_index),
+                                         m_materials.value(MAT_MU, mat_index),
+                                         m_materials.value(MAT_RHO, mat_index), Ke, Me);
+    else
+      m_sf_kernel.computeElementMatrices2D(coord, m_materials.value(MAT_LAMBDA, mat_index),
+                                         m_materials.value(MAT_MU, mat_index),
+                                         m_materials.value(MAT_RHO, mat_index), Ke2D, Me2D);
+  };
+
+  auto apply_matrix_free = [&](const Cell& cell, Real3 y[8]) {
+    auto mat_index = m_materials.materialIndex(cell);
+    Real3 coord[8], u[8];
+    get_coords(cell, coord);
+    for (Int32 inod = 0; inod < cell.nbNode(); ++inod)
+      u[inod] = u_field(coord[inod]);
+    if (NDIM == 3)
+      m_sf_kernel.applyStiffness3D(coord, m_materials.value(MAT_LAMBDA, mat_index),
+                                   m_materials.value(MAT_MU, mat_index), u, y);
+    else
+      m_sf_kernel.applyStiffness2D(coord, m_materials.value(MAT_LAMBDA, mat_index),
+                                   m_materials.value(MAT_MU, mat_index), u, y);
+  };
+
+  for (Int32 order = 1; order <= 4; ++order) {
+    nint = Integer3(order, order, (NDIM == 3) ? order : 0);
+    m_sf_kernel.init(NDIM, nint);
+
+    Real t0 = platform::getRealTime();
+    ENUMERATE_ (Cell, icell, allCells()) {
+      if (m_sf_kernel.isSupported(*icell))
+        compute_dense(*icell);
     }
+    Real t1 = platform::getRealTime();
+    ENUMERATE_ (Cell, icell, allCells()) {
+      if (m_sf_kernel.isSupported(*icell))
+        compute_sum_factorized(*icell);
+    }
+    Real t2 = platform::getRealTime();
+    ENUMERATE_ (Cell, icell, allCells()) {
+      Real3 y[8];
+      if (m_sf_kernel.isSupported(*icell))
+        apply_matrix_free(*icell, y);
+    }
+    Real t3 = platform::getRealTime();
+
+    // Check the sum-factorized kernels against the dense ones
+    Real max_k{ 0. }, max_k_diff{ 0. }, max_y{ 0. }, max_y_diff{ 0. };
+    ENUMERATE_ (Cell, icell, allCells()) {
+      Cell cell = *icell;
+      if (!m_sf_kernel.isSupported(cell))
+        continue;
+      auto nb_nodes{ cell.nbNode() };
+      compute_dense(cell);
+      compute_sum_factorized(cell);
+      Real3 y[8], coord[8];
+      apply_matrix_free(cell, y);
+      get_coords(cell, coord);
+
+      for (Int32 i = 0; i < NDIM * nb_nodes; ++i) {
+        auto y_dense{ 0. };
+        for (Int32 j = 0; j < NDIM * nb_nodes; ++j) {
+          auto kij = (NDIM == 3) ? Ke(i, j) : Ke2D(i, j);
+          max_k = math::max(max_k, math::abs(K_dense(i, j)));
+          max_k_diff = math::max(max_k_diff, math::abs(K_dense(i, j) - kij));
+          y_dense += K_dense(i, j) * u_field(coord[j / NDIM])[j % NDIM];
+        }
+        max_y = math::max(max_y, math::abs(y_dense));
+        max_y_diff = math::max(max_y_diff, math::abs(y_dense - y[i / NDIM][i % NDIM]));
+      }
+    }
+
+    auto dense_time = t1 - t0, sf_time = t2 - t1, mf_time = t3 - t2;
+    info() << "Sum-factorization nint=" << order << " nb_cell=" << nb_cell
+           << " nb_gauss=" << m_sf_kernel.nbGaussPoint()
+           << " dense=" << dense_time << "s"
+           << " sum-factorized=" << sf_time << "s (speedup=" << dense_time / math::max(sf_time, REL_PREC) << ")"
+           << " matrix-free=" << mf_time << "s (speedup=" << dense_time / math::max(mf_time, REL_PREC) << ")";
+    info() << "Sum-factorization nint=" << order
+           << " relative error Ke=" << max_k_diff / math::max(max_k, REL_PREC)
+           << " Ke.u=" << max_y_diff / math::max(max_y, REL_PREC);
+    if (max_k_diff > 1.e-10 * max_k || max_y_diff > 1.e-10 * max_y)
+      ARCANE_FATAL("Sum-factorized kernels differ from the dense ones for nint={0}", order);
+  }
+
+  m_sf_kernel.init(NDIM, integ_order);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1637,7 +2032,7 @@ _assembleLinearRHS3D(){
 
     ENUMERATE_ (Cell, icell, allCells()) {
       Cell cell = *icell;
-      auto rho = m_rho(cell);
+      auto rho = m_materials.cellValue(MAT_RHO, cell);
       auto nb_nodes{ cell.nbNode() };
 
       // Setting the elementary matrices + force vector sizes for the max number of nodes
@@ -1699,7 +2094,8 @@ _assembleLinearRHS3D(){
               //! Other forces (imposed nodal forces, body forces)
               --------------------------------------------------*/
               {
-                if (options()->hasBodyf()) {
+                // With a static pre-stress the gravity is balanced by the initial stresses
+                if (options()->hasBodyf() && !m_use_static_pre_stress) {
                   //----------------------------------------------
                   // Body force terms
                   //----------------------------------------------
@@ -1778,6 +2174,15 @@ _assembleLinearLHS2D()
     rhs_values.fill(0.0);
     auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
 
+    // Time step of the operator (also when it is formed from the stored K
+    // and M): a frozen matrix is assembled again if it changes
+    m_matrix_dt2 = dt2;
+
+    if (m_has_stored_operators) {
+      _assembleLinearLHSFromStoredOperators();
+      return;
+    }
+
     info() << "Assembly of the FEM 2D bilinear (LHS - matrix A) operator ";
 
     ENUMERATE_ (Cell, icell, allCells()) {
@@ -1799,21 +2204,8 @@ _assembleLinearLHS2D()
         }
       }
 
-      // Loop on the cell Gauss points to compute integrals terms
-      Int32 ngauss{ 0 };
-      auto vec = cell_fem.getGaussData(cell, integ_order, ngauss);
-
-      for (Int32 igauss = 0, ig = 0; igauss < ngauss; ++igauss, ig += 4*(1 + nb_nodes)) {
-
-        auto jacobian {0.};
-        auto jac = _computeJacobian2D(cell, ig, vec, jacobian);
-
-        // Computing elementary mass matrix at Gauss point ig
-        _computeM2D(cell, ig, vec, jacobian, Me);
-
-        // Computing elementary stiffness matrix at Gauss point ig
-        _computeK2D(cell, ig, vec, jac, Ke);
-
+      // Add Me/beta/dt^2 + Ke to the global bilinear operator (LHS)
+      auto add_element_lhs = [&]() {
         // Considering a simple Newmark scheme here (Generalized-alfa will be done later)
         // Computing Me/beta/dt^2 + Ke
         Int32 n1_index{ 0 };
@@ -1842,6 +2234,38 @@ _assembleLinearLHS2D()
           }
           ++n1_index;
         }
+      };
+
+      // Tensor-product cell: the matrices are integrated over all the
+      // Gauss points with the sum-factorized kernels and assembled once
+      if (m_use_sum_factorization && m_sf_kernel.isSupported(cell)) {
+        auto mat_index = m_materials.materialIndex(cell);
+        Real3 coord[4];
+        for (Int32 inod = 0; inod < nb_nodes; ++inod)
+          coord[inod] = m_node_coord[cell.node(inod)];
+        m_sf_kernel.computeElementMatrices2D(coord, m_materials.value(MAT_LAMBDA, mat_index),
+                                           m_materials.value(MAT_MU, mat_index),
+                                           m_materials.value(MAT_RHO, mat_index), Ke, Me);
+        add_element_lhs();
+        continue;
+      }
+
+      // Loop on the cell Gauss points to compute integrals terms
+      Int32 ngauss{ 0 };
+      auto vec = cell_fem.getGaussData(cell, integ_order, ngauss);
+
+      for (Int32 igauss = 0, ig = 0; igauss < ngauss; ++igauss, ig += 4*(1 + nb_nodes)) {
+
+        auto jacobian {0.};
+        auto jac = _computeJacobian2D(cell, ig, vec, jacobian);
+
+        // Computing elementary mass matrix at Gauss point ig
+        _computeM2D(cell, ig, vec, jacobian, Me);
+
+        // Computing elementary stiffness matrix at Gauss point ig
+        _computeK2D(cell, ig, vec, jac, Ke);
+
+        add_element_lhs();
       }
     }
 }
@@ -1860,7 +2284,7 @@ _assembleLinearRHS2D(){
 
     ENUMERATE_ (Cell, icell, allCells()) {
       Cell cell = *icell;
-      auto rho = m_rho(cell);
+      auto rho = m_materials.cellValue(MAT_RHO, cell);
       auto nb_nodes{ cell.nbNode() };
 
       auto size{2*nb_nodes};
@@ -1919,7 +2343,8 @@ _assembleLinearRHS2D(){
               // Other forces (imposed nodal forces, body forces)
               //-------------------------------------------------*/
               {
-                if (options()->hasBodyf()) {
+                // With a static pre-stress the gravity is balanced by the initial stresses
+                if (options()->hasBodyf() && !m_use_static_pre_stress) {
                   //----------------------------------------------
                   // Body force terms
                   //----------------------------------------------
@@ -2045,15 +2470,16 @@ _getParaxialContribution3D(Arcane::VariableDoFReal& rhs_values){
 
         if (face.isSubDomainBoundary() && face.isOwn()) {
 
+          Real rhocs, rhocp;
           if (is_inner) {
-            const Cell& cell = face.boundaryCell();
-            rho = m_rho[cell];
-            cs = m_vs[cell];
-            cp = m_vp[cell];
+            auto mat_index = m_materials.materialIndex(face.boundaryCell());
+            rhocs = m_materials.value(MAT_RHOCS, mat_index);
+            rhocp = m_materials.value(MAT_RHOCP, mat_index);
+          }
+          else {
+            rhocs = rho * cs;
+            rhocp = rho * cp;
           }
-
-          auto rhocs{ rho * cs };
-          auto rhocp{ rho * cp };
 
           // In 3D, a quadratic face element has max 9 nodes (27 dofs)
           auto nb_nodes{face.nbNode()};
@@ -2178,15 +2604,16 @@ _getParaxialContribution2D(Arcane::VariableDoFReal& rhs_values){
 
         if (face.isSubDomainBoundary() && face.isOwn()) {
 
+          Real rhocs, rhocp;
           if (is_inner) {
-            const Cell& cell = face.boundaryCell();
-            rho = m_rho[cell];
-            cs = m_vs[cell];
-            cp = m_vp[cell];
+            auto mat_index = m_materials.materialIndex(face.boundaryCell());
+            rhocs = m_materials.value(MAT_RHOCS, mat_index);
+            rhocp = m_materials.value(MAT_RHOCP, mat_index);
+          }
+          else {
+            rhocs = rho * cs;
+            rhocp = rho * cp;
           }
-
-          auto rhocs{ rho * cs };
-          auto rhocp{ rho * cp };
 
           // In 2D, a quadratic edge element has max 3 nodes (6 dofs)
           auto nb_nodes{face.nbNode()};
@@ -2368,6 +2795,596 @@ _doSolve(){
 
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Static pre-stress phase: gravity equilibrium K u_s = f_g
+// The supports of this phase are the DoFs with an imposed displacement,
+// velocity or acceleration and the nodes of the paraxial boundaries, with
+// u_s = 0. The stiffness and mass matrices are stored to form the dynamic
+// operator M/(beta dt^2) + K without integrating the cells again and the
+// stresses of u_s are added to m_stress. As K u_s balances the gravity, the
+// dynamic run does not apply the body forces and m_displ is the displacement
+// relative to the static state m_static_displ.
+void ElastodynamicModule::
+_doStaticPreStress()
+{
+  info() << "Static pre-stress phase (gravity equilibrium)";
+  _assembleStoredOperators();
+  m_has_stored_operators = true;
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  auto rows_index = m_stored_k.m_matrix_row.to1DSpan();
+  auto rows_nb_column = m_stored_k.m_matrix_rows_nb_column.to1DSpan();
+  auto columns = m_stored_k.m_matrix_column.to1DSpan();
+  auto k_values = m_stored_k.m_matrix_value.to1DSpan();
+  auto m_values = m_stored_m.m_matrix_value.to1DSpan();
+
+  DoFLinearSystem static_system;
+  static_system.setLinearSystemFactory(options()->linearSystem());
+  static_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "StaticSolver");
+  VariableDoFReal& rhs_values(static_system.rhsVariable());
+  rhs_values.fill(0.0);
+
+  // Nodes of the paraxial boundaries
+  UniqueArray<Byte> is_paraxial_node(mesh()->nodeFamily()->maxLocalId(), 0);
+  for (const auto& bs : options()->paraxialBoundaryCondition()) {
+    ENUMERATE_ (Face, iface, bs->surface()) {
+      for (Node node : iface->nodes())
+        is_paraxial_node[node.localId()] = 1;
+    }
+  }
+
+  String dirichletMethod = options()->enforceDirichletMethod();
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    for (Int32 iddl = 0; iddl < NDIM; ++iddl) {
+      DoFLocalId node_dofi = node_dof.dofId(node, iddl);
+      Int32 row = node_dofi.localId();
+      Int32 end = rows_index[row] + rows_nb_column[row];
+
+      // K and body forces: the rows of M only couple the same components so
+      // that the integral of rho * Phi_i * g is g times the sum of the row of M
+      auto mass{ 0. };
+      for (Int32 k = rows_index[row]; k < end; ++k) {
+        static_system.matrixAddValue(node_dofi, DoFLocalId(columns[k]), k_values[k]);
+        mass += m_values[k];
+      }
+      if (options()->hasBodyf())
+        rhs_values[node_dofi] = mass * gravity[iddl];
+
+      bool is_support = is_paraxial_node[node.localId()] || (bool)m_imposed_displ[node][iddl]
+      || (bool)m_imposed_vel[node][iddl] || (bool)m_imposed_acc[node][iddl];
+      if (!is_support)
+        continue;
+      if (dirichletMethod == "Penalty") {
+        static_system.matrixSetValue(node_dofi, node_dofi, penalty);
+        rhs_values[node_dofi] = 0.;
+      }
+      else if (dirichletMethod == "WeakPenalty") {
+        static_system.matrixAddValue(node_dofi, node_dofi, penalty);
+        rhs_values[node_dofi] = 0.;
+      }
+      else if (dirichletMethod == "RowElimination") {
+        static_system.eliminateRow(node_dofi, 0.);
+      }
+      else if (dirichletMethod.contains("RowColumnElimination")) {
+        static_system.eliminateRowColumn(node_dofi, 0.);
+      }
+    }
+  }
+
+  info() << "Solving the static linear system";
+  static_system.solve();
+
+  {
+    VariableDoFReal& dof_d(static_system.solutionVariable());
+    ENUMERATE_ (Node, inode, ownNodes()) {
+      Node node = *inode;
+      Real3 u;
+      for (Int32 iddl = 0; iddl < NDIM; ++iddl)
+        u[iddl] = dof_d[node_dof.dofId(node, iddl)];
+      m_static_displ[node] = u;
+    }
+  }
+  m_static_displ.synchronize();
+
+  Real max_displ{ 0. };
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    max_displ = math::max(max_displ, m_static_displ[inode].normL2());
+  }
+  max_displ = parallelMng()->reduce(Parallel::ReduceMax, max_displ);
+  info() << "Static pre-stress phase: max |u_s| = " << max_displ;
+  _checkStaticDisplResultFile();
+
+  _addPreStress();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Check the static displacements against a reference file
+// Each line contains the unique id of a node and its NDIM reference
+// components. Only the listed nodes are checked (relative epsilon).
+void ElastodynamicModule::
+_checkStaticDisplResultFile()
+{
+  String filename = options()->staticDisplResultFile();
+  info() << "CheckStaticDisplResultFile filename=" << filename;
+  if (filename.empty())
+    return;
+  const Real epsilon = 1.0e-4;
+
+  std::map<Int64, Real3> reference_values;
+  {
+    std::ifstream sbuf(filename.localstr());
+    if (!sbuf)
+      ARCANE_FATAL("Can not open file '{0}'", filename);
+    sbuf >> std::ws;
+    while (!sbuf.eof()) {
+      Int64 uid{ 0 };
+      Real3 u;
+      sbuf >> uid;
+      for (Int32 iddl = 0; iddl < NDIM; ++iddl)
+        sbuf >> std::ws >> u[iddl];
+      if (sbuf.fail() || sbuf.bad())
+        ARCANE_FATAL("Error during parsing of file '{0}'", filename);
+      reference_values[uid] = u;
+      sbuf >> std::ws;
+    }
+  }
+
+  Int32 nb_error{ 0 };
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    auto x_ref = reference_values.find(inode->uniqueId());
+    if (x_ref == reference_values.end())
+      continue;
+    Real3 u = m_static_displ[inode];
+    for (Int32 iddl = 0; iddl < NDIM; ++iddl) {
+      if (!TypeEqualT<Real>::isNearlyEqualWithEpsilon(x_ref->second[iddl], u[iddl], epsilon)) {
+        ++nb_error;
+        info() << "ERROR: uid=" << inode->uniqueId() << " component=" << iddl
+               << " ref=" << x_ref->second[iddl] << " v=" << u[iddl];
+      }
+    }
+  }
+  nb_error = parallelMng()->reduce(Parallel::ReduceSum, nb_error);
+  if (nb_error > 0)
+    ARCANE_FATAL("Error checking the static displacements nb_error={0}", nb_error);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Compute the stiffness (K) and mass (M) matrices of the own rows and
+// store them in CSR format (same pattern for both matrices)
+void ElastodynamicModule::
+_assembleStoredOperators()
+{
+  info() << "Assembly of the stiffness and mass matrices (stored for the whole run)";
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  IItemFamily* dof_family = m_dofs_on_nodes.dofFamily();
+  m_stored_k.initializeFromNodeCellPattern(mesh(), dof_family, node_dof, NDIM);
+  m_stored_m.initializeFromNodeCellPattern(mesh(), dof_family, node_dof, NDIM);
+
+  // Add the elementary matrices Ke and Me of a cell to the stored ones
+  auto add_element = [&](Cell cell, auto& Ke, auto& Me) {
+    Int32 n1_index{ 0 };
+    for (Node node1 : cell.nodes()) {
+      if (node1.isOwn()) {
+        for (Int32 iddl = 0; iddl < NDIM; ++iddl) {
+          DoFLocalId node1_dofi = node_dof.dofId(node1, iddl);
+          auto ii = NDIM * n1_index + iddl;
+          Int32 n2_index{ 0 };
+          for (Node node2 : cell.nodes()) {
+            for (Int32 jddl = 0; jddl < NDIM; ++jddl) {
+              DoFLocalId node2_dofj = node_dof.dofId(node2, jddl);
+              auto jj = NDIM * n2_index + jddl;
+              m_stored_k.matrixAddValue(node1_dofi, node2_dofj, Ke(ii, jj));
+              m_stored_m.matrixAddValue(node1_dofi, node2_dofj, Me(ii, jj));
+            }
+            ++n2_index;
+          }
+        }
+      }
+      ++n1_index;
+    }
+  };
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    auto nb_nodes{ cell.nbNode() };
+    bool use_sum_factorization = m_use_sum_factorization && m_sf_kernel.isSupported(cell);
+    auto mat_index = m_materials.materialIndex(cell);
+    Int32 ngauss{ 0 };
+
+    if (NDIM <= 2) {
+      FixedMatrix<18,18> Me;
+      FixedMatrix<18,18> Ke;
+      for (Int32 i = 0; i < 18; ++i)
+        for (Int32 j = 0; j < 18; ++j) {
+          Me(i,j) = 0.;
+          Ke(i,j) = 0.;
+        }
+      if (use_sum_factorization) {
+        Real3 coord[4];
+        for (Int32 inod = 0; inod < nb_nodes; ++inod)
+          coord[inod] = m_node_coord[cell.node(inod)];
+        m_sf_kernel.computeElementMatrices2D(coord, m_materials.value(MAT_LAMBDA, mat_index),
+                                             m_materials.value(MAT_MU, mat_index),
+                                             m_materials.value(MAT_RHO, mat_index), Ke, Me);
+        add_element(cell, Ke, Me);
+        continue;
+      }
+      auto vec = cell_fem.getGaussData(cell, integ_order, ngauss);
+      for (Int32 igauss = 0, ig = 0; igauss < ngauss; ++igauss, ig += 4*(1 + nb_nodes)) {
+        auto jacobian {0.};
+        auto jac = _computeJacobian2D(cell, ig, vec, jacobian);
+        _computeM2D(cell, ig, vec, jacobian, Me);
+        _computeK2D(cell, ig, vec, jac, Ke);
+        add_element(cell, Ke, Me);
+      }
+    }
+    else {
+      FixedMatrix<60,60> Me;
+      FixedMatrix<60,60> Ke;
+      for (Int32 i = 0; i < 60; ++i)
+        for (Int32 j = 0; j < 60; ++j) {
+          Me(i,j) = 0.;
+          Ke(i,j) = 0.;
+        }
+      if (use_sum_factorization) {
+        Real3 coord[8];
+        for (Int32 inod = 0; inod < nb_nodes; ++inod)
+          coord[inod] = m_node_coord[cell.node(inod)];
+        m_sf_kernel.computeElementMatrices3D(coord, m_materials.value(MAT_LAMBDA, mat_index),
+                                             m_materials.value(MAT_MU, mat_index),
+                                             m_materials.value(MAT_RHO, mat_index), Ke, Me);
+        add_element(cell, Ke, Me);
+        continue;
+      }
+      auto vec = cell_fem.getGaussData(cell, integ_order, ngauss);
+      for (Int32 igauss = 0, ig = 0; igauss < ngauss; ++igauss, ig += 4*(1 + nb_nodes)) {
+        auto jacobian {0.};
+        auto jac = _computeJacobian3D(cell, ig, vec, jacobian);
+        _computeM3D(cell, ig, vec, jacobian, Me);
+        _computeK3D(cell, ig, vec, jac, Ke);
+        add_element(cell, Ke, Me);
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Assemble the bilinear operator M/(beta dt^2) + K from the stored matrices
+void ElastodynamicModule::
+_assembleLinearLHSFromStoredOperators()
+{
+  info() << "Assembly of the FEM bilinear (LHS - matrix A) operator from the stored K and M";
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  auto rows_index = m_stored_k.m_matrix_row.to1DSpan();
+  auto rows_nb_column = m_stored_k.m_matrix_rows_nb_column.to1DSpan();
+  auto columns = m_stored_k.m_matrix_column.to1DSpan();
+  auto k_values = m_stored_k.m_matrix_value.to1DSpan();
+  auto m_values = m_stored_m.m_matrix_value.to1DSpan();
+
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    for (Int32 iddl = 0; iddl < NDIM; ++iddl) {
+      DoFLocalId node_dofi = node_dof.dofId(*inode, iddl);
+      Int32 row = node_dofi.localId();
+      for (Int32 k = rows_index[row], end = rows_index[row] + rows_nb_column[row]; k < end; ++k)
+        m_linear_system.matrixAddValue(node_dofi, DoFLocalId(columns[k]), m_values[k] / beta / dt2 + k_values[k]);
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Add the strains and stresses of the static displacement to the initial
+// ones (mean over the Gauss points of the cell, plane strain in 2D)
+void ElastodynamicModule::
+_addPreStress()
+{
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    auto nb_nodes{ cell.nbNode() };
+    auto lambda = m_materials.cellValue(MAT_LAMBDA, cell);
+    auto mu = m_materials.cellValue(MAT_MU, cell);
+
+    // grad_u[i][j] = d(u_i)/d(x_j) integrated over the cell
+    Real3x3 grad_u;
+    auto volume{ 0. };
+    Int32 ngauss{ 0 };
+    auto vec = cell_fem.getGaussData(cell, integ_order, ngauss);
+    for (Int32 igauss = 0, ig = 0; igauss < ngauss; ++igauss, ig += 4*(1 + nb_nodes)) {
+      auto jacobian {0.};
+      Real3x3 ijac;
+      if (NDIM == 3) {
+        auto jac = _computeJacobian3D(cell, ig, vec, jacobian);
+        ijac = math::inverseMatrix(jac);
+      }
+      else {
+        auto jac = _computeJacobian2D(cell, ig, vec, jacobian);
+        ijac.x.x = jac.y.y / jacobian;
+        ijac.x.y = -jac.x.y / jacobian;
+        ijac.y.x = -jac.y.x / jacobian;
+        ijac.y.y = jac.x.x / jacobian;
+      }
+      auto wt = vec[ig] * jacobian;
+      volume += wt;
+
+      for (Int32 inod = 0, iig = 4; inod < nb_nodes; ++inod) {
+        Real3 dPhi {vec[ig + iig + 1], vec[ig + iig + 2], (NDIM == 3) ? vec[ig + iig + 3] : 0.};
+        Real3 b{ ijac.x.x * dPhi.x + ijac.x.y * dPhi.y + ijac.x.z * dPhi.z,
+                 ijac.y.x * dPhi.x + ijac.y.y * dPhi.y + ijac.y.z * dPhi.z,
+                 ijac.z.x * dPhi.x + ijac.z.y * dPhi.y + ijac.z.z * dPhi.z };
+        auto u = m_static_displ[cell.node(inod)];
+        grad_u.x += wt * u.x * b;
+        grad_u.y += wt * u.y * b;
+        grad_u.z += wt * u.z * b;
+        iig += 4;
+      }
+    }
+    grad_u = grad_u / volume;
+
+    Real3x3 eps;
+    eps.x = Real3(grad_u.x.x, 0.5 * (grad_u.x.y + grad_u.y.x), 0.5 * (grad_u.x.z + grad_u.z.x));
+    eps.y = Real3(eps.x.y, grad_u.y.y, 0.5 * (grad_u.y.z + grad_u.z.y));
+    eps.z = Real3(eps.x.z, eps.y.z, grad_u.z.z);
+    auto tr = eps.x.x + eps.y.y + eps.z.z;
+    Real3x3 sigma = 2. * mu * eps;
+    sigma.x.x += lambda * tr;
+    sigma.y.y += lambda * tr;
+    sigma.z.z += lambda * tr;
+
+    m_strain[cell] += eps;
+    m_stress[cell] += sigma;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+void ElastodynamicModule::
+_initContactConditions()
+{
+  contact_max_iter = options()->getContactMaxIterations();
+  m_contact_active.fill(0);
+
+  // The pairs are searched among the local nodes only: a slave node and its
+  // master node may be in different subdomains in parallel
+  if (options()->contactCondition().size() > 0 && subDomain()->parallelMng()->isParallel())
+    ARCANE_FATAL("Contact conditions are not supported in parallel (node pairs are searched in the local subdomain)");
+
+  // Nodal normals of the master surfaces (indexed by the node localId)
+  UniqueArray<Real3> master_normals(mesh()->nodeFamily()->maxLocalId());
+
+  for (const auto& bc : options()->contactCondition()) {
+    has_contact = true;
+    FaceGroup slave_group = bc->slaveSurface();
+    FaceGroup master_group = bc->masterSurface();
+    NodeGroup master_nodes = master_group.nodeGroup();
+
+    // The normal on a master node is the average of the outward normals
+    // of the master faces connected to this node
+    master_normals.fill(Real3::zero());
+    ENUMERATE_FACE (iface, master_group) {
+      const Face& face = *iface;
+      Real3 e1{ 0. }, e2{ 0. }, e3{ 0. };
+      DirVectors(face, m_node_coord, NDIM, e1, e2, e3);
+      Real3 normal = (NDIM == 3) ? e3 : e2;
+      for (Node node : face.nodes())
+        master_normals[node.localId()] += normal;
+    }
+
+    // Each slave node is paired with the nearest master node (the surfaces are
+    // assumed to be close and to have matching or similar discretizations).
+    // The master nodes are sorted by their x coordinate: the search starts
+    // from the position of the slave node and stops in each direction when
+    // the x distance alone is larger than the current minimal distance.
+    UniqueArray<std::pair<Real, Node>> sorted_masters;
+    ENUMERATE_NODE (jnode, master_nodes) {
+      sorted_masters.add(std::make_pair(m_node_coord[*jnode].x, *jnode));
+    }
+    std::sort(sorted_masters.begin(), sorted_masters.end(),
+              [](const std::pair<Real, Node>& a, const std::pair<Real, Node>& b) { return a.first < b.first; });
+    const Int32 nb_master = sorted_masters.size();
+
+    ENUMERATE_NODE (inode, slave_group.nodeGroup()) {
+      Node slave_node = *inode;
+      const Real3& xs = m_node_coord[slave_node];
+      Node master_node;
+      Real min_dist2{ 0. };
+      auto check_master = [&](Int32 k) {
+        Real dx = sorted_masters[k].first - xs.x;
+        if (!master_node.null() && dx * dx >= min_dist2)
+          return false;
+        Real3 d = m_node_coord[sorted_masters[k].second] - xs;
+        Real dist2 = math::dot(d, d);
+        if (master_node.null() || dist2 < min_dist2) {
+          master_node = sorted_masters[k].second;
+          min_dist2 = dist2;
+        }
+        return true;
+      };
+      auto first_upper = std::lower_bound(sorted_masters.begin(), sorted_masters.end(), xs.x,
+                                          [](const std::pair<Real, Node>& a, Real x) { return a.first < x; });
+      const Int32 start = static_cast<Int32>(first_upper - sorted_masters.begin());
+      for (Int32 k = start; k < nb_master && check_master(k); ++k) {
+      }
+      for (Int32 k = start - 1; k >= 0 && check_master(k); --k) {
+      }
+      if (master_node.null())
+        continue;
+
+      ContactPair pair;
+      pair.slave_node = slave_node;
+      pair.master_node = master_node;
+      pair.normal = master_normals[master_node.localId()];
+      pair.normal.normalize();
+      pair.gap = math::dot(xs - m_node_coord[master_node], pair.normal);
+      pair.penalty = bc->getPenalty();
+      m_contact_pairs.add(pair);
+    }
+    info() << "Contact condition between " << slave_group.name() << " (slave) and "
+           << master_group.name() << " (master)";
+  }
+  info() << "Number of contact pairs=" << m_contact_pairs.size();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+void ElastodynamicModule::
+_doContactSolve()
+{
+  //----------------------------------------------------------------------
+  // Active set (semi-smooth Newton) iterations for the frictionless contact
+  // conditions. The first iteration uses the active set converged at the
+  // previous time step (stored in m_contact_active), and each solve starts
+  // from the solution of the previous one.
+  // Only the contact terms change between two iterations: the operator is
+  // formed from the stored K and M (see startInit()) and the RHS vector is
+  // assembled at the first iteration and kept, the solve may modify it.
+  //----------------------------------------------------------------------
+  m_linear_system.setSolutionAsInitialGuess(true);
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
+
+  for (Int32 iter = 0; iter < contact_max_iter; ++iter) {
+    if (iter > 0)
+      m_linear_system.clearValues();
+
+    if (NDIM <= 2)
+      _assembleLinearLHS2D();
+    else
+      _assembleLinearLHS3D();
+
+    if (iter == 0) {
+      if (NDIM <= 2)
+        _assembleLinearRHS2D();
+      else
+        _assembleLinearRHS3D();
+      m_contact_rhs.copy(rhs_values.asArray());
+    }
+    else {
+      rhs_values.asArray().copy(m_contact_rhs);
+      _assembleDirichletMatrixContribution();
+    }
+    _assembleContactContribution();
+
+    _doSolve();
+
+    info() << "Contact iteration " << iter + 1;
+    if (_updateContactActiveSet() == 0)
+      return;
+  }
+  info() << "Contact active set has not converged after " << contact_max_iter << " iterations";
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Apply the Dirichlet conditions to the matrix only (same methods as in
+// _assembleLinearRHS2D/3D(), the RHS vector is not modified)
+void ElastodynamicModule::
+_assembleDirichletMatrixContribution()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  String dirichletMethod = options()->enforceDirichletMethod();
+
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    auto node = *inode;
+
+    for (Int32 iddl = 0; iddl < NDIM; ++iddl) {
+      if (!(bool)m_imposed_displ[node][iddl])
+        continue;
+      auto node_dofi = node_dof.dofId(node, iddl);
+      auto u_iddl = m_displ[node][iddl];
+      if (dirichletMethod == "Penalty")
+        m_linear_system.matrixSetValue(node_dofi, node_dofi, penalty);
+      else if (dirichletMethod == "WeakPenalty")
+        m_linear_system.matrixAddValue(node_dofi, node_dofi, penalty);
+      else if (dirichletMethod == "RowElimination")
+        m_linear_system.eliminateRow(node_dofi, u_iddl);
+      else if (dirichletMethod == "RowColumnElimination")
+        m_linear_system.eliminateRowColumn(node_dofi, u_iddl);
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+void ElastodynamicModule::
+_assembleContactContribution()
+{
+  //----------------------------------------------------------------------
+  // With d = (u_s - u_m).n the relative normal displacement of a pair and g
+  // its initial gap, the non-penetration constraint g + d >= 0 is enforced
+  // on the active pairs by adding the energy 1/2 * p * (g + d)^2:
+  //   A += p * B^T.B   and   b -= p * g * B^T
+  // with B = (n, -n) for the (slave, master) DoFs.
+  //----------------------------------------------------------------------
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  const Real sign[2] = { 1., -1. };
+
+  for (const ContactPair& pair : m_contact_pairs) {
+    if (!m_contact_active[pair.slave_node])
+      continue;
+
+    const Node pair_nodes[2] = { pair.slave_node, pair.master_node };
+    for (Int32 a = 0; a < 2; ++a) {
+      const Node& node1 = pair_nodes[a];
+      if (!node1.isOwn())
+        continue;
+
+      for (Int32 iddl = 0; iddl < NDIM; ++iddl) {
+        DoFLocalId node1_dofi = node_dof.dofId(node1, iddl);
+        auto bi = sign[a] * pair.normal[iddl];
+
+        for (Int32 b = 0; b < 2; ++b) {
+          for (Int32 jddl = 0; jddl < NDIM; ++jddl) {
+            auto node2_dofj = node_dof.dofId(pair_nodes[b], jddl);
+            auto bj = sign[b] * pair.normal[jddl];
+            m_linear_system.matrixAddValue(node1_dofi, node2_dofj, pair.penalty * bi * bj);
+          }
+        }
+        rhs_values[node1_dofi] -= pair.penalty * pair.gap * bi;
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Update the contact status of the slave nodes from the current displacements
+// and return the number of nodes whose status has changed (for all subdomains)
+Int32 ElastodynamicModule::
+_updateContactActiveSet()
+{
+  Int32 nb_change{ 0 }, nb_active{ 0 };
+
+  for (const ContactPair& pair : m_contact_pairs) {
+    const Node& slave_node = pair.slave_node;
+    if (!slave_node.isOwn())
+      continue;
+
+    // An active node stays active while the contact pressure p * (g + d)
+    // is compressive, an inactive node becomes active if it penetrates
+    auto dn = math::dot(m_displ[slave_node] - m_displ[pair.master_node], pair.normal);
+    Byte is_active = (pair.gap + dn < 0.) ? 1 : 0;
+
+    if (is_active != m_contact_active[slave_node]) {
+      m_contact_active[slave_node] = is_active;
+      ++nb_change;
+    }
+    if (is_active)
+      ++nb_active;
+  }
+  m_contact_active.synchronize();
+
+  IParallelMng* pm = subDomain()->parallelMng();
+  nb_change = pm->reduce(Parallel::ReduceSum, nb_change);
+  nb_active = pm->reduce(Parallel::ReduceSum, nb_active);
+  info() << "Contact active set: nb_active=" << nb_active << " nb_change=" << nb_change;
+  return nb_change;
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 ARCANE_REGISTER_MODULE_ELASTODYNAMIC(ElastodynamicModule);
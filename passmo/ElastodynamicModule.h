@@ -5,8 +5,11 @@
 #include "Elastodynamic_axl.h"
 #include "FemUtils.h"
 #include "utilFEM.h"
+#include "SumFactorizationKernel.h"
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
+#include "FemMaterialTable.h"
+#include "CsrFormatMatrix.h"
 
 
 /*---------------------------------------------------------------------------*/
@@ -63,6 +66,15 @@ private:
    DoFLinearSystem m_linear_system;
    FemDoFsOnNodes m_dofs_on_nodes;
 
+   //! Materials (cells with the same elastic properties) and their coefficients
+   FemMaterialTable m_materials;
+   static constexpr Int32 MAT_RHO = 0;
+   static constexpr Int32 MAT_LAMBDA = 1;
+   static constexpr Int32 MAT_MU = 2;
+   static constexpr Int32 MAT_RHOCS = 3; //!< rho * cs
+   static constexpr Int32 MAT_RHOCP = 4; //!< rho * cp
+   static constexpr Int32 MAT_NB_COEFFICIENT = 5;
+
    // Struct to make sure we are using a CaseTable associated
    // to the right file
    struct CaseTableInfo
@@ -85,6 +97,23 @@ private:
    UniqueArray<CaseTableInfo> m_vel_case_table_list;
    UniqueArray<CaseTableInfo> m_force_case_table_list;
 
+   // Node-to-node pair for the frictionless contact conditions
+   struct ContactPair
+   {
+     Node slave_node;
+     Node master_node;
+     //! Unit normal to the master surface (pointing towards the slave surface)
+     Real3 normal;
+     //! Initial normal gap (negative if the slave node penetrates the master surface)
+     Real gap = 0.0;
+     Real penalty = 0.0;
+   };
+   UniqueArray<ContactPair> m_contact_pairs;
+   //! RHS vector without the contact terms (kept during the active set iterations)
+   UniqueArray<Real> m_contact_rhs;
+   bool has_contact{false};
+   Int32 contact_max_iter{20};
+
    // List of CaseTable for paraxial boundary conditions
    // (if incident transient wave fields are defined)
 // TO DO ***   UniqueArray<CaseTableInfo> m_paraxial_case_table_list;
@@ -93,6 +122,21 @@ private:
    Int32 NDIM{2};
    CellFEMDispatcher cell_fem{};
    GaussPointDispatcher gausspt{};
+   //! Sum-factorized kernels for Quad4/Hexa8 cells
+   SumFactorizationKernel m_sf_kernel{};
+   bool m_use_sum_factorization{false};
+   //! Prolongation of the p-multigrid preconditioner (quadratic cells)
+   bool m_use_p_multigrid{false};
+   Int32 m_pmg_nb_coarse_dof{0};
+   UniqueArray<Int32> m_pmg_rows;
+   UniqueArray<Int32> m_pmg_rows_nb_column;
+   UniqueArray<Int32> m_pmg_columns;
+   UniqueArray<Real> m_pmg_values;
+   //! Static pre-stress phase: stiffness and mass matrices kept for the dynamic operator
+   bool m_use_static_pre_stress{false};
+   bool m_has_stored_operators{false};
+   CsrFormat m_stored_k;
+   CsrFormat m_stored_m;
    Real3 gravity{0.,0.,-9.81};
    Real penalty{1.e30};
    Real gamma{0.5};
@@ -101,6 +145,10 @@ private:
    Real alfaf{0.};
    bool is_alfa_method{false},keep_constop{false};
    Real dt2{0.};
+   //! Keep the matrix between the time steps ('freeze-matrix' option)
+   bool m_freeze_matrix{false};
+   //! dt2 of the last assembled matrix
+   Real m_matrix_dt2{0.};
    Int32 linop_nstep{100}, linop_nstep_counter{0};
    TypesElastodynamic::eElastType elast_type{TypesElastodynamic::NoElastPropType};
 
@@ -108,6 +156,7 @@ private:
 
  void _initDofs();
  void _initCells();
+ void _initMaterials();
  void _applyInitialNodeConditions();
  void _applyInitialCellConditions();
 // void _applyInputMotion();
@@ -115,7 +164,20 @@ private:
  void _assembleLinearRHS2D();
  void _assembleLinearLHS3D();
  void _assembleLinearRHS3D();
+ void _benchmarkSumFactorization();
+ void _initPMultigrid();
+ CSRFormatView _pMultigridProlongation() const;
  void _doSolve();
+ void _doStaticPreStress();
+ void _checkStaticDisplResultFile();
+ void _assembleStoredOperators();
+ void _assembleLinearLHSFromStoredOperators();
+ void _addPreStress();
+ void _doContactSolve();
+ void _initContactConditions();
+ void _assembleContactContribution();
+ void _assembleDirichletMatrixContribution();
+ Int32 _updateContactActiveSet();
  void _initBoundaryConditions();
  void _applyDirichletBoundaryConditions();
  void _getParaxialContribution3D(VariableDoFReal& rhs_values);
@@ -0,0 +1,516 @@
+/*
+ * PASSMO : Performant Assessment for Seismic Site Modelling
+ *
+ * Sum-factorized elementary kernels for tensor-product finite-elements
+ * (Quad4 in 2D, Hexa8 in 3D)
+ *
+ * SumFactorizationKernel.cc: definitions
+ */
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+#include <arcane/utils/FatalErrorException.h>
+#include "arcane/MathUtils.h"
+
+#include "SumFactorizationKernel.h"
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// Local (cell) node index of the lexicographic node a + 2*b (+ 4*c), where
+// a, b, c = 0 for the reference coordinate -1 and 1 for +1
+namespace
+{
+const Int32 quad4_node[4] = { 2, 3, 1, 0 };
+const Int32 hexa8_node[8] = { 6, 7, 5, 4, 2, 3, 1, 0 };
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+void SumFactorizationKernel::
+init(const Int32& ndim, const Integer3& nint){
+
+  m_ndim = ndim;
+  m_nint[0] = nint.m_i;
+  m_nint[1] = nint.m_j;
+  m_nint[2] = (ndim == 3) ? nint.m_k : 1;
+
+  for (Int32 idir = 0; idir < ndim; ++idir) {
+    if (m_nint[idir] < 1 || m_nint[idir] > maxnint)
+      ARCANE_FATAL("Invalid number of Gauss points '{0}' for the sum-factorized kernels", m_nint[idir]);
+
+    for (Int32 iq = 0; iq < m_nint[idir]; ++iq) {
+      auto x = getRefPosition(iq, m_nint[idir]);
+      m_weight[idir][iq] = getWeight(iq, m_nint[idir]);
+      m_phi[idir][iq][0] = 0.5 * (1. - x);
+      m_phi[idir][iq][1] = 0.5 * (1. + x);
+      m_dphi[idir][iq][0] = -0.5;
+      m_dphi[idir][iq][1] = 0.5;
+    }
+  }
+  m_work.resize(6 * nbGaussPoint());
+}
+
+/*---------------------------------------------------------------------------*/
+
+bool SumFactorizationKernel::
+isSupported(const ItemWithNodes& cell) const{
+  if (m_ndim == 3)
+    return cell.type() == IT_Hexaedron8;
+  return cell.type() == IT_Quad4;
+}
+
+/*---------------------------------------------------------------------------*/
+
+Int32 SumFactorizationKernel::
+nbGaussPoint() const{
+  return m_nint[0] * m_nint[1] * m_nint[2];
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Reference derivatives of the nodal field v (lexicographic order) at all
+// the Gauss points (index ix + nx * (iy + ny * iz)), one direction at a time
+void SumFactorizationKernel::
+_gradients3D(const Real3 v[8], Real3 dxi[], Real3 deta[], Real3 dzeta[]) const{
+
+  const Int32 nx = m_nint[0], ny = m_nint[1], nz = m_nint[2];
+  const auto& phi0 = m_phi[0];
+  const auto& phi1 = m_phi[1];
+  const auto& phi2 = m_phi[2];
+  const auto& dphi0 = m_dphi[0];
+  const auto& dphi1 = m_dphi[1];
+  const auto& dphi2 = m_dphi[2];
+
+  // Contraction along xi: (a,b,c) -> (ix,b,c)
+  Real3 vb[2][2][maxnint], vd[2][2][maxnint];
+  for (Int32 c = 0; c < 2; ++c)
+    for (Int32 b = 0; b < 2; ++b) {
+      const Real3& v0 = v[2 * b + 4 * c];
+      const Real3& v1 = v[1 + 2 * b + 4 * c];
+      for (Int32 ix = 0; ix < nx; ++ix) {
+        vb[c][b][ix] = phi0[ix][0] * v0 + phi0[ix][1] * v1;
+        vd[c][b][ix] = dphi0[ix][0] * v0 + dphi0[ix][1] * v1;
+      }
+    }
+
+  // Contraction along eta: (ix,b,c) -> (ix,iy,c)
+  Real3 vbb[2][maxnint][maxnint], vbd[2][maxnint][maxnint], vdb[2][maxnint][maxnint];
+  for (Int32 c = 0; c < 2; ++c)
+    for (Int32 iy = 0; iy < ny; ++iy)
+      for (Int32 ix = 0; ix < nx; ++ix) {
+        vbb[c][iy][ix] = phi1[iy][0] * vb[c][0][ix] + phi1[iy][1] * vb[c][1][ix];
+        vbd[c][iy][ix] = dphi1[iy][0] * vb[c][0][ix] + dphi1[iy][1] * vb[c][1][ix];
+        vdb[c][iy][ix] = phi1[iy][0] * vd[c][0][ix] + phi1[iy][1] * vd[c][1][ix];
+      }
+
+  // Contraction along zeta: (ix,iy,c) -> (ix,iy,iz)
+  for (Int32 iz = 0, iq = 0; iz < nz; ++iz)
+    for (Int32 iy = 0; iy < ny; ++iy)
+      for (Int32 ix = 0; ix < nx; ++ix, ++iq) {
+        dxi[iq] = phi2[iz][0] * vdb[0][iy][ix] + phi2[iz][1] * vdb[1][iy][ix];
+        deta[iq] = phi2[iz][0] * vbd[0][iy][ix] + phi2[iz][1] * vbd[1][iy][ix];
+        dzeta[iq] = dphi2[iz][0] * vbb[0][iy][ix] + dphi2[iz][1] * vbb[1][iy][ix];
+      }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Transpose of _gradients3D(): y[l] = sum_q (dPhi_l/dxi * hxi + dPhi_l/deta * heta
+// + dPhi_l/dzeta * hzeta)(q)
+void SumFactorizationKernel::
+_gradientsTranspose3D(const Real3 hxi[], const Real3 heta[], const Real3 hzeta[], Real3 y[8]) const{
+
+  const Int32 nx = m_nint[0], ny = m_nint[1], nz = m_nint[2];
+  const auto& phi0 = m_phi[0];
+  const auto& phi1 = m_phi[1];
+  const auto& phi2 = m_phi[2];
+  const auto& dphi0 = m_dphi[0];
+  const auto& dphi1 = m_dphi[1];
+  const auto& dphi2 = m_dphi[2];
+
+  // Contraction along zeta: (ix,iy,iz) -> (ix,iy,c)
+  Real3 tbb[2][maxnint][maxnint], tbd[2][maxnint][maxnint], tdb[2][maxnint][maxnint];
+  for (Int32 c = 0; c < 2; ++c)
+    for (Int32 iy = 0; iy < ny; ++iy)
+      for (Int32 ix = 0; ix < nx; ++ix) {
+        Real3 sbb, sbd, sdb;
+        for (Int32 iz = 0; iz < nz; ++iz) {
+          auto iq = ix + nx * (iy + ny * iz);
+          sdb += phi2[iz][c] * hxi[iq];
+          sbd += phi2[iz][c] * heta[iq];
+          sbb += dphi2[iz][c] * hzeta[iq];
+        }
+        tbb[c][iy][ix] = sbb;
+        tbd[c][iy][ix] = sbd;
+        tdb[c][iy][ix] = sdb;
+      }
+
+  // Contraction along eta: (ix,iy,c) -> (ix,b,c)
+  Real3 tb[2][2][maxnint], td[2][2][maxnint];
+  for (Int32 c = 0; c < 2; ++c)
+    for (Int32 b = 0; b < 2; ++b)
+      for (Int32 ix = 0; ix < nx; ++ix) {
+        Real3 sb, sd;
+        for (Int32 iy = 0; iy < ny; ++iy) {
+          sb += phi1[iy][b] * tbb[c][iy][ix] + dphi1[iy][b] * tbd[c][iy][ix];
+          sd += phi1[iy][b] * tdb[c][iy][ix];
+        }
+        tb[c][b][ix] = sb;
+        td[c][b][ix] = sd;
+      }
+
+  // Contraction along xi: (ix,b,c) -> (a,b,c)
+  for (Int32 c = 0; c < 2; ++c)
+    for (Int32 b = 0; b < 2; ++b)
+      for (Int32 a = 0; a < 2; ++a) {
+        Real3 s;
+        for (Int32 ix = 0; ix < nx; ++ix)
+          s += phi0[ix][a] * tb[c][b][ix] + dphi0[ix][a] * td[c][b][ix];
+        y[a + 2 * b + 4 * c] = s;
+      }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Same as _gradients3D() for a 2D field (index ix + nx * iy)
+void SumFactorizationKernel::
+_gradients2D(const Real3 v[4], Real3 dxi[], Real3 deta[]) const{
+
+  const Int32 nx = m_nint[0], ny = m_nint[1];
+  const auto& phi0 = m_phi[0];
+  const auto& phi1 = m_phi[1];
+  const auto& dphi0 = m_dphi[0];
+  const auto& dphi1 = m_dphi[1];
+
+  // Contraction along xi: (a,b) -> (ix,b)
+  Real3 vb[2][maxnint], vd[2][maxnint];
+  for (Int32 b = 0; b < 2; ++b)
+    for (Int32 ix = 0; ix < nx; ++ix) {
+      vb[b][ix] = phi0[ix][0] * v[2 * b] + phi0[ix][1] * v[1 + 2 * b];
+      vd[b][ix] = dphi0[ix][0] * v[2 * b] + dphi0[ix][1] * v[1 + 2 * b];
+    }
+
+  // Contraction along eta: (ix,b) -> (ix,iy)
+  for (Int32 iy = 0, iq = 0; iy < ny; ++iy)
+    for (Int32 ix = 0; ix < nx; ++ix, ++iq) {
+      dxi[iq] = phi1[iy][0] * vd[0][ix] + phi1[iy][1] * vd[1][ix];
+      deta[iq] = dphi1[iy][0] * vb[0][ix] + dphi1[iy][1] * vb[1][ix];
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Transpose of _gradients2D()
+void SumFactorizationKernel::
+_gradientsTranspose2D(const Real3 hxi[], const Real3 heta[], Real3 y[4]) const{
+
+  const Int32 nx = m_nint[0], ny = m_nint[1];
+  const auto& phi0 = m_phi[0];
+  const auto& phi1 = m_phi[1];
+  const auto& dphi0 = m_dphi[0];
+  const auto& dphi1 = m_dphi[1];
+
+  // Contraction along eta: (ix,iy) -> (ix,b)
+  Real3 tb[2][maxnint], td[2][maxnint];
+  for (Int32 b = 0; b < 2; ++b)
+    for (Int32 ix = 0; ix < nx; ++ix) {
+      Real3 sb, sd;
+      for (Int32 iy = 0; iy < ny; ++iy) {
+        auto iq = ix + nx * iy;
+        sb += dphi1[iy][b] * heta[iq];
+        sd += phi1[iy][b] * hxi[iq];
+      }
+      tb[b][ix] = sb;
+      td[b][ix] = sd;
+    }
+
+  // Contraction along xi: (ix,b) -> (a,b)
+  for (Int32 b = 0; b < 2; ++b)
+    for (Int32 a = 0; a < 2; ++a) {
+      Real3 s;
+      for (Int32 ix = 0; ix < nx; ++ix)
+        s += phi0[ix][a] * tb[b][ix] + dphi0[ix][a] * td[b][ix];
+      y[a + 2 * b] = s;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Stiffness and mass matrices of a Hexa8 cell integrated over all its Gauss points
+//
+//  Ke(3i+k, 3j+l) = sum_q wt * (lambda * dPhi_i/dx_k * dPhi_j/dx_l
+//                             + mu * dPhi_i/dx_l * dPhi_j/dx_k
+//                             + mu * delta_kl * grad(Phi_i).grad(Phi_j))
+//  Me(3i+k, 3j+k) = sum_q wt * rho * Phi_i * Phi_j
+void SumFactorizationKernel::
+computeElementMatrices3D(const Real3 coord[8], const Real& lambda, const Real& mu, const Real& rho,
+                         FixedMatrix<60,60>& Ke, FixedMatrix<60,60>& Me) const{
+
+  const Int32 nx = m_nint[0], ny = m_nint[1], nz = m_nint[2];
+  const Int32 nq = nbGaussPoint();
+
+  Real3 x[8];
+  for (Int32 l = 0; l < 8; ++l)
+    x[l] = coord[hexa8_node[l]];
+
+  // Rows of the Jacobian matrix at all the Gauss points
+  Real3* jxi = m_work.data();
+  Real3* jeta = jxi + nq;
+  Real3* jzeta = jeta + nq;
+  _gradients3D(x, jxi, jeta, jzeta);
+
+  Real k[24][24] = {};
+  Real m[8][8] = {};
+
+  for (Int32 iz = 0, iq = 0; iz < nz; ++iz)
+    for (Int32 iy = 0; iy < ny; ++iy)
+      for (Int32 ix = 0; ix < nx; ++ix, ++iq) {
+
+        Real3x3 jac(jxi[iq], jeta[iq], jzeta[iq]);
+        auto jacobian = math::matrixDeterminant(jac);
+        if (fabs(jacobian) < REL_PREC)
+          ARCANE_FATAL("Cell jacobian is null");
+        Real3x3 ijac = math::inverseMatrix(jac);
+        auto wt = m_weight[0][ix] * m_weight[1][iy] * m_weight[2][iz] * jacobian;
+
+        // Shape functions and their derivatives in the physical coordinate system
+        Real phi[8];
+        Real3 g[8];
+        for (Int32 l = 0; l < 8; ++l) {
+          Int32 a = l & 1, b = (l >> 1) & 1, c = (l >> 2) & 1;
+          phi[l] = m_phi[0][ix][a] * m_phi[1][iy][b] * m_phi[2][iz][c];
+          Real3 dPhi{ m_dphi[0][ix][a] * m_phi[1][iy][b] * m_phi[2][iz][c],
+                      m_phi[0][ix][a] * m_dphi[1][iy][b] * m_phi[2][iz][c],
+                      m_phi[0][ix][a] * m_phi[1][iy][b] * m_dphi[2][iz][c] };
+          g[l].x = ijac.x.x * dPhi.x + ijac.x.y * dPhi.y + ijac.x.z * dPhi.z;
+          g[l].y = ijac.y.x * dPhi.x + ijac.y.y * dPhi.y + ijac.y.z * dPhi.z;
+          g[l].z = ijac.z.x * dPhi.x + ijac.z.y * dPhi.y + ijac.z.z * dPhi.z;
+        }
+
+        for (Int32 i = 0; i < 8; ++i) {
+          Real3 wgi = wt * g[i];
+          for (Int32 j = i; j < 8; ++j) {
+            auto gg = math::dot(wgi, g[j]);
+            for (Int32 kk = 0; kk < 3; ++kk)
+              for (Int32 ll = 0; ll < 3; ++ll)
+                k[3 * i + kk][3 * j + ll] += lambda * wgi[kk] * g[j][ll] + mu * wgi[ll] * g[j][kk];
+            for (Int32 kk = 0; kk < 3; ++kk)
+              k[3 * i + kk][3 * j + kk] += mu * gg;
+            m[i][j] += wt * rho * phi[i] * phi[j];
+          }
+        }
+      }
+
+  for (Int32 i = 0; i < 24; ++i)
+    for (Int32 j = 0; j < 24; ++j) {
+      Ke(i, j) = 0.;
+      Me(i, j) = 0.;
+    }
+
+  for (Int32 i = 0; i < 8; ++i) {
+    auto inod = hexa8_node[i];
+    for (Int32 j = i; j < 8; ++j) {
+      auto jnod = hexa8_node[j];
+      for (Int32 kk = 0; kk < 3; ++kk) {
+        for (Int32 ll = 0; ll < 3; ++ll) {
+          auto kij = k[3 * i + kk][3 * j + ll];
+          Ke(3 * inod + kk, 3 * jnod + ll) = kij;
+          Ke(3 * jnod + ll, 3 * inod + kk) = kij;
+        }
+        Me(3 * inod + kk, 3 * jnod + kk) = m[i][j];
+        Me(3 * jnod + kk, 3 * inod + kk) = m[i][j];
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Same as computeElementMatrices3D() for a Quad4 cell (plane strain)
+void SumFactorizationKernel::
+computeElementMatrices2D(const Real3 coord[4], const Real& lambda, const Real& mu, const Real& rho,
+                         FixedMatrix<18,18>& Ke, FixedMatrix<18,18>& Me) const{
+
+  const Int32 nx = m_nint[0], ny = m_nint[1];
+  const Int32 nq = nbGaussPoint();
+
+  Real3 x[4];
+  for (Int32 l = 0; l < 4; ++l)
+    x[l] = coord[quad4_node[l]];
+
+  Real3* jxi = m_work.data();
+  Real3* jeta = jxi + nq;
+  _gradients2D(x, jxi, jeta);
+
+  Real k[8][8] = {};
+  Real m[4][4] = {};
+
+  for (Int32 iy = 0, iq = 0; iy < ny; ++iy)
+    for (Int32 ix = 0; ix < nx; ++ix, ++iq) {
+
+      auto jacobian = jxi[iq].x * jeta[iq].y - jxi[iq].y * jeta[iq].x;
+      if (fabs(jacobian) < REL_PREC)
+        ARCANE_FATAL("Cell jacobian is null");
+      auto wt = m_weight[0][ix] * m_weight[1][iy] * jacobian;
+
+      Real phi[4];
+      Real3 g[4];
+      for (Int32 l = 0; l < 4; ++l) {
+        Int32 a = l & 1, b = (l >> 1) & 1;
+        phi[l] = m_phi[0][ix][a] * m_phi[1][iy][b];
+        Real dxi = m_dphi[0][ix][a] * m_phi[1][iy][b];
+        Real deta = m_phi[0][ix][a] * m_dphi[1][iy][b];
+        g[l].x = (jeta[iq].y * dxi - jxi[iq].y * deta) / jacobian;
+        g[l].y = (-jeta[iq].x * dxi + jxi[iq].x * deta) / jacobian;
+        g[l].z = 0.;
+      }
+
+      for (Int32 i = 0; i < 4; ++i) {
+        Real3 wgi = wt * g[i];
+        for (Int32 j = i; j < 4; ++j) {
+          auto gg = math::dot(wgi, g[j]);
+          for (Int32 kk = 0; kk < 2; ++kk)
+            for (Int32 ll = 0; ll < 2; ++ll)
+              k[2 * i + kk][2 * j + ll] += lambda * wgi[kk] * g[j][ll] + mu * wgi[ll] * g[j][kk];
+          for (Int32 kk = 0; kk < 2; ++kk)
+            k[2 * i + kk][2 * j + kk] += mu * gg;
+          m[i][j] += wt * rho * phi[i] * phi[j];
+        }
+      }
+    }
+
+  for (Int32 i = 0; i < 8; ++i)
+    for (Int32 j = 0; j < 8; ++j) {
+      Ke(i, j) = 0.;
+      Me(i, j) = 0.;
+    }
+
+  for (Int32 i = 0; i < 4; ++i) {
+    auto inod = quad4_node[i];
+    for (Int32 j = i; j < 4; ++j) {
+      auto jnod = quad4_node[j];
+      for (Int32 kk = 0; kk < 2; ++kk) {
+        for (Int32 ll = 0; ll < 2; ++ll) {
+          auto kij = k[2 * i + kk][2 * j + ll];
+          Ke(2 * inod + kk, 2 * jnod + ll) = kij;
+          Ke(2 * jnod + ll, 2 * inod + kk) = kij;
+        }
+        Me(2 * inod + kk, 2 * jnod + kk) = m[i][j];
+        Me(2 * jnod + kk, 2 * inod + kk) = m[i][j];
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Matrix-free action y = Ke.u of the stiffness of a Hexa8 cell:
+// grad(u) at the Gauss points -> stresses -> transposed gradient
+void SumFactorizationKernel::
+applyStiffness3D(const Real3 coord[8], const Real& lambda, const Real& mu,
+                 const Real3 u[8], Real3 y[8]) const{
+
+  const Int32 nq = nbGaussPoint();
+
+  Real3 x[8], ul[8], yl[8];
+  for (Int32 l = 0; l < 8; ++l) {
+    x[l] = coord[hexa8_node[l]];
+    ul[l] = u[hexa8_node[l]];
+  }
+
+  Real3* jxi = m_work.data();
+  Real3* jeta = jxi + nq;
+  Real3* jzeta = jeta + nq;
+  Real3* uxi = jzeta + nq;
+  Real3* ueta = uxi + nq;
+  Real3* uzeta = ueta + nq;
+  _gradients3D(x, jxi, jeta, jzeta);
+  _gradients3D(ul, uxi, ueta, uzeta);
+
+  for (Int32 iz = 0, iq = 0; iz < m_nint[2]; ++iz)
+    for (Int32 iy = 0; iy < m_nint[1]; ++iy)
+      for (Int32 ix = 0; ix < m_nint[0]; ++ix, ++iq) {
+
+        Real3x3 jac(jxi[iq], jeta[iq], jzeta[iq]);
+        auto jacobian = math::matrixDeterminant(jac);
+        if (fabs(jacobian) < REL_PREC)
+          ARCANE_FATAL("Cell jacobian is null");
+        Real3x3 ijac = math::inverseMatrix(jac);
+        auto wt = m_weight[0][ix] * m_weight[1][iy] * m_weight[2][iz] * jacobian;
+
+        // Derivatives of u along x, y, z
+        Real3 gx = ijac.x.x * uxi[iq] + ijac.x.y * ueta[iq] + ijac.x.z * uzeta[iq];
+        Real3 gy = ijac.y.x * uxi[iq] + ijac.y.y * ueta[iq] + ijac.y.z * uzeta[iq];
+        Real3 gz = ijac.z.x * uxi[iq] + ijac.z.y * ueta[iq] + ijac.z.z * uzeta[iq];
+
+        // Stresses (rows of the symmetric stress tensor)
+        auto ltr = lambda * (gx.x + gy.y + gz.z);
+        auto sxy = mu * (gx.y + gy.x);
+        auto sxz = mu * (gx.z + gz.x);
+        auto syz = mu * (gy.z + gz.y);
+        Real3 sx{ ltr + 2. * mu * gx.x, sxy, sxz };
+        Real3 sy{ sxy, ltr + 2. * mu * gy.y, syz };
+        Real3 sz{ sxz, syz, ltr + 2. * mu * gz.z };
+
+        // Fluxes along the reference directions (stored in place of grad(u))
+        uxi[iq] = wt * (ijac.x.x * sx + ijac.y.x * sy + ijac.z.x * sz);
+        ueta[iq] = wt * (ijac.x.y * sx + ijac.y.y * sy + ijac.z.y * sz);
+        uzeta[iq] = wt * (ijac.x.z * sx + ijac.y.z * sy + ijac.z.z * sz);
+      }
+
+  _gradientsTranspose3D(uxi, ueta, uzeta, yl);
+  for (Int32 l = 0; l < 8; ++l)
+    y[hexa8_node[l]] = yl[l];
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// ! Same as applyStiffness3D() for a Quad4 cell (plane strain)
+void SumFactorizationKernel::
+applyStiffness2D(const Real3 coord[4], const Real& lambda, const Real& mu,
+                 const Real3 u[4], Real3 y[4]) const{
+
+  const Int32 nq = nbGaussPoint();
+
+  Real3 x[4], ul[4], yl[4];
+  for (Int32 l = 0; l < 4; ++l) {
+    x[l] = coord[quad4_node[l]];
+    ul[l] = Real3(u[quad4_node[l]].x, u[quad4_node[l]].y, 0.);
+  }
+
+  Real3* jxi = m_work.data();
+  Real3* jeta = jxi + nq;
+  Real3* uxi = jeta + nq;
+  Real3* ueta = uxi + nq;
+  _gradients2D(x, jxi, jeta);
+  _gradients2D(ul, uxi, ueta);
+
+  for (Int32 iy = 0, iq = 0; iy < m_nint[1]; ++iy)
+    for (Int32 ix = 0; ix < m_nint[0]; ++ix, ++iq) {
+
+      auto jacobian = jxi[iq].x * jeta[iq].y - jxi[iq].y * jeta[iq].x;
+      if (fabs(jacobian) < REL_PREC)
+        ARCANE_FATAL("Cell jacobian is null");
+      auto wt = m_weight[0][ix] * m_weight[1][iy] * jacobian;
+      auto ixx = jeta[iq].y / jacobian, ixy = -jxi[iq].y / jacobian;
+      auto iyx = -jeta[iq].x / jacobian, iyy = jxi[iq].x / jacobian;
+
+      Real3 gx = ixx * uxi[iq] + ixy * ueta[iq];
+      Real3 gy = iyx * uxi[iq] + iyy * ueta[iq];
+
+      auto ltr = lambda * (gx.x + gy.y);
+      auto sxy = mu * (gx.y + gy.x);
+      Real3 sx{ ltr + 2. * mu * gx.x, sxy, 0. };
+      Real3 sy{ sxy, ltr + 2. * mu * gy.y, 0. };
+
+      uxi[iq] = wt * (ixx * sx + iyx * sy);
+      ueta[iq] = wt * (ixy * sx + iyy * sy);
+    }
+
+  _gradientsTranspose2D(uxi, ueta, yl);
+  for (Int32 l = 0; l < 4; ++l)
+    y[quad4_node[l]] = yl[l];
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
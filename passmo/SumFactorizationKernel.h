@@ -0,0 +1,99 @@
+/*
+ * PASSMO : Performant Assessment for Seismic Site Modelling
+ *
+ * Sum-factorized elementary kernels for tensor-product finite-elements
+ * (Quad4 in 2D, Hexa8 in 3D)
+ *
+ * SumFactorizationKernel.h: declarations
+ */
+
+#ifndef PASSMO_SUMFACTORIZATIONKERNEL_H_
+#define PASSMO_SUMFACTORIZATIONKERNEL_H_
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+#include "FemUtils.h"
+#include "Integer3std.h"
+#include "utilFEM.h"
+
+using namespace Arcane;
+using namespace Arcane::FemUtils;
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// class SumFactorizationKernel: elementary operators of Quad4/Hexa8 cells
+//
+// The shape functions of these elements are tensor products of the 1D linear
+// Lagrange basis { (1 - x)/2, (1 + x)/2 } and the Gauss points are tensor
+// products of the 1D Gauss-Legendre points (xgauss1...xgauss9). Values and
+// derivatives are then only tabulated in 1D (nint x 2 tables per direction)
+// and the gradients at all the Gauss points of the cell are obtained by
+// contracting one direction at a time ("sum factorization") instead of
+// looping on every (Gauss point, node) pair.
+//
+// Two kinds of kernels are provided:
+//  - computeElementMatrices2D/3D(): stiffness + mass matrices integrated over
+//    all the Gauss points of the cell in one pass, so that they can be
+//    assembled once per cell,
+//  - applyStiffness2D/3D(): matrix-free action y = Ke.u, using the
+//    sum-factorized gradient and its transpose (no elementary matrix built).
+//    There is no matrix-free solver in passmo: these kernels are only used
+//    by the start-up benchmark (ElastodynamicModule::_benchmarkSumFactorization),
+//    the "sum-factorization" option only changes how Ke and Me are computed.
+//
+// Nodes are given in the local numbering of the cell (see Quad4ShapeFuncVal
+// and Hexa8ShapeFuncVal), the matrices are sorted as (node, dof).
+// Quadratic elements (Quad8, Hexa20) are serendipity elements which are not
+// tensor products: they keep the Gauss point loops of ElastodynamicModule.
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+class SumFactorizationKernel
+{
+ public:
+
+  SumFactorizationKernel() = default;
+
+ public:
+
+  //! Set the space dimension and the number of Gauss points per direction
+  void init(const Int32& ndim, const Integer3& nint);
+
+  //! True if the cell can use the sum-factorized kernels
+  bool isSupported(const ItemWithNodes& cell) const;
+
+  Int32 nbGaussPoint() const;
+
+  void computeElementMatrices3D(const Real3 coord[8], const Real& lambda, const Real& mu, const Real& rho,
+                                FixedMatrix<60,60>& Ke, FixedMatrix<60,60>& Me) const;
+  void computeElementMatrices2D(const Real3 coord[4], const Real& lambda, const Real& mu, const Real& rho,
+                                FixedMatrix<18,18>& Ke, FixedMatrix<18,18>& Me) const;
+
+  void applyStiffness3D(const Real3 coord[8], const Real& lambda, const Real& mu,
+                        const Real3 u[8], Real3 y[8]) const;
+  void applyStiffness2D(const Real3 coord[4], const Real& lambda, const Real& mu,
+                        const Real3 u[4], Real3 y[4]) const;
+
+ private:
+
+  void _gradients3D(const Real3 v[8], Real3 dxi[], Real3 deta[], Real3 dzeta[]) const;
+  void _gradientsTranspose3D(const Real3 hxi[], const Real3 heta[], const Real3 hzeta[], Real3 y[8]) const;
+  void _gradients2D(const Real3 v[4], Real3 dxi[], Real3 deta[]) const;
+  void _gradientsTranspose2D(const Real3 hxi[], const Real3 heta[], Real3 y[4]) const;
+
+ private:
+
+  Int32 m_ndim{ 2 };
+  Int32 m_nint[3]{ 2, 2, 1 };
+  //! 1D Gauss weights, basis values and derivatives per direction
+  Real m_weight[3][maxnint];
+  Real m_phi[3][maxnint][2];
+  Real m_dphi[3][maxnint][2];
+  //! Work arrays for the values at the Gauss points (6 * nb Gauss points)
+  mutable UniqueArray<Real3> m_work;
+};
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+#endif // PASSMO_SUMFACTORIZATIONKERNEL_H_
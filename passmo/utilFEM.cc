@@ -15,6 +15,7 @@
 #include "arcane/MathUtils.h"
 #include <arcane/utils/NumArray.h>
 #include "arcane/utils/ArgumentException.h"
+#include <arcane/utils/FatalErrorException.h>
 #include <arcane/IParallelMng.h>
 #include <arcane/IMesh.h>
 #include <arcane/IItemFamily.h>
@@ -754,7 +755,7 @@ Real3 Hexa8ShapeFuncDeriv(const Integer& inod,const Real3& ref_coord){
   if (inod == 1) return {-0.125*sp*tp,0.125*rm*tp, 0.125*rm*sp};
   if (inod == 2) return {-0.125*sm*tp,-0.125*rm*tp, 0.125*rm*sm};
   if (inod == 3) return {0.125*sm*tp,-0.125*rp*tp, 0.125*rp*sm};
-  if (inod == 4) return {0.125*sp*tm,-0.125*rp*tm, -0.125*rp*sp};
+  if (inod == 4) return {0.125*sp*tm,0.125*rp*tm, -0.125*rp*sp};
   if (inod == 5) return {-0.125*sp*tm,0.125*rm*tm, -0.125*rm*sp};
   if (inod == 6) return {-0.125*sm*tm,-0.125*rm*tm, -0.125*rm*sm};
   return {0.125*sm*tm,-0.125*rp*tm, -0.125*rp*sm};
@@ -1006,6 +1007,75 @@ Int32 getGeomDimension(const ItemWithNodes& item){
     return dim;
 }
 
+/*---------------------------------------------------------------------------*/
+
+Int16 getLinearItemType(const Int16& item_type){
+    switch(item_type) {
+        case IT_Line3: return IT_Line2;
+        case IT_Triangle6: return IT_Triangle3;
+        case IT_Quad8: return IT_Quad4;
+        case IT_Tetraedron10: return IT_Tetraedron4;
+        case IT_Hexaedron20: return IT_Hexaedron8;
+        default: break;
+    }
+    return item_type;
+}
+
+/*---------------------------------------------------------------------------*/
+// Node positions follow the shape functions of the linear elements
+// (Tri3ShapeFuncVal, Quad4ShapeFuncVal...) and the mid-node numbering of the
+// quadratic ones (Tri6ShapeFuncVal, Quad8ShapeFuncVal...): a mid-node is at
+// the middle of its edge, so that the linear shape functions give 1/2 for
+// both vertices of the edge.
+
+Real3 getLinearNodeRefPosition(const Int16& item_type, const Int32& inod){
+
+    switch(item_type) {
+
+        case IT_Line2:
+        case IT_Line3: {
+            const Real r[3] = { 1., -1., 0. };
+            return {r[inod],0.,0.};
+        }
+
+        case IT_Triangle3:
+        case IT_Triangle6: {
+            const Real r[6] = { 0., 1., 0., 0.5, 0.5, 0. };
+            const Real s[6] = { 0., 0., 1., 0., 0.5, 0.5 };
+            return {r[inod],s[inod],0.};
+        }
+
+        case IT_Quad4:
+        case IT_Quad8: {
+            const Real r[8] = { 1., -1., -1., 1., 0., -1., 0., 1. };
+            const Real s[8] = { 1., 1., -1., -1., 1., 0., -1., 0. };
+            return {r[inod],s[inod],0.};
+        }
+
+        case IT_Tetraedron4:
+        case IT_Tetraedron10: {
+            const Real x[10] = { 0., 1., 0., 0., 0.5, 0., 0.5, 0.5, 0., 0. };
+            const Real y[10] = { 0., 0., 1., 0., 0.5, 0.5, 0., 0., 0.5, 0. };
+            const Real z[10] = { 1., 0., 0., 0., 0., 0., 0., 0.5, 0.5, 0.5 };
+            return {x[inod],y[inod],z[inod]};
+        }
+
+        case IT_Hexaedron8:
+        case IT_Hexaedron20: {
+            const Real r[20] = { 1., -1., -1., 1., 1., -1., -1., 1.,
+                                 0., -1., 0., 1., 0., -1., 0., 1., 1., -1., -1., 1. };
+            const Real s[20] = { 1., 1., -1., -1., 1., 1., -1., -1.,
+                                 1., 0., -1., 0., 1., 0., -1., 0., 1., 1., -1., -1. };
+            const Real t[20] = { 1., 1., 1., 1., -1., -1., -1., -1.,
+                                 1., 1., 1., 1., -1., -1., -1., -1., 0., 0., 0., 0. };
+            return {r[inod],s[inod],t[inod]};
+        }
+
+        default: break;
+    }
+    ARCANE_FATAL("getLinearNodeRefPosition: unsupported item type {0}",item_type);
+}
+
 /*---------------------------------------------------------------------------*/
 /////////////////////////////////////////////////////////////////////////////
 // class GaussPointDispatcher: construction methods
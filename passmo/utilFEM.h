@@ -252,6 +252,12 @@ extern Integer3 Tetra10Orientation(const ItemWithNodes& item, const VariableNode
 
 extern Int32 getGeomDimension(const ItemWithNodes& item);
 
+// Linear (vertex) element of a quadratic element (Tri6 -> Tri3, ...) and
+// position of the nodes of the quadratic element in the reference system of
+// this linear element: used to interpolate mid-nodes from vertices
+extern Int16 getLinearItemType(const Int16& item_type);
+extern Real3 getLinearNodeRefPosition(const Int16& item_type, const Int32& inod);
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -0,0 +1,485 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; coding: utf-8-with-signature -*-
+//-----------------------------------------------------------------------------
+// Copyright 2000-2024 CEA (www.cea.fr) IFPEN (www.ifpenergiesnouvelles.com)
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0
+//-----------------------------------------------------------------------------
+/*---------------------------------------------------------------------------*/
+/* AdaptiveRefinement.hxx                                      (C) 2022-2024 */
+/*                                                                           */
+/* Solve-estimate-mark-refine loop on TRIA3 meshes.                          */
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*
+ * Each call to compute() is one cycle of the adaptive refinement:
+ *  - solve on the active cells of the mesh (legacy assembly),
+ *  - estimate the error of each cell with the Zienkiewicz-Zhu recovery,
+ *  - mark the cells with the Dorfler (bulk) criterion,
+ *  - refine the marked cells with the cell AMR of Arcane, then prolongate
+ *    the solution on the new nodes, it is the initial guess of the next solve.
+ *
+ * The refinement of a cell adds a node in the middle of its edges. When the
+ * neighbour across an edge is not refined, this node is hanging: it is not a
+ * vertex of the coarse neighbour and its value is constrained to be the mean
+ * of the values of the end nodes of the edge (its masters). The element
+ * matrices and vectors are then assembled on the masters and the row of a
+ * hanging node only contains a unit diagonal.
+ */
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_initAdaptiveRefinement()
+{
+  m_fem_cells = allCells();
+  if (options()->amrNbCycle() <= 0)
+    return;
+
+  if (m_cell_type != IT_Triangle3)
+    ARCANE_FATAL("The adaptive refinement is only available for TRIA3 meshes");
+  if (!mesh()->isAmrActivated())
+    ARCANE_FATAL("The adaptive refinement needs a mesh declared with the attribute amr-type=\"1\"");
+  if (!m_use_legacy || m_use_auto)
+    ARCANE_FATAL("The adaptive refinement is only available with the legacy assembly");
+  if (options()->enforceDirichletMethod() == "Nitsche")
+    ARCANE_FATAL("The adaptive refinement is not available with the Nitsche method");
+  if (options()->neumannBoundaryCondition().size() != 0)
+    ARCANE_FATAL("The adaptive refinement is not available with Neumann boundary conditions");
+
+  info() << "AMR: At most " << options()->amrNbCycle() << " cycles of adaptive refinement"
+         << " (theta=" << options()->amrDorflerTheta() << " tolerance=" << options()->amrTolerance() << ")";
+  m_use_amr = true;
+  m_fem_cells = mesh()->allActiveCells();
+
+  // Edges of the Dirichlet surfaces, the new nodes on these edges are Dirichlet nodes
+  for (const auto& bs : options()->dirichletBoundaryCondition()) {
+    Real value = bs->value();
+    ENUMERATE_ (Face, iface, bs->surface()) {
+      Int32 a = iface->nodeId(0);
+      Int32 b = iface->nodeId(1);
+      m_dirichlet_edge_value[std::minmax(a, b)] = value;
+    }
+  }
+  _computeNodeParentEdges();
+  _computeHangingNodeMasters();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Estimate the error of the current solution and refine the mesh.
+ *
+ * The time loop is stopped when the maximum number of cycles is reached
+ * or when the global estimate is below 'amr-tolerance'.
+ */
+void FemModule::
+_doAdaptiveRefinementCycle()
+{
+  Timer::Action timer_action(m_time_stats, "AdaptiveRefinement");
+
+  IParallelMng* pm = parallelMng();
+  Real estimate = _computeErrorIndicator();
+  Int64 nb_dof = pm->reduce(Parallel::ReduceSum, Int64(ownNodes().size()));
+  Int64 nb_cell = pm->reduce(Parallel::ReduceSum, Int64(m_fem_cells.own().size()));
+  info() << "AMR: cycle=" << m_amr_cycle << " nb_cell=" << nb_cell << " nb_dof=" << nb_dof
+         << " estimate=" << estimate;
+
+  ++m_amr_cycle;
+  if (m_amr_cycle >= options()->amrNbCycle() || estimate <= options()->amrTolerance()) {
+    subDomain()->timeLoopMng()->stopComputeLoop(true);
+    m_amr_is_done = true;
+    _checkResultFile();
+    return;
+  }
+
+  Int32UniqueArray cells_to_refine;
+  _markCellsToRefine(cells_to_refine);
+
+  mesh()->modifier()->flagCellToRefine(cells_to_refine);
+  mesh()->modifier()->adapt();
+
+  Int32UniqueArray new_node_lids = m_dofs_on_nodes.addDoFsOnNewNodes();
+  _computeNodeParentEdges();
+  _prolongateOnNewNodes(new_node_lids);
+  _computeHangingNodeMasters();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Zienkiewicz-Zhu error indicator.
+ *
+ * The gradient of u is constant on each cell. The recovered gradient G is
+ * the linear field whose nodal values are the area weighted means of the
+ * gradients of the cells around the nodes. The indicator of a cell K is
+ *
+ *   eta_K^2 = int_K |G - grad(u_K)|^2 = area/12 (sum_i |e_i|^2 + |sum_i e_i|^2)
+ *
+ * with e_i = G(n_i) - grad(u_K) on the nodes n_i of K.
+ * Returns the global estimate sqrt(sum_K eta_K^2).
+ */
+Real FemModule::
+_computeErrorIndicator()
+{
+  Int32 max_node_lid = mesh()->nodeFamily()->maxLocalId();
+  UniqueArray<Real3> recovered_gradient(max_node_lid, Real3::zero());
+  UniqueArray<Real> patch_area(max_node_lid, 0.0);
+
+  auto compute_gradient = [&](Cell cell, Real area) {
+    Real3 m0 = m_node_coord[cell.nodeId(0)];
+    Real3 m1 = m_node_coord[cell.nodeId(1)];
+    Real3 m2 = m_node_coord[cell.nodeId(2)];
+    Real u0 = m_u[cell.nodeId(0)];
+    Real u1 = m_u[cell.nodeId(1)];
+    Real u2 = m_u[cell.nodeId(2)];
+    Real3 grad(u0 * (m1.y - m2.y) + u1 * (m2.y - m0.y) + u2 * (m0.y - m1.y),
+               u0 * (m2.x - m1.x) + u1 * (m0.x - m2.x) + u2 * (m1.x - m0.x),
+               0.0);
+    return grad / (2.0 * area);
+  };
+
+  // With one layer of ghost cells, the patch of the nodes of the own cells is complete
+  ENUMERATE_ (Cell, icell, m_fem_cells) {
+    Cell cell = *icell;
+    Real area = _computeAreaTriangle3(cell);
+    Real3 grad = compute_gradient(cell, area);
+    Real weight = math::abs(area);
+    for (NodeLocalId node : cell.nodeIds()) {
+      recovered_gradient[node] += weight * grad;
+      patch_area[node] += weight;
+    }
+  }
+  for (Int32 i = 0; i < max_node_lid; ++i)
+    if (patch_area[i] > 0.0)
+      recovered_gradient[i] /= patch_area[i];
+
+  Real sum_eta2 = 0.0;
+  ENUMERATE_ (Cell, icell, m_fem_cells) {
+    Cell cell = *icell;
+    Real area = _computeAreaTriangle3(cell);
+    Real3 grad = compute_gradient(cell, area);
+    Real3 sum_e = Real3::zero();
+    Real sum_e2 = 0.0;
+    for (NodeLocalId node : cell.nodeIds()) {
+      Real3 e = recovered_gradient[node] - grad;
+      sum_e += e;
+      sum_e2 += math::dot(e, e);
+    }
+    Real eta2 = math::abs(area) / 12.0 * (sum_e2 + math::dot(sum_e, sum_e));
+    m_error_indicator[cell] = math::sqrt(eta2);
+    if (cell.isOwn())
+      sum_eta2 += eta2;
+  }
+  m_error_indicator.synchronize();
+
+  return math::sqrt(parallelMng()->reduce(Parallel::ReduceSum, sum_eta2));
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Dorfler marking.
+ *
+ * Marks the smallest set of cells with the largest indicators whose sum of
+ * eta_K^2 is at least theta times the global sum. The threshold on eta_K^2
+ * is found by bisection, so that only reductions are needed in parallel.
+ */
+void FemModule::
+_markCellsToRefine(Int32Array& cells_to_refine)
+{
+  IParallelMng* pm = parallelMng();
+  CellGroup own_cells = m_fem_cells.own();
+
+  Real total = 0.0;
+  Real max_eta2 = 0.0;
+  ENUMERATE_ (Cell, icell, own_cells) {
+    Real eta2 = m_error_indicator[icell] * m_error_indicator[icell];
+    total += eta2;
+    max_eta2 = math::max(max_eta2, eta2);
+  }
+  total = pm->reduce(Parallel::ReduceSum, total);
+  max_eta2 = pm->reduce(Parallel::ReduceMax, max_eta2);
+  Real bulk = options()->amrDorflerTheta() * total;
+
+  // Largest threshold 't' such that the cells with eta_K^2 >= t hold the bulk
+  Real t_low = 0.0;
+  Real t_high = max_eta2;
+  for (Int32 iter = 0; iter < 50; ++iter) {
+    Real t = 0.5 * (t_low + t_high);
+    Real sum = 0.0;
+    ENUMERATE_ (Cell, icell, own_cells) {
+      Real eta2 = m_error_indicator[icell] * m_error_indicator[icell];
+      if (eta2 >= t)
+        sum += eta2;
+    }
+    if (pm->reduce(Parallel::ReduceSum, sum) >= bulk)
+      t_low = t;
+    else
+      t_high = t;
+  }
+
+  cells_to_refine.clear();
+  ENUMERATE_ (Cell, icell, own_cells) {
+    Real eta2 = m_error_indicator[icell] * m_error_indicator[icell];
+    if (eta2 >= t_low)
+      cells_to_refine.add(icell.itemLocalId());
+  }
+  info() << "AMR: Nb marked cells=" << pm->reduce(Parallel::ReduceSum, cells_to_refine.size());
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Find the parent edge of the nodes created by the refinement.
+ *
+ * A node of a child cell which is not a vertex of the parent cell is the
+ * middle of one of the edges of the parent cell.
+ */
+void FemModule::
+_computeNodeParentEdges()
+{
+  Int32 max_node_lid = mesh()->nodeFamily()->maxLocalId();
+  m_node_parent_edge.resize(3 * max_node_lid);
+  m_node_parent_edge.fill(NULL_ITEM_LOCAL_ID);
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    if (cell.level() == 0)
+      continue;
+    Cell parent = cell.hParent();
+    Int32 nb_parent_node = parent.nbNode();
+    for (NodeLocalId node : cell.nodeIds()) {
+      if (m_node_parent_edge[3 * node] != NULL_ITEM_LOCAL_ID)
+        continue;
+      Real3 x = m_node_coord[node];
+      for (Int32 i = 0; i < nb_parent_node; ++i) {
+        NodeLocalId a = parent.nodeId(i);
+        NodeLocalId b = parent.nodeId((i + 1) % nb_parent_node);
+        Real3 ab = m_node_coord[b] - m_node_coord[a];
+        Real3 d = x - 0.5 * (m_node_coord[a] + m_node_coord[b]);
+        if (math::dot(d, d) < 1.0e-12 * math::dot(ab, ab)) {
+          m_node_parent_edge[3 * node] = a;
+          m_node_parent_edge[3 * node + 1] = b;
+          m_node_parent_edge[3 * node + 2] = parent.localId();
+          break;
+        }
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Linear interpolation of the node values on the new nodes.
+ *
+ * A new node in the middle of an edge of a Dirichlet surface gets the value
+ * of the surface and its two half edges are added to the Dirichlet edges.
+ * The nodes of the Dirichlet point conditions are nodes of the initial mesh,
+ * they keep their value.
+ */
+void FemModule::
+_prolongateOnNewNodes(Int32ConstArrayView new_node_lids)
+{
+  for (Int32 lid : new_node_lids) {
+    NodeLocalId node(lid);
+    Int32 a = m_node_parent_edge[3 * lid];
+    Int32 b = m_node_parent_edge[3 * lid + 1];
+    if (a == NULL_ITEM_LOCAL_ID)
+      ARCANE_FATAL("No parent edge for the new node lid={0}", lid);
+    m_u[node] = 0.5 * (m_u[NodeLocalId(a)] + m_u[NodeLocalId(b)]);
+    m_node_f[node] = 0.5 * (m_node_f[NodeLocalId(a)] + m_node_f[NodeLocalId(b)]);
+    m_u_dirichlet[node] = false;
+    auto edge = m_dirichlet_edge_value.find(std::minmax(a, b));
+    if (edge == m_dirichlet_edge_value.end())
+      continue;
+    Real value = edge->second;
+    m_u[node] = value;
+    m_u_dirichlet[node] = true;
+    m_dirichlet_edge_value[std::minmax(a, lid)] = value;
+    m_dirichlet_edge_value[std::minmax(b, lid)] = value;
+  }
+  m_u_dirichlet.synchronize();
+
+  ENUMERATE_ (Cell, icell, m_fem_cells) {
+    Cell cell = *icell;
+    if (cell.level() > 0)
+      m_cell_f[cell] = m_cell_f[cell.hParent()];
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Compute the masters of the nodes.
+ *
+ * A node is hanging if the end nodes of its parent edge are still linked by
+ * an edge of an active cell. Its masters are the masters of these end nodes
+ * with half their weight (recursively, since they may be hanging too).
+ * The master of a node which is not hanging is the node itself.
+ */
+void FemModule::
+_computeHangingNodeMasters()
+{
+  Int32 max_node_lid = mesh()->nodeFamily()->maxLocalId();
+
+  std::set<std::pair<Int32, Int32>> active_edges;
+  ENUMERATE_ (Cell, icell, m_fem_cells) {
+    Cell cell = *icell;
+    Int32 nb_node = cell.nbNode();
+    for (Int32 i = 0; i < nb_node; ++i) {
+      Int32 a = cell.nodeId(i);
+      Int32 b = cell.nodeId((i + 1) % nb_node);
+      active_edges.insert(std::minmax(a, b));
+    }
+  }
+
+  UniqueArray<bool> is_hanging(max_node_lid, false);
+  Int32 nb_hanging = 0;
+  for (Int32 lid = 0; lid < max_node_lid; ++lid) {
+    Int32 a = m_node_parent_edge[3 * lid];
+    Int32 b = m_node_parent_edge[3 * lid + 1];
+    if (a != NULL_ITEM_LOCAL_ID && active_edges.find(std::minmax(a, b)) != active_edges.end()) {
+      is_hanging[lid] = true;
+      ++nb_hanging;
+    }
+  }
+  m_has_hanging_node = (parallelMng()->reduce(Parallel::ReduceSum, nb_hanging) != 0);
+
+  m_node_master_index.resize(max_node_lid + 1);
+  m_node_master.clear();
+  m_node_master_weight.clear();
+  auto add_masters = [&](auto&& self, Int32 lid, Real weight) -> void {
+    if (!is_hanging[lid]) {
+      m_node_master.add(lid);
+      m_node_master_weight.add(weight);
+      return;
+    }
+    self(self, m_node_parent_edge[3 * lid], 0.5 * weight);
+    self(self, m_node_parent_edge[3 * lid + 1], 0.5 * weight);
+  };
+  for (Int32 lid = 0; lid < max_node_lid; ++lid) {
+    m_node_master_index[lid] = m_node_master.size();
+    add_masters(add_masters, lid, 1.0);
+  }
+  m_node_master_index[max_node_lid] = m_node_master.size();
+
+  info() << "AMR: Nb hanging nodes=" << nb_hanging;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+bool FemModule::
+_isHangingNode(Int32 node_lid) const
+{
+  return m_node_master[m_node_master_index[node_lid]] != node_lid;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_interpolateHangingNodes()
+{
+  if (!m_has_hanging_node)
+    return;
+  ENUMERATE_ (Node, inode, allNodes()) {
+    Int32 lid = inode.itemLocalId();
+    if (!_isHangingNode(lid))
+      continue;
+    Real v = 0.0;
+    for (Int32 k = m_node_master_index[lid]; k < m_node_master_index[lid + 1]; ++k)
+      v += m_node_master_weight[k] * m_u[NodeLocalId(m_node_master[k])];
+    m_u[inode] = v;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Assemble the bilinear operator on the active cells.
+ *
+ * Same as the legacy assembly, except that the rows and columns of the
+ * hanging nodes are assembled on their masters.
+ */
+void FemModule::
+_assembleAmrBilinearOperatorTRIA3()
+{
+  Timer::Action timer_action(m_time_stats, "AssembleAmrBilinearOperatorTria3");
+
+  ENUMERATE_ (Cell, icell, m_fem_cells) {
+    Cell cell = *icell;
+    _addElementMatrixOnMasters(cell, _computeElementMatrixTRIA3(cell));
+  }
+  _addHangingNodeRows();
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_addElementMatrixOnMasters(Cell cell, const FixedMatrix<3, 3>& K_e)
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  NodeInfoListView nodes(mesh()->nodeFamily());
+
+  for (Int32 i = 0; i < 3; ++i) {
+    Int32 node_i = cell.nodeId(i);
+    for (Int32 ki = m_node_master_index[node_i]; ki < m_node_master_index[node_i + 1]; ++ki) {
+      Node master_i = nodes[m_node_master[ki]];
+      if (!master_i.isOwn())
+        continue;
+      for (Int32 j = 0; j < 3; ++j) {
+        Int32 node_j = cell.nodeId(j);
+        Real v = m_node_master_weight[ki] * K_e(i, j);
+        for (Int32 kj = m_node_master_index[node_j]; kj < m_node_master_index[node_j + 1]; ++kj) {
+          NodeLocalId master_j(m_node_master[kj]);
+          m_linear_system.matrixAddValue(node_dof.dofId(master_i, 0), node_dof.dofId(master_j, 0),
+                                         v * m_node_master_weight[kj]);
+        }
+      }
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_addElementVectorOnMasters(Cell cell, const Real b_e[8], VariableDoFReal& rhs_values)
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  NodeInfoListView nodes(mesh()->nodeFamily());
+
+  Int32 nb_node = cell.nbNode();
+  for (Int32 i = 0; i < nb_node; ++i) {
+    Int32 node_i = cell.nodeId(i);
+    for (Int32 k = m_node_master_index[node_i]; k < m_node_master_index[node_i + 1]; ++k) {
+      Node master = nodes[m_node_master[k]];
+      if (!(m_u_dirichlet[master]) && master.isOwn())
+        rhs_values[node_dof.dofId(master, 0)] += m_node_master_weight[k] * b_e[i];
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_addHangingNodeRows()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  // The value of the hanging nodes is set after the solve by _interpolateHangingNodes()
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    if (_isHangingNode(inode.itemLocalId())) {
+      DoFLocalId dof_id = node_dof.dofId(*inode, 0);
+      m_linear_system.matrixAddValue(dof_id, dof_id, 1.0);
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
@@ -40,10 +40,15 @@ void FemModule::_buildMatrixBuildLessCsr()
 
 void FemModule::_buildMatrixGpuBuildLessCsr()
 {
+  // For QUAD4 cells, each cell of a node adds one diagonal neighbour which
+  // is not connected to the node by a face.
+  bool is_quad4 = (options()->meshType == "QUAD4");
 
   // Compute the number of nnz and initialize the memory space
   Integer nbnde = nbNode();
   Int32 nnz = nbFace() * 2 + nbnde;
+  if (is_quad4)
+    nnz += 4 * nbCell();
 
   NumArray<Int32, MDDim1> tmp_row;
   tmp_row.resize(nbnde);
@@ -56,11 +61,12 @@ void FemModule::_buildMatrixGpuBuildLessCsr()
   UnstructuredMeshConnectivityView connectivity_view;
   connectivity_view.setMesh(this->mesh());
   auto nfc = connectivity_view.nodeFace();
+  auto ncc = connectivity_view.nodeCell();
 
   command << RUNCOMMAND_ENUMERATE(Node, inode, allNodes())
   {
     Int64 index = node_dof.dofId(inode, 0).localId();
-    in_out_tmp_row(index) = nfc.nbFace(inode) + 1;
+    in_out_tmp_row(index) = nfc.nbFace(inode) + 1 + ((is_quad4) ? ncc.nbCell(inode) : 0);
   };
   ax::Scanner<Int32> scanner;
   scanner.exclusiveSum(queue, tmp_row, m_csr_matrix.m_matrix_row);
@@ -135,8 +141,45 @@ void FemModule::_assembleBuildLessCsrBilinearOperatorTria3()
     // Build only the row part of the csr matrix on GPU
     // Using scan -> might be improved
     _buildMatrixGpuBuildLessCsr();
+    // Only the local index of the nodes in their cells is used: the columns
+    // of the pattern are found during the assembly.
+    if (!m_node_cell_connectivity.isInitialized())
+      m_node_cell_connectivity.initialize(mesh());
   }
 
+  Timer::Action timer_blcsr_add_compute(m_time_stats, "BuildLessCsrAddAndCompute");
+  _computeCellMatricesGpuTria3();
+  _addCellMatricesBuildLessCsr(3);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::_assembleBuildLessCsrBilinearOperatorQuad4()
+{
+  Timer::Action timer_blcsr_bili(m_time_stats, "AssembleBuildLessCsrBilinearOperatorQuad4");
+
+  {
+    Timer::Action timer_blcsr_build(m_time_stats, "BuildLessCsrBuildMatrixGPUQuad4");
+    _buildMatrixGpuBuildLessCsr();
+    if (!m_node_cell_connectivity.isInitialized())
+      m_node_cell_connectivity.initialize(mesh());
+  }
+
+  Timer::Action timer_blcsr_add_compute(m_time_stats, "BuildLessCsrAddAndComputeQuad4");
+  _computeCellMatricesGpuQuad4();
+  _addCellMatricesBuildLessCsr(4);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add the element matrices of m_cell_matrix in the buildless csr matrix.
+ *
+ * The columns of each row are discovered while adding the values.
+ */
+void FemModule::_addCellMatricesBuildLessCsr(Int32 nb_node_per_cell)
+{
   RunQueue* queue = acceleratorMng()->defaultQueue();
 
   // Boucle sur les noeuds déportée sur accélérateur
@@ -149,59 +192,40 @@ void FemModule::_assembleBuildLessCsrBilinearOperatorTria3()
   Int32 col_csr_size = m_csr_matrix.m_matrix_column.dim1Size();
   auto in_out_val_csr = ax::viewInOut(command, m_csr_matrix.m_matrix_value);
 
-  auto in_node_coord = ax::viewIn(command, m_node_coord);
+  auto in_cell_matrix = ax::viewIn(command, m_cell_matrix);
+  auto in_node_begin = ax::viewIn(command, m_node_cell_connectivity.m_node_begin);
+  auto in_pair_cell = ax::viewIn(command, m_node_cell_connectivity.m_pair_cell);
+  auto in_local_index = ax::viewIn(command, m_node_cell_connectivity.m_local_index);
+  Int32 nb_node = nb_node_per_cell;
 
   UnstructuredMeshConnectivityView m_connectivity_view;
   m_connectivity_view.setMesh(this->mesh());
-  auto ncc = m_connectivity_view.nodeCell();
   auto cnc = m_connectivity_view.cellNode();
   Arcane::ItemGenericInfoListView nodes_infos(this->mesh()->nodeFamily());
-  Arcane::ItemGenericInfoListView cells_infos(this->mesh()->cellFamily());
 
-  Timer::Action timer_blcsr_add_compute(m_time_stats, "BuildLessCsrAddAndCompute");
   command << RUNCOMMAND_ENUMERATE(Node, inode, allNodes())
   {
-    Int32 inode_index = 0;
-    for (auto cell : ncc.cells(inode)) {
-
-      // How can I know the right index ?
-      // By checking in the global id ?
-      // Working currently, but maybe only because p = 1 ?
-      if (inode == cnc.nodeId(cell, 1)) {
-        inode_index = 1;
-      }
-      else if (inode == cnc.nodeId(cell, 2)) {
-        inode_index = 2;
+    if (nodes_infos.isOwn(inode)) {
+      Int32 row = node_dof.dofId(inode, 0).localId();
+      Int32 begin = in_row_csr[row];
+      Int32 end;
+      if (row == row_csr_size - 1) {
+        end = col_csr_size;
       }
       else {
-        inode_index = 0;
+        end = in_row_csr[row + 1];
       }
-
-      Real b_matrix[6] = { 0 };
-      Real area = _computeCellMatrixGpuTRIA3(cell, cnc, in_node_coord, b_matrix);
-
-      Int32 i = 0;
-      for (NodeLocalId node2 : cnc.nodes(cell)) {
-        Real x = 0.0;
-        for (Int32 k = 0; k < 2; k++) {
-          x += b_matrix[inode_index * 2 + k] * b_matrix[i * 2 + k];
-        }
-        x = x * area;
-        if (nodes_infos.isOwn(inode)) {
-
-          Int32 row = node_dof.dofId(inode, 0).localId();
+      Int32 node_lid = inode.localId();
+      for (Int32 p = in_node_begin[node_lid]; p < in_node_begin[node_lid + 1]; ++p) {
+        CellLocalId cell(in_pair_cell[p]);
+        Int32 inode_index = in_local_index[p];
+        Int32 i = 0;
+        for (NodeLocalId node2 : cnc.nodes(cell)) {
+          Real x = in_cell_matrix(cell.localId(), inode_index * nb_node + i);
           Int32 col = node_dof.dofId(node2, 0).localId();
-          Int32 begin = in_row_csr[row];
-          Int32 end;
-          if (row == row_csr_size - 1) {
-            end = col_csr_size;
-          }
-          else {
-            end = in_row_csr[row + 1];
-          }
           _addValueToGlobalMatrixTria3Gpu(begin, end, col, in_out_col_csr, in_out_val_csr, x);
+          i++;
         }
-        i++;
       }
     }
   };
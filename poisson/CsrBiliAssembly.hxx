@@ -104,4 +104,79 @@ _assembleCsrBilinearOperatorTRIA3()
 }
 
 /*---------------------------------------------------------------------------*/
-/*---------------------------------------------------------------------------*/
\ No newline at end of file
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_assembleCsrBilinearOperatorQUAD4()
+{
+  Timer::Action timer_csr_bili(m_time_stats, "AssembleCsrBilinearOperatorQuad4");
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  {
+    Timer::Action timer_csr_build(m_time_stats, "CsrBuildMatrixQuad4");
+    // The pattern contains the diagonal neighbours of the quadrangles
+    m_csr_matrix.initializeFromNodeCellPattern(mesh(), m_dof_family, node_dof);
+  }
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+
+    auto K_e = _computeElementMatrixQUAD4(cell); // element stifness matrix
+
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      if (node1.isOwn()) {
+        DoFLocalId row = node_dof.dofId(node1, 0);
+        Int32 n2_index = 0;
+        for (Node node2 : cell.nodes()) {
+          m_csr_matrix.matrixAddValue(row, node_dof.dofId(node2, 0), K_e(n1_index, n2_index));
+          ++n2_index;
+        }
+      }
+      ++n1_index;
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_assembleCsrBilinearOperator3D()
+{
+  Timer::Action timer_csr_bili(m_time_stats, "AssembleCsrBilinearOperator3D");
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  {
+    Timer::Action timer_csr_build(m_time_stats, "CsrBuildMatrix3D");
+    m_csr_matrix.initializeFromNodeCellPattern(mesh(), m_dof_family, node_dof);
+  }
+
+  auto add_element_matrix = [&](Cell cell, const auto& K_e) {
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      if (node1.isOwn()) {
+        DoFLocalId row = node_dof.dofId(node1, 0);
+        Int32 n2_index = 0;
+        for (Node node2 : cell.nodes()) {
+          m_csr_matrix.matrixAddValue(row, node_dof.dofId(node2, 0), K_e(n1_index, n2_index));
+          ++n2_index;
+        }
+      }
+      ++n1_index;
+    }
+  };
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    if (m_cell_type == IT_Hexaedron8)
+      add_element_matrix(cell, _computeElementMatrixHEXA8(cell));
+    else
+      add_element_matrix(cell, _computeElementMatrixTETRA4(cell));
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
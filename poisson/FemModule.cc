@@ -205,8 +205,8 @@ compute()
 {
   info() << "Module Fem COMPUTE";
 
-  // Stop code after computations
-  if (m_global_iteration() > 0)
+  // Stop code after computations (the adaptive refinement stops itself)
+  if (m_global_iteration() > 0 && !m_use_amr)
     subDomain()->timeLoopMng()->stopComputeLoop(true);
 
   m_linear_system.reset();
@@ -230,9 +230,26 @@ compute()
     CommandLineArguments args(string_list);
     m_linear_system.setSolverCommandLineArguments(args);
   }
-  info() << "NB_CELL=" << allCells().size() << " NB_FACE=" << allFaces().size();
+  // Pure Neumann problem: the solution is only defined up to a constant
+  if (options()->nullSpace()) {
+    UniqueArray<Real> constants(m_dof_family->maxLocalId(), 1.0);
+    m_linear_system.setNullSpace(1, constants);
+  }
+  // Start from the solution prolongated on the refined mesh
+  if (m_use_amr && m_amr_cycle > 0) {
+    m_linear_system.setSolutionAsInitialGuess(true);
+    VariableDoFReal& dof_u(m_linear_system.solutionVariable());
+    auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+    ENUMERATE_ (Node, inode, allNodes()) {
+      dof_u[node_dof.dofId(*inode, 0)] = m_u[inode];
+    }
+  }
+  info() << "NB_CELL=" << m_fem_cells.size() << " NB_FACE=" << allFaces().size();
 
   _doStationarySolve();
+
+  if (m_use_amr)
+    _doAdaptiveRefinementCycle();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -260,8 +277,11 @@ startInit()
   // # init BCs
   _handleFlags();
   _initBoundaryconditions();
+  if (options()->nullSpace() && (options()->dirichletBoundaryCondition().size() > 0 || options()->dirichletPointCondition().size() > 0))
+    ARCANE_FATAL("'null-space' is only valid without Dirichlet condition");
 
   _checkCellType();
+  _initAdaptiveRefinement();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -330,6 +350,11 @@ _handleFlags()
   else if (parameter_list.getParameterOrNull("LEGACY") == "FALSE" || options()->legacy()) {
     m_use_legacy = false;
   }
+  if (parameter_list.getParameterOrNull("AUTO") == "TRUE" || options()->autoAssembly()) {
+    m_use_auto = true;
+    m_use_legacy = false;
+    info() << "AUTO: The fastest assembly method will be selected at the first solve";
+  }
   if (parameter_list.getParameterOrNull("AcceleratorRuntime") == "cuda") {
     m_running_on_gpu = true;
     info() << "CUDA: The methods able to use GPU will use it";
@@ -337,6 +362,142 @@ _handleFlags()
   info() << "-----------------------------------------------------------------------------------------";
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Key of the cache of the auto-assembly.
+ *
+ * The key contains the type of the cells, the size class of the mesh (log2
+ * of the global number of cells), the execution policy of the runner and the
+ * number of threads.
+ */
+String FemModule::
+_assemblyStrategyKey()
+{
+  IParallelMng* pm = mesh()->parallelMng();
+  Int64 nb_cell = pm->reduce(Parallel::ReduceSum, Int64(ownCells().size()));
+  Int32 size_class = 0;
+  while ((Int64(1) << (size_class + 1)) <= nb_cell)
+    ++size_class;
+
+  std::ostringstream ostr;
+  ostr << options()->meshType() << "_cells2^" << size_class
+       << "_" << acceleratorMng()->defaultRunner()->executionPolicy()
+       << "_threads" << TaskFactory::nbAllowedThread()
+       << "_ranks" << pm->commSize();
+  return String(ostr.str());
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Select the fastest bilinear assembly method (auto-assembly).
+ *
+ * The method is read from the cache file if it contains the key of the
+ * current run. Otherwise each applicable method is run once on the whole
+ * mesh as a warm-up and once more to be timed. The slowest rank gives the
+ * time of a method. The fastest method is appended to the cache file.
+ */
+void FemModule::
+_selectAssemblyStrategy()
+{
+  struct AssemblyStrategy
+  {
+    const char* name;
+    const char* timer_name;
+    bool FemModule::*flag;
+    void (FemModule::*assemble)();
+    //! Assembly for QUAD4 cells (nullptr if not available)
+    void (FemModule::*assemble_quad4)();
+    //! Assembly for TETRA4 and HEXA8 cells (nullptr if not available)
+    void (FemModule::*assemble_3d)();
+  };
+
+  const AssemblyStrategy strategies[] = {
+    { "legacy", "AssembleLegacyBilinearOperatorTria3", &FemModule::m_use_legacy, &FemModule::_assembleBilinearOperatorTRIA3, &FemModule::_assembleBilinearOperatorQUAD4, &FemModule::_assembleBilinearOperator3D },
+    { "coo", "AssembleCooBilinearOperatorTria3", &FemModule::m_use_coo, &FemModule::_assembleCooBilinearOperatorTRIA3, nullptr, nullptr },
+    { "coo-sorting", "AssembleCooSortBilinearOperatorTria3", &FemModule::m_use_coo_sort, &FemModule::_assembleCooSortBilinearOperatorTRIA3, nullptr, nullptr },
+    { "csr", "AssembleCsrBilinearOperatorTria3", &FemModule::m_use_csr, &FemModule::_assembleCsrBilinearOperatorTRIA3, &FemModule::_assembleCsrBilinearOperatorQUAD4, &FemModule::_assembleCsrBilinearOperator3D },
+#ifdef ARCANE_HAS_ACCELERATOR
+    { "csr-gpu", "AssembleCsrGpuBilinearOperatorTria3", &FemModule::m_use_csr_gpu, &FemModule::_assembleCsrGPUBilinearOperatorTRIA3, nullptr, nullptr },
+#endif
+    { "nwcsr", "AssembleNodeWiseCsrBilinearOperatorTria3", &FemModule::m_use_nodewise_csr, &FemModule::_assembleNodeWiseCsrBilinearOperatorTria3, &FemModule::_assembleNodeWiseCsrBilinearOperatorQuad4, &FemModule::_assembleNodeWiseCsrBilinearOperator3D },
+    { "blcsr", "AssembleBuildLessCsrBilinearOperatorTria3", &FemModule::m_use_buildless_csr, &FemModule::_assembleBuildLessCsrBilinearOperatorTria3, &FemModule::_assembleBuildLessCsrBilinearOperatorQuad4, nullptr },
+  };
+  const Int32 nb_strategy = static_cast<Int32>(std::size(strategies));
+
+  IParallelMng* pm = mesh()->parallelMng();
+  // Assembly function of a method for the type of the cells of the mesh
+  auto assemble_of = [&](const AssemblyStrategy& s) {
+    if (m_cell_type == IT_Quad4)
+      return s.assemble_quad4;
+    if (m_cell_type != IT_Triangle3)
+      return s.assemble_3d;
+    return s.assemble;
+  };
+  String key = _assemblyStrategyKey();
+  String cache_file = options()->autoAssemblyCacheFile();
+
+  // Look for the key in the cache file (read by the master rank only)
+  Int32 selected = -1;
+  if (pm->commRank() == 0) {
+    std::ifstream ifile(cache_file.localstr());
+    std::string file_key, file_name;
+    while (ifile >> file_key >> file_name) {
+      if (file_key != key.localstr())
+        continue;
+      for (Int32 i = 0; i < nb_strategy; ++i)
+        if (file_name == strategies[i].name && assemble_of(strategies[i]))
+          selected = i;
+    }
+  }
+  selected = pm->reduce(Parallel::ReduceMax, selected);
+
+  if (selected >= 0) {
+    info() << "AUTO: Using assembly method '" << strategies[selected].name
+           << "' from cache file '" << cache_file << "' (key=" << key << ")";
+  }
+  else {
+    info() << "AUTO: Calibration of the assembly methods (key=" << key << ")";
+    Real best_time = 0.0;
+    for (Int32 i = 0; i < nb_strategy; ++i) {
+      const AssemblyStrategy& s = strategies[i];
+      auto assemble = assemble_of(s);
+      if (!assemble)
+        continue;
+      // Warm-up
+      m_linear_system.clearValues();
+      (this->*assemble)();
+      // Timed run
+      m_linear_system.clearValues();
+      auto t0 = std::chrono::high_resolution_clock::now();
+      (this->*assemble)();
+      auto t1 = std::chrono::high_resolution_clock::now();
+      Real time = std::chrono::duration<Real>(t1 - t0).count();
+      time = pm->reduce(Parallel::ReduceMax, time);
+      if (m_cell_type == IT_Triangle3)
+        m_time_stats->resetStats(s.timer_name);
+      info() << "AUTO:   method=" << s.name << " time=" << time << " s";
+      if (selected < 0 || time < best_time) {
+        selected = i;
+        best_time = time;
+      }
+    }
+    m_linear_system.clearValues();
+    info() << "AUTO: Selected assembly method '" << strategies[selected].name
+           << "' time=" << best_time << " s";
+
+    if (pm->commRank() == 0) {
+      std::ofstream ofile(cache_file.localstr(), std::ios::app);
+      ofile << key << " " << strategies[selected].name << "\n";
+    }
+  }
+
+  for (Int32 i = 0; i < nb_strategy; ++i)
+    this->*(strategies[i].flag) = (i == selected);
+  m_use_auto = false;
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -352,10 +513,54 @@ _doStationarySolve()
   _updateBoundayConditions();
 
   // Assemble the FEM bilinear operator (LHS - matrix A)
-  if (options()->meshType == "QUAD4")
-    _assembleBilinearOperatorQUAD4();
+  if (m_cell_type != IT_Triangle3) {
+
+    if (m_use_auto)
+      _selectAssemblyStrategy();
+
+    bool is_3d = (m_cell_type != IT_Quad4);
+    m_linear_system.clearValues();
+    if (m_use_csr) {
+      if (is_3d)
+        _assembleCsrBilinearOperator3D();
+      else
+        _assembleCsrBilinearOperatorQUAD4();
+      m_csr_matrix.translateToLinearSystem(m_linear_system);
+    }
+    else if (m_use_nodewise_csr) {
+      if (is_3d)
+        _assembleNodeWiseCsrBilinearOperator3D();
+      else
+        _assembleNodeWiseCsrBilinearOperatorQuad4();
+      m_csr_matrix.translateToLinearSystem(m_linear_system);
+    }
+    else if (m_use_buildless_csr) {
+      if (is_3d)
+        ARCANE_FATAL("The 'blcsr' assembly is not available for 3D meshes, use 'nwcsr' instead");
+      _assembleBuildLessCsrBilinearOperatorQuad4();
+      m_csr_matrix.translateToLinearSystem(m_linear_system);
+    }
+    else if (is_3d) {
+      _assembleBilinearOperator3D();
+    }
+    else {
+      _assembleBilinearOperatorQUAD4();
+    }
+
+    // Assemble the FEM linear operator (RHS - vector b)
+    _assembleLinearOperator();
+
+    // # T=linalg.solve(K,RHS)
+    _solve();
+
+    // Check results
+    _checkResultFile();
+  }
   else {
 
+    if (m_use_auto)
+      _selectAssemblyStrategy();
+
 #ifdef USE_CUSPARSE_ADD
     if (m_use_cusparse_add) {
       cusparseHandle_t handle;
@@ -412,7 +617,11 @@ _doStationarySolve()
       }
       m_csr_matrix.translateToLinearSystem(m_linear_system);
     }
-    if (m_use_legacy) {
+    if (m_use_amr) {
+      m_linear_system.clearValues();
+      _assembleAmrBilinearOperatorTRIA3();
+    }
+    else if (m_use_legacy) {
       m_linear_system.clearValues();
       _assembleBilinearOperatorTRIA3();
       if (m_cache_warming != 1) {
@@ -494,8 +703,17 @@ _getMaterialParameters()
   f = options()->f();
   ElementNodes = 3.;
 
-  if (options()->meshType == "QUAD4")
+  if (options()->meshType == "QUAD4" || options()->meshType == "TETRA4")
     ElementNodes = 4.;
+  else if (options()->meshType == "HEXA8")
+    ElementNodes = 8.;
+
+  // Read once the kind of source field to avoid options() lookup in the cell loops
+  String source_field = options()->sourceField();
+  m_use_cell_source = (source_field == "Cell");
+  m_use_node_source = (source_field == "Node");
+  if (!m_use_cell_source && !m_use_node_source && source_field != "None")
+    ARCANE_FATAL("Invalid value '{0}' for 'source-field' (valid values are: None, Cell, Node)", source_field);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -523,7 +741,13 @@ _applyDirichletBoundaryConditionsGpu()
   //   <value>21.0</value>
   // </dirichlet-boundary-condition>
 
+  // With Nitsche's method the surface conditions are imposed weakly by
+  // face integrals, so the nodes of these surfaces stay free DoFs.
+  bool use_nitsche = (options()->enforceDirichletMethod() == "Nitsche");
+
   for (const auto& bs : options()->dirichletBoundaryCondition()) {
+    if (use_nitsche)
+      break;
     FaceGroup group = bs->surface();
     Real value = bs->value();
     info() << "Apply Dirichlet boundary condition surface=" << group.name() << " v=" << value;
@@ -579,7 +803,13 @@ _applyDirichletBoundaryConditions()
   //   <value>21.0</value>
   // </dirichlet-boundary-condition>
 
+  // With Nitsche's method the surface conditions are imposed weakly by
+  // face integrals, so the nodes of these surfaces stay free DoFs.
+  bool use_nitsche = (options()->enforceDirichletMethod() == "Nitsche");
+
   for (const auto& bs : options()->dirichletBoundaryCondition()) {
+    if (use_nitsche)
+      break;
     FaceGroup group = bs->surface();
     Real value = bs->value();
     info() << "Apply Dirichlet boundary condition surface=" << group.name() << " v=" << value;
@@ -610,17 +840,26 @@ _applyDirichletBoundaryConditions()
 void FemModule::
 _checkCellType()
 {
-  Int16 type = 0;
-  if (options()->meshType == "QUAD4") {
-    type = IT_Quad4;
-  }
-  else {
-    type = IT_Triangle3;
-  }
+  String mesh_type = options()->meshType();
+  if (mesh_type == "QUAD4")
+    m_cell_type = IT_Quad4;
+  else if (mesh_type == "TETRA4")
+    m_cell_type = IT_Tetraedron4;
+  else if (mesh_type == "HEXA8")
+    m_cell_type = IT_Hexaedron8;
+  else if (mesh_type == "TRIA3")
+    m_cell_type = IT_Triangle3;
+  else
+    ARCANE_FATAL("Invalid value '{0}' for 'mesh-type' (valid values are: TRIA3, QUAD4, TETRA4, HEXA8)", mesh_type);
+
+  // The Nitsche face integrals are only implemented for the edges of TRIA3 cells
+  if (options()->enforceDirichletMethod() == "Nitsche" && m_cell_type != IT_Triangle3)
+    ARCANE_FATAL("enforce-Dirichlet-method 'Nitsche' is only supported for TRIA3 meshes (mesh-type is {0})", mesh_type);
+
   ENUMERATE_ (Cell, icell, allCells()) {
     Cell cell = *icell;
-    if (cell.type() != type)
-      ARCANE_FATAL("Only Triangle3 cell type is supported");
+    if (cell.type() != m_cell_type)
+      ARCANE_FATAL("Only {0} cell type is supported (cell type is {1})", mesh_type, cell.typeInfo()->typeName());
   }
 }
 
@@ -759,6 +998,44 @@ _assembleLinearOperator()
     // The same as before
     // TODO
   }
+  else if (options()->enforceDirichletMethod() == "Nitsche") {
+    Timer::Action timer_action(m_time_stats, "Nitsche");
+
+    //----------------------------------------------
+    // Nitsche method to enforce Dirichlet BC
+    //----------------------------------------------
+    //  Let 'g' be the Dirichlet value on the face F, 'n' its outward normal,
+    //  'h_F' its length and 'gamma' the Nitsche parameter. The following face
+    //  integrals are added, no row or column of A is modified
+    //
+    //  - For LHS matrix A
+    //           - int_F (dn(u) v + dn(v) u) + gamma/h_F int_F u v
+    //
+    //  - For RHS vector b
+    //           - int_F g dn(v) + gamma/h_F int_F g v
+    //
+    //  The operator stays symmetric positive definite for gamma large enough.
+    //  Point conditions have no face to integrate on and are still applied
+    //  with the weak penalty.
+    //----------------------------------------------
+
+    info() << "Applying Dirichlet boundary condition via "
+           << options()->enforceDirichletMethod() << " method ";
+
+    _assembleNitscheDirichletTRIA3();
+
+    Real Penalty = options()->penalty(); // 1.0e30 is the default
+
+    ENUMERATE_ (Node, inode, ownNodes()) {
+      NodeLocalId node_id = *inode;
+      if (m_u_dirichlet[node_id]) {
+        DoFLocalId dof_id = node_dof.dofId(*inode, 0);
+        m_linear_system.matrixAddValue(dof_id, dof_id, Penalty);
+        Real u_g = Penalty * m_u[node_id];
+        rhs_values[dof_id] = u_g;
+      }
+    }
+  }
   else {
 
     info() << "Applying Dirichlet boundary condition via "
@@ -767,27 +1044,38 @@ _assembleLinearOperator()
            << "  - Penalty\n"
            << "  - WeakPenalty\n"
            << "  - RowElimination\n"
-           << "  - RowColumnElimination\n";
+           << "  - RowColumnElimination\n"
+           << "  - Nitsche\n";
   }
 
   {
     Timer::Action timer_action(m_time_stats, "ConstantSourceTermAssembly");
     //----------------------------------------------
-    // Constant source term assembly
+    // Source term assembly
     //----------------------------------------------
     //
     //  $int_{Omega}(f*v^h)$
     //  only for noded that are non-Dirichlet
+    //
+    // The source is not fused in the cell loops of the bilinear assembly
+    // methods: they are timed and repeated on their own, and must not add
+    // the RHS again at each repetition.
     //----------------------------------------------
-    ENUMERATE_ (Cell, icell, allCells()) {
+    ENUMERATE_ (Cell, icell, m_fem_cells) {
       Cell cell = *icell;
 
-      Real area = _computeAreaTriangle3(cell);
+      Real b_e[8];
+      _computeElementSourceVector(cell, b_e);
+      if (m_has_hanging_node) {
+        _addElementVectorOnMasters(cell, b_e, rhs_values);
+        continue;
+      }
+      Int32 n_index = 0;
       for (Node node : cell.nodes()) {
         if (!(m_u_dirichlet[node]) && node.isOwn()) {
-          // Original code
-          rhs_values[node_dof.dofId(node, 0)] += f * area / ElementNodes;
+          rhs_values[node_dof.dofId(node, 0)] += b_e[n_index];
         }
+        ++n_index;
       }
     }
   }
@@ -810,16 +1098,21 @@ _assembleLinearOperator()
         Real value = bs->value();
         ENUMERATE_ (Face, iface, group) {
           Face face = *iface;
-          Real length = _computeEdgeLength2(face);
+          // Length of the edge in 2D, area of the face in 3D
+          Real measure = _computeFaceMeasure(face);
+          Real nb_face_node = face.nbNode();
           for (Node node : iface->nodes()) {
             if (!(m_u_dirichlet[node]) && node.isOwn())
               // must replace rhs_values with numArray
-              rhs_values[node_dof.dofId(node, 0)] += value * length / 2.;
+              rhs_values[node_dof.dofId(node, 0)] += value * measure / nb_face_node;
           }
         }
         continue;
       }
 
+      if (m_cell_type == IT_Tetraedron4 || m_cell_type == IT_Hexaedron8)
+        ARCANE_FATAL("Only the 'value' of the Neumann boundary condition is supported for 3D meshes");
+
       if (bs->valueX.isPresent() && bs->valueY.isPresent()) {
         Real valueX = bs->valueX();
         Real valueY = bs->valueY();
@@ -869,6 +1162,51 @@ _assembleLinearOperator()
   }
 }
 
+/*---------------------------------------------------------------------------*/
+// Assemble the Nitsche face integrals of the Dirichlet surfaces
+//  - Each boundary face adds a 3x3 contribution on the nodes of its cell,
+//    the matrix is only accumulated (matrixAddValue), never modified
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_assembleNitscheDirichletTRIA3()
+{
+  VariableDoFReal& rhs_values(m_linear_system.rhsVariable());
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Real gamma = options()->nitscheParameter();
+
+  for (const auto& bs : options()->dirichletBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+    Real value = bs->value();
+    info() << "Apply Nitsche Dirichlet condition surface=" << group.name() << " v=" << value
+           << " gamma=" << gamma;
+
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+      Cell cell = face.boundaryCell();
+      Int32 i_opp = 0;
+      for (Int32 k = 0; k < 3; ++k) {
+        NodeLocalId n = cell.nodeId(k);
+        if (n != face.nodeId(0) && n != face.nodeId(1))
+          i_opp = k;
+      }
+      Real K_e[9];
+      Real b_e[3];
+      _computeNitscheFaceTRIA3(m_node_coord[cell.nodeId(0)], m_node_coord[cell.nodeId(1)],
+                               m_node_coord[cell.nodeId(2)], i_opp, gamma, value, K_e, b_e);
+      for (Int32 i = 0; i < 3; ++i) {
+        Node node_i = cell.node(i);
+        if (!node_i.isOwn())
+          continue;
+        DoFLocalId row = node_dof.dofId(node_i, 0);
+        for (Int32 j = 0; j < 3; ++j)
+          m_linear_system.matrixAddValue(row, node_dof.dofId(cell.node(j), 0), K_e[i * 3 + j]);
+        rhs_values[row] += b_e[i];
+      }
+    }
+  }
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -1002,22 +1340,28 @@ _assembleCsrLinearOperator()
   {
     Timer::Action timer_action(m_time_stats, "CsrConstantSourceTermAssembly");
     //----------------------------------------------
-    // Constant source term assembly
+    // Source term assembly
     //----------------------------------------------
     //
     //  $int_{Omega}(f*v^h)$
     //  only for noded that are non-Dirichlet
     //----------------------------------------------
 
-    ENUMERATE_ (Cell, icell, allCells()) {
+    ENUMERATE_ (Cell, icell, m_fem_cells) {
       Cell cell = *icell;
 
-      Real area = _computeAreaTriangle3(cell);
+      Real b_e[8];
+      _computeElementSourceVector(cell, b_e);
+      if (m_has_hanging_node) {
+        _addElementVectorOnMasters(cell, b_e, rhs_values);
+        continue;
+      }
+      Int32 n_index = 0;
       for (Node node : cell.nodes()) {
         if (!(m_u_dirichlet[node]) && node.isOwn()) {
-          // Original code
-          m_rhs_vect[node_dof.dofId(node, 0)] += f * area / ElementNodes;
+          m_rhs_vect[node_dof.dofId(node, 0)] += b_e[n_index];
         }
+        ++n_index;
       }
     }
   }
@@ -1283,6 +1627,106 @@ _assembleCsrGpuLinearOperator()
 
     // TODO
   }
+  else if (options()->enforceDirichletMethod() == "Nitsche") {
+    Timer::Action timer_action(m_time_stats, "CsrGpuNitsche");
+
+    //----------------------------------------------
+    // Nitsche method to enforce Dirichlet BC
+    //----------------------------------------------
+    //  Same face integrals as in _assembleLinearOperator(), each boundary
+    //  face adds its 3x3 contribution in the CSR values with atomics, the
+    //  sparsity is unchanged because face nodes belong to the same cell.
+    //----------------------------------------------
+
+    info() << "Applying Dirichlet boundary condition via "
+           << options()->enforceDirichletMethod() << " method ";
+
+    Real gamma = options()->nitscheParameter();
+    Int32 row_csr_size = m_csr_matrix.m_matrix_row.dim1Size();
+    Int32 col_csr_size = m_csr_matrix.m_matrix_column.dim1Size();
+
+    for (const auto& bs : options()->dirichletBoundaryCondition()) {
+      FaceGroup group = bs->surface();
+      Real value = bs->value();
+
+      RunQueue* queue = acceleratorMng()->defaultQueue();
+      auto command = makeCommand(queue);
+
+      auto in_out_rhs_vect = ax::viewInOut(command, m_rhs_vect);
+      auto in_csr_row = ax::viewIn(command, m_csr_matrix.m_matrix_row);
+      auto in_csr_col = ax::viewIn(command, m_csr_matrix.m_matrix_column);
+      auto in_out_csr_val = ax::viewInOut(command, m_csr_matrix.m_matrix_value);
+
+      UnstructuredMeshConnectivityView m_connectivity_view;
+      auto in_node_coord = ax::viewIn(command, m_node_coord);
+      m_connectivity_view.setMesh(this->mesh());
+      auto fnc = m_connectivity_view.faceNode();
+      auto fcc = m_connectivity_view.faceCell();
+      auto cnc = m_connectivity_view.cellNode();
+      Arcane::ItemGenericInfoListView nodes_infos(this->mesh()->nodeFamily());
+      auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+      command << RUNCOMMAND_ENUMERATE(Face, iface, group)
+      {
+        CellLocalId cell = fcc.cellId(iface, 0);
+        NodeLocalId f0 = fnc.nodeId(iface, 0);
+        NodeLocalId f1 = fnc.nodeId(iface, 1);
+        Int32 i_opp = 0;
+        for (Int32 k = 0; k < 3; ++k) {
+          NodeLocalId n = cnc.nodeId(cell, k);
+          if (n != f0 && n != f1)
+            i_opp = k;
+        }
+        Real K_e[9];
+        Real b_e[3];
+        _computeNitscheFaceTRIA3(in_node_coord[cnc.nodeId(cell, 0)], in_node_coord[cnc.nodeId(cell, 1)],
+                                 in_node_coord[cnc.nodeId(cell, 2)], i_opp, gamma, value, K_e, b_e);
+        for (Int32 i = 0; i < 3; ++i) {
+          NodeLocalId node_i = cnc.nodeId(cell, i);
+          if (!nodes_infos.isOwn(node_i))
+            continue;
+          DoFLocalId row = node_dof.dofId(node_i, 0);
+          Int32 begin = in_csr_row(row);
+          Int32 end = (begin == row_csr_size - 1) ? col_csr_size : in_csr_row(row + 1);
+          for (Int32 j = 0; j < 3; ++j) {
+            DoFLocalId col = node_dof.dofId(cnc.nodeId(cell, j), 0);
+            Int32 index = _getValIndexCsrGpu(begin, end, col, in_csr_col);
+            ax::doAtomic<ax::eAtomicOperation::Add>(in_out_csr_val(index), K_e[i * 3 + j]);
+          }
+          ax::doAtomic<ax::eAtomicOperation::Add>(in_out_rhs_vect(row), b_e[i]);
+        }
+      };
+    }
+
+    // Point conditions are still applied with the weak penalty
+    if (options()->dirichletPointCondition().size() > 0) {
+      Real Penalty = options()->penalty(); // 1.0e30 is the default
+
+      RunQueue* queue = acceleratorMng()->defaultQueue();
+      auto command = makeCommand(queue);
+
+      auto in_out_rhs_vect = ax::viewInOut(command, m_rhs_vect);
+      auto in_csr_row = ax::viewIn(command, m_csr_matrix.m_matrix_row);
+      auto in_csr_col = ax::viewIn(command, m_csr_matrix.m_matrix_column);
+      auto in_out_csr_val = ax::viewInOut(command, m_csr_matrix.m_matrix_value);
+      auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+      auto in_m_u_dirichlet = ax::viewIn(command, m_u_dirichlet);
+      auto in_m_u = ax::viewIn(command, m_u);
+
+      command << RUNCOMMAND_ENUMERATE(Node, inode, ownNodes())
+      {
+        if (in_m_u_dirichlet(inode)) {
+          DoFLocalId dof_id = node_dof.dofId(inode, 0);
+          Int32 begin = in_csr_row(dof_id);
+          Int32 end = (begin == row_csr_size - 1) ? col_csr_size : in_csr_row(dof_id + 1);
+          Int32 index = _getValIndexCsrGpu(begin, end, dof_id, in_csr_col);
+          ax::doAtomic<ax::eAtomicOperation::Add>(in_out_csr_val(index), Penalty);
+          in_out_rhs_vect(dof_id) = Penalty * in_m_u(inode);
+        }
+      };
+    }
+  }
   else {
 
     info() << "Applying Dirichlet boundary condition via "
@@ -1291,13 +1735,14 @@ _assembleCsrGpuLinearOperator()
            << "  - Penalty\n"
            << "  - WeakPenalty\n"
            << "  - RowElimination\n"
-           << "  - RowColumnElimination\n";
+           << "  - RowColumnElimination\n"
+           << "  - Nitsche\n";
   }
 
   {
     Timer::Action timer_action(m_time_stats, "CsrGpuConstantSourceTermAssembly");
     //----------------------------------------------
-    // Constant source term assembly
+    // Source term assembly
     //----------------------------------------------
     //
     //  $int_{Omega}(f*v^h)$
@@ -1310,9 +1755,12 @@ _assembleCsrGpuLinearOperator()
     auto in_out_rhs_vect = ax::viewInOut(command, m_rhs_vect);
 
     auto in_m_u_dirichlet = ax::viewIn(command, m_u_dirichlet);
+    auto in_cell_f = ax::viewIn(command, m_cell_f);
+    auto in_node_f = ax::viewIn(command, m_node_f);
 
     Real tmp_f = f;
-    Real tmp_ElementNodes = ElementNodes;
+    bool use_cell_source = m_use_cell_source;
+    bool use_node_source = m_use_node_source;
 
     UnstructuredMeshConnectivityView m_connectivity_view;
     auto in_node_coord = ax::viewIn(command, m_node_coord);
@@ -1330,12 +1778,29 @@ _assembleCsrGpuLinearOperator()
     command << RUNCOMMAND_ENUMERATE(Cell, icell, allCells())
     {
       Real area = _computeAreaTriangle3Gpu(icell, cnc, in_node_coord);
+
+      Real f_cell = tmp_f;
+      if (use_cell_source)
+        f_cell += in_cell_f[icell];
+
+      Real f_node[3] = { 0., 0., 0. };
+      Int32 n_index = 0;
+      if (use_node_source) {
+        for (NodeLocalId node : cnc.nodes(icell)) {
+          f_node[n_index] = in_node_f[node];
+          ++n_index;
+        }
+      }
+
+      Real b_e[3] = { 0., 0., 0. };
+      addSourceTermTRIA3(area, f_cell, f_node, b_e);
+
+      n_index = 0;
       for (NodeLocalId node : cnc.nodes(icell)) {
         if (!(in_m_u_dirichlet(node)) && nodes_infos.isOwn(node)) {
-          // Original code
-          Real val = tmp_f * area / tmp_ElementNodes;
-          ax::doAtomic<ax::eAtomicOperation::Add>(in_out_rhs_vect(node_dof.dofId(node, 0)), val);
+          ax::doAtomic<ax::eAtomicOperation::Add>(in_out_rhs_vect(node_dof.dofId(node, 0)), b_e[n_index]);
         }
+        ++n_index;
       }
     };
   }
@@ -1587,6 +2052,19 @@ _computeEdgeLength2(Face face)
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+Real FemModule::
+_computeFaceMeasure(Face face)
+{
+  Real3 m[4];
+  Int32 nb_node = face.nbNode();
+  for (Int32 i = 0; i < nb_node; ++i)
+    m[i] = m_node_coord[face.nodeId(i)];
+  return computeFaceMeasure(m, nb_node);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 ARCCORE_HOST_DEVICE
 Real2 FemModule::
 _computeEdgeNormal2Gpu(FaceLocalId iface, IndexedFaceNodeConnectivityView fnc,
@@ -1607,6 +2085,63 @@ _computeEdgeNormal2Gpu(FaceLocalId iface, IndexedFaceNodeConnectivityView fnc,
   return N;
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Nitsche contribution of one Dirichlet face of a TRIA3 cell.
+ *
+ * \a m0, \a m1, \a m2 are the cell nodes and \a i_opp the local index of
+ * the node which is not on the face. \a K_e receives the 3x3 matrix
+ *   - int_F (dn(Phi_j) Phi_i + dn(Phi_i) Phi_j) + gamma/h_F int_F Phi_i Phi_j
+ * and \a b_e the right hand side
+ *   - int_F g dn(Phi_i) + gamma/h_F int_F g Phi_i
+ * The gradients are constant on P1 elements, so the face integrals are exact.
+ */
+ARCCORE_HOST_DEVICE
+void FemModule::
+_computeNitscheFaceTRIA3(Real3 m0, Real3 m1, Real3 m2, Int32 i_opp, Real gamma,
+                         Real g, Real K_e[9], Real b_e[3])
+{
+  Real3 m[3] = { m0, m1, m2 };
+  Int32 i_a = (i_opp + 1) % 3;
+  Int32 i_b = (i_opp + 2) % 3;
+
+  // Twice the signed area, so that the gradients are valid for any orientation
+  Real area2 = (m1.x - m0.x) * (m2.y - m0.y) - (m2.x - m0.x) * (m1.y - m0.y);
+  Real2 dPhi[3] = { Real2((m1.y - m2.y) / area2, (m2.x - m1.x) / area2),
+                    Real2((m2.y - m0.y) / area2, (m0.x - m2.x) / area2),
+                    Real2((m0.y - m1.y) / area2, (m1.x - m0.x) / area2) };
+
+  Real ex = m[i_b].x - m[i_a].x;
+  Real ey = m[i_b].y - m[i_a].y;
+  Real length = math::sqrt(ex * ex + ey * ey);
+  Real nx = ey / length;
+  Real ny = -ex / length;
+  // Outward normal: it points away from the node opposite to the face
+  if (nx * (m[i_opp].x - m[i_a].x) + ny * (m[i_opp].y - m[i_a].y) > 0.) {
+    nx = -nx;
+    ny = -ny;
+  }
+
+  Real dn[3];
+  Real int_phi[3];
+  for (Int32 i = 0; i < 3; ++i) {
+    dn[i] = dPhi[i].x * nx + dPhi[i].y * ny;
+    int_phi[i] = (i == i_opp) ? 0. : length / 2.;
+  }
+
+  Real s = gamma / length;
+  for (Int32 i = 0; i < 3; ++i) {
+    for (Int32 j = 0; j < 3; ++j) {
+      Real int_phi_phi = 0.;
+      if (i != i_opp && j != i_opp)
+        int_phi_phi = (i == j) ? length / 3. : length / 6.;
+      K_e[i * 3 + j] = -(dn[j] * int_phi[i] + dn[i] * int_phi[j]) + s * int_phi_phi;
+    }
+    b_e[i] = g * (-dn[i] * length + s * int_phi[i]);
+  }
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -1670,6 +2205,43 @@ _computeElementMatrixTRIA3(Cell cell)
   return int_cdPi_dPj;
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/**
+ * Computes the elementary vector of the source term $int_{cell}(f*v^h)$
+ * where the source is the sum of 'f' and of the field given by 'source-field'.
+ */
+void FemModule::
+_computeElementSourceVector(Cell cell, Real b_e[8])
+{
+  Int32 nb_node = cell.nbNode();
+
+  Real f_cell = f;
+  if (m_use_cell_source)
+    f_cell += m_cell_f[cell];
+
+  Real f_node[8] = { 0., 0., 0., 0., 0., 0., 0., 0. };
+  if (m_use_node_source)
+    for (Int32 i = 0; i < nb_node; ++i)
+      f_node[i] = m_node_f[cell.nodeId(i)];
+
+  for (Int32 i = 0; i < 8; ++i)
+    b_e[i] = 0.;
+
+  Real3 m[8];
+  for (Int32 i = 0; i < nb_node; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
+
+  if (cell.type() == IT_Quad4)
+    addSourceTermQUAD4(m, f_cell, f_node, b_e);
+  else if (cell.type() == IT_Hexaedron8)
+    addSourceTermHEXA8(m, f_cell, f_node, b_e);
+  else if (cell.type() == IT_Tetraedron4)
+    addSourceTermTETRA4(computeVolumeTETRA4(m), f_cell, f_node, b_e);
+  else
+    addSourceTermTRIA3(_computeAreaTriangle3(cell), f_cell, f_node, b_e);
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -1678,44 +2250,80 @@ _computeElementMatrixQUAD4(Cell cell)
 {
   // Get coordiantes of the quadrangular element  QUAD4
   //------------------------------------------------
-  //             1 o . . . . o 0
+  //             3 o . . . . o 2
   //               .         .
   //               .         .
   //               .         .
-  //             2 o . . . . o 3
+  //             0 o . . . . o 1
   //------------------------------------------------
-  Real3 m0 = m_node_coord[cell.nodeId(0)];
-  Real3 m1 = m_node_coord[cell.nodeId(1)];
-  Real3 m2 = m_node_coord[cell.nodeId(2)];
-  Real3 m3 = m_node_coord[cell.nodeId(3)];
+  Real3 m[4];
+  for (Int32 i = 0; i < 4; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
 
-  Real area = _computeAreaQuad4(cell); // calculate area
+  // Bilinear shape functions integrated with a 2x2 Gauss quadrature
+  Real K_e[16];
+  computeStiffnessMatrixQUAD4(m, K_e);
 
-  Real2 dPhi0(m2.y - m3.y, m3.x - m2.x);
-  Real2 dPhi1(m3.y - m0.y, m0.x - m3.x);
-  Real2 dPhi2(m0.y - m1.y, m1.x - m0.x);
-  Real2 dPhi3(m1.y - m2.y, m2.x - m1.x);
+  FixedMatrix<4, 4> int_cdPi_dPj;
+  for (Int32 i = 0; i < 4; ++i)
+    for (Int32 j = 0; j < 4; ++j)
+      int_cdPi_dPj(i, j) = K_e[i * 4 + j];
 
-  FixedMatrix<2, 4> b_matrix;
-  b_matrix(0, 0) = dPhi0.x;
-  b_matrix(0, 1) = dPhi1.x;
-  b_matrix(0, 2) = dPhi2.x;
-  b_matrix(0, 3) = dPhi3.x;
+  return int_cdPi_dPj;
+}
 
-  b_matrix(1, 0) = dPhi0.y;
-  b_matrix(1, 1) = dPhi1.y;
-  b_matrix(1, 2) = dPhi2.y;
-  b_matrix(1, 3) = dPhi3.y;
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
 
-  b_matrix.multInPlace(1.0 / (2.0 * area));
+ARCCORE_HOST_DEVICE void FemModule::
+_computeElementMatrixQUAD4GPU(CellLocalId icell, IndexedCellNodeConnectivityView cnc, ax::VariableNodeReal3InView in_node_coord, Real K_e[16])
+{
+  Real3 m[4];
+  for (Int32 i = 0; i < 4; ++i)
+    m[i] = in_node_coord[cnc.nodeId(icell, i)];
+  computeStiffnessMatrixQUAD4(m, K_e);
+}
 
-  FixedMatrix<4, 4> int_cdPi_dPj = matrixMultiplication(matrixTranspose(b_matrix), b_matrix);
-  int_cdPi_dPj.multInPlace(area);
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
 
-  //info() << "Cell=" << cell.localId();
-  //std::cout << " int_cdPi_dPj=";
-  //int_cdPi_dPj.dump(std::cout);
-  //std::cout << "\n";
+FixedMatrix<4, 4> FemModule::
+_computeElementMatrixTETRA4(Cell cell)
+{
+  Real3 m[4];
+  for (Int32 i = 0; i < 4; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
+
+  // Linear shape functions, their gradients are constant on the cell
+  Real K_e[16];
+  computeStiffnessMatrixTETRA4(m, K_e);
+
+  FixedMatrix<4, 4> int_cdPi_dPj;
+  for (Int32 i = 0; i < 4; ++i)
+    for (Int32 j = 0; j < 4; ++j)
+      int_cdPi_dPj(i, j) = K_e[i * 4 + j];
+
+  return int_cdPi_dPj;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+FixedMatrix<8, 8> FemModule::
+_computeElementMatrixHEXA8(Cell cell)
+{
+  Real3 m[8];
+  for (Int32 i = 0; i < 8; ++i)
+    m[i] = m_node_coord[cell.nodeId(i)];
+
+  // Trilinear shape functions integrated with a 2x2x2 Gauss quadrature
+  Real K_e[64];
+  computeStiffnessMatrixHEXA8(m, K_e);
+
+  FixedMatrix<8, 8> int_cdPi_dPj;
+  for (Int32 i = 0; i < 8; ++i)
+    for (Int32 j = 0; j < 8; ++j)
+      int_cdPi_dPj(i, j) = K_e[i * 8 + j];
 
   return int_cdPi_dPj;
 }
@@ -1762,6 +2370,40 @@ _assembleBilinearOperatorQUAD4()
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+void FemModule::
+_assembleBilinearOperator3D()
+{
+  Timer::Action timer_action(m_time_stats, "AssembleLegacyBilinearOperator3D");
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+
+  auto add_element_matrix = [&](Cell cell, const auto& K_e) {
+    Int32 n1_index = 0;
+    for (Node node1 : cell.nodes()) {
+      Int32 n2_index = 0;
+      for (Node node2 : cell.nodes()) {
+        Real v = K_e(n1_index, n2_index);
+        if (node1.isOwn()) {
+          m_linear_system.matrixAddValue(node_dof.dofId(node1, 0), node_dof.dofId(node2, 0), v);
+        }
+        ++n2_index;
+      }
+      ++n1_index;
+    }
+  };
+
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    if (m_cell_type == IT_Hexaedron8)
+      add_element_matrix(cell, _computeElementMatrixHEXA8(cell));
+    else
+      add_element_matrix(cell, _computeElementMatrixTETRA4(cell));
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 ARCCORE_HOST_DEVICE void FemModule::
 _computeElementMatrixTRIA3GPU(CellLocalId icell, IndexedCellNodeConnectivityView cnc, ax::VariableNodeReal3InView in_node_coord, Real K_e[9])
 {
@@ -1969,6 +2611,7 @@ _solve()
 
   //test
   m_u.synchronize();
+  _interpolateHangingNodes();
   // def update_T(self,T):
   //     """Update u value on nodes after the FE resolution"""
   //     for i in range(0,len(self.mesh.nodes)):
@@ -1995,14 +2638,44 @@ _solve()
 void FemModule::
 _checkResultFile()
 {
+  if (options()->nullSpace())
+    _checkNullSpaceMean();
   String filename = options()->resultFile();
   info() << "CheckResultFile filename=" << filename;
   if (filename.empty())
     return;
+  // With the adaptive refinement, only the solution on the final mesh is checked
+  if (m_use_amr && !m_amr_is_done)
+    return;
   const double epsilon = 1.0e-4;
   checkNodeResultFile(traceMng(), filename, m_u, epsilon);
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Check that the solution of a pure Neumann problem has a zero mean.
+ *
+ * The null space of the constants is removed from the solution after the
+ * solve, so the sum of the nodal values must vanish.
+ */
+void FemModule::
+_checkNullSpaceMean()
+{
+  Real sum = 0.0;
+  Real sum_abs = 0.0;
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    sum += m_u[inode];
+    sum_abs += math::abs(m_u[inode]);
+  }
+  IParallelMng* pm = mesh()->parallelMng();
+  sum = pm->reduce(Parallel::ReduceSum, sum);
+  sum_abs = pm->reduce(Parallel::ReduceSum, sum_abs);
+  info() << "Null space: sum of the solution=" << sum << " sum of the absolute values=" << sum_abs;
+  if (math::abs(sum) > 1.0e-8 * sum_abs)
+    ARCANE_FATAL("The solution of the pure Neumann problem has not a zero mean (sum={0})", sum);
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -2038,3 +2711,4 @@ void FemModule::fileNumArray(bool ref, NumArray<Real, MDDim1> numarray)
 
 #include "NodeWiseCsrBiliAssembly.hxx"
 #include "BlCsrBiliAssembly.hxx"
+#include "AdaptiveRefinement.hxx"
@@ -19,6 +19,9 @@
 #include <arcane/IItemFamily.h>
 #include <arcane/ItemGroup.h>
 #include <arcane/ICaseMng.h>
+#include <arcane/IParallelMng.h>
+#include <arcane/IMeshModifier.h>
+#include <arcane/Concurrency.h>
 
 #include "CooFormatMatrix.h"
 
@@ -29,9 +32,17 @@
 #include "FemUtils.h"
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
+#include "FemSourceTerm.h"
+#include "FemNodeCellConnectivity.h"
+#include "FemElementMatrix.h"
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <iterator>
+#include <set>
+#include <map>
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 
@@ -164,6 +175,7 @@ class FemModule
   , m_dofs_on_nodes(mbi.subDomain()->traceMng())
   , m_coo_matrix(mbi.subDomain())
   , m_csr_matrix(mbi.subDomain())
+  , m_node_cell_connectivity(mbi.subDomain()->traceMng())
   , m_time_stats(mbi.subDomain()->timeStats())
   {
     ICaseMng* cm = mbi.subDomain()->caseMng();
@@ -191,6 +203,10 @@ class FemModule
 
   Real f;
   Real ElementNodes;
+  //! Type of the cells given by 'mesh-type' (set by _checkCellType())
+  Int16 m_cell_type = IT_Triangle3;
+  bool m_use_cell_source = false;
+  bool m_use_node_source = false;
 
   DoFLinearSystem m_linear_system;
   IItemFamily* m_dof_family = nullptr;
@@ -205,13 +221,36 @@ class FemModule
   bool m_use_buildless_csr = false;
   bool m_use_cusparse_add = false;
   bool m_use_legacy = true;
+  bool m_use_auto = false;
   bool m_running_on_gpu = false;
   ITimeStats* m_time_stats;
 
+  //! Adaptive refinement (see AdaptiveRefinement.hxx)
+  bool m_use_amr = false;
+  Int32 m_amr_cycle = 0;
+  //! True when the last cycle has been done (the result file is checked on the final mesh)
+  bool m_amr_is_done = false;
+  //! Cells on which the operators are assembled (active cells with AMR)
+  CellGroup m_fem_cells;
+  //! Parent edge (2 end nodes) and parent cell of the nodes created by the refinement
+  UniqueArray<Int32> m_node_parent_edge;
+  //! Imposed value of the edges (sorted end nodes) of the Dirichlet surfaces
+  std::map<std::pair<Int32, Int32>, Real> m_dirichlet_edge_value;
+  //! Masters of the nodes (CSR indexed by node), a hanging node has the masters of its parent edge
+  bool m_has_hanging_node = false;
+  UniqueArray<Int32> m_node_master_index;
+  UniqueArray<Int32> m_node_master;
+  UniqueArray<Real> m_node_master_weight;
+
   CooFormat m_coo_matrix;
 
   CsrFormat m_csr_matrix;
 
+  //! Local index of the nodes in their cells (and CSR slots) for nodewise assembly
+  FemNodeCellConnectivity m_node_cell_connectivity;
+  //! Element matrices computed once per cell before the nodewise gather
+  NumArray<Real, MDDim2> m_cell_matrix;
+
   NumArray<Real, MDDim1> m_rhs_vect;
 
   std::ofstream logger;
@@ -229,17 +268,35 @@ class FemModule
   void fileNumArray(bool ref, NumArray<Real, MDDim1> numarray);
 
   void _handleFlags();
+  void _selectAssemblyStrategy();
+  String _assemblyStrategyKey();
   void _doStationarySolve();
   void _getMaterialParameters();
   void _updateBoundayConditions();
   void _checkCellType();
   void _assembleBilinearOperatorTRIA3();
   void _assembleBilinearOperatorQUAD4();
+  void _assembleBilinearOperator3D();
   void _solve();
   void _initBoundaryconditions();
   void _assembleLinearOperator();
+  void _assembleNitscheDirichletTRIA3();
   void _applyDirichletBoundaryConditions();
   void _checkResultFile();
+  void _checkNullSpaceMean();
+  void _initAdaptiveRefinement();
+  void _doAdaptiveRefinementCycle();
+  Real _computeErrorIndicator();
+  void _markCellsToRefine(Int32Array& cells_to_refine);
+  void _computeNodeParentEdges();
+  void _prolongateOnNewNodes(Int32ConstArrayView new_node_lids);
+  void _computeHangingNodeMasters();
+  void _interpolateHangingNodes();
+  bool _isHangingNode(Int32 node_lid) const;
+  void _assembleAmrBilinearOperatorTRIA3();
+  void _addElementMatrixOnMasters(Cell cell, const FixedMatrix<3, 3>& K_e);
+  void _addElementVectorOnMasters(Cell cell, const Real b_e[8], VariableDoFReal& rhs_values);
+  void _addHangingNodeRows();
   void _writeInJson();
   void _saveTimeInCSV();
   void _saveNoBuildTimeInCSV();
@@ -247,9 +304,13 @@ class FemModule
   Real _readTimeFromJson(String main_time, String sub_time);
   FixedMatrix<3, 3> _computeElementMatrixTRIA3(Cell cell);
   FixedMatrix<4, 4> _computeElementMatrixQUAD4(Cell cell);
+  FixedMatrix<4, 4> _computeElementMatrixTETRA4(Cell cell);
+  FixedMatrix<8, 8> _computeElementMatrixHEXA8(Cell cell);
+  void _computeElementSourceVector(Cell cell, Real b_e[8]);
   Real _computeAreaTriangle3(Cell cell);
   Real _computeAreaQuad4(Cell cell);
   Real _computeEdgeLength2(Face face);
+  Real _computeFaceMeasure(Face face);
   Real2 _computeEdgeNormal2(Face face);
   //#ifdef ARCANE_HAS_ACCELERATOR
  public:
@@ -266,6 +327,9 @@ class FemModule
   _computeEdgeLength2Gpu(FaceLocalId iface,
                          IndexedFaceNodeConnectivityView fnc,
                          ax::VariableNodeReal3InView in_node_coord);
+  static ARCCORE_HOST_DEVICE void
+  _computeNitscheFaceTRIA3(Real3 m0, Real3 m1, Real3 m2, Int32 i_opp, Real gamma,
+                           Real g, Real K_e[9], Real b_e[3]);
   static ARCCORE_HOST_DEVICE Real2
   _computeEdgeNormal2Gpu(FaceLocalId iface, IndexedFaceNodeConnectivityView fnc,
                          ax::VariableNodeReal3InView in_node_coord,
@@ -290,6 +354,9 @@ class FemModule
   static ARCCORE_HOST_DEVICE void
   _computeElementMatrixTRIA3GPU(CellLocalId icell, IndexedCellNodeConnectivityView cnc,
                                 ax::VariableNodeReal3InView in_node_coord, Real K_e[9]);
+  static ARCCORE_HOST_DEVICE void
+  _computeElementMatrixQUAD4GPU(CellLocalId icell, IndexedCellNodeConnectivityView cnc,
+                                ax::VariableNodeReal3InView in_node_coord, Real K_e[16]);
 
  private:
  public:
@@ -310,12 +377,22 @@ class FemModule
 
 #endif
   void _assembleCsrBilinearOperatorTRIA3();
+  void _assembleCsrBilinearOperatorQUAD4();
+  void _assembleCsrBilinearOperator3D();
   void _buildMatrixCsr();
 
  public:
 
   void _buildMatrixNodeWiseCsr();
+  void _buildMatrixNodeWiseCsrFromCells();
+  void _computeCellMatricesGpuTria3();
+  void _computeCellMatricesGpuQuad4();
+  void _computeCellMatricesGpu3D();
+  void _addCellMatricesNodeWiseCsr(Int32 nb_node_per_cell);
+  void _addCellMatricesBuildLessCsr(Int32 nb_node_per_cell);
   void _assembleNodeWiseCsrBilinearOperatorTria3();
+  void _assembleNodeWiseCsrBilinearOperatorQuad4();
+  void _assembleNodeWiseCsrBilinearOperator3D();
 
   void _buildMatrixBuildLessCsr();
   void _buildMatrixGpuBuildLessCsr();
@@ -327,6 +404,7 @@ class FemModule
                                   ax::NumArrayView<DataViewGetterSetter<Int32>, MDDim1, DefaultLayout> in_out_col_csr,
                                   ax::NumArrayView<DataViewGetterSetter<Real>, MDDim1, DefaultLayout> in_out_val_csr, Real x);
   void _assembleBuildLessCsrBilinearOperatorTria3();
+  void _assembleBuildLessCsrBilinearOperatorQuad4();
 
  private:
 
@@ -41,7 +41,7 @@ void FemModule::_buildMatrixNodeWiseCsr()
     m_csr_matrix.setCoordinates(diagonal_entry, diagonal_entry);
 
     for (Face face : node.faces()) {
-      DoFLocalId nodeId = face.nodeId(0) ? node_dof.dofId(face.nodeId(1), 0) : node_dof.dofId(face.nodeId(1), 0);
+      DoFLocalId nodeId = (face.nodeId(0) == node.itemLocalId()) ? node_dof.dofId(face.nodeId(1), 0) : node_dof.dofId(face.nodeId(0), 0);
       m_csr_matrix.setCoordinates(diagonal_entry, nodeId);
       //if (face.nodeId(0) == node.localId()) {
       //    cn->addConnectedItem(node, face.node(0));
@@ -53,6 +53,123 @@ void FemModule::_buildMatrixNodeWiseCsr()
       //}
     }
   }
+
+  // The local index of the nodes in their cells only depends on the mesh,
+  // the CSR slots have to be computed again with the pattern.
+  if (!m_node_cell_connectivity.isInitialized())
+    m_node_cell_connectivity.initialize(mesh());
+  m_node_cell_connectivity.computeCsrSlots(node_dof, m_csr_matrix);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Build the csr matrix for the nodewise assembly of QUAD4, TETRA4
+ * and HEXA8 cells.
+ *
+ * The nbFace() * 2 + nbNode() formula only holds for triangles (it misses
+ * the diagonal neighbours of the quadrangles and the faces are not edges in
+ * 3D), so the generic node-cell pattern is used.
+ */
+void FemModule::_buildMatrixNodeWiseCsrFromCells()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  m_csr_matrix.initializeFromNodeCellPattern(mesh(), m_dof_family, node_dof);
+
+  if (!m_node_cell_connectivity.isInitialized())
+    m_node_cell_connectivity.initialize(mesh());
+  m_node_cell_connectivity.computeCsrSlots(node_dof, m_csr_matrix);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Compute the element matrices of all the cells in m_cell_matrix.
+ *
+ * The nodewise assemblies then only gather these values, instead of
+ * computing the element matrix of a cell once for each of its nodes.
+ */
+void FemModule::_computeCellMatricesGpuTria3()
+{
+  m_cell_matrix.resize(mesh()->cellFamily()->maxLocalId(), 9);
+
+  RunQueue* queue = acceleratorMng()->defaultQueue();
+  auto command = makeCommand(queue);
+
+  auto in_node_coord = ax::viewIn(command, m_node_coord);
+  auto out_cell_matrix = ax::viewOut(command, m_cell_matrix);
+
+  UnstructuredMeshConnectivityView connectivity_view;
+  connectivity_view.setMesh(this->mesh());
+  auto cnc = connectivity_view.cellNode();
+
+  command << RUNCOMMAND_ENUMERATE(Cell, icell, allCells())
+  {
+    Real K_e[9]{ 0 };
+    _computeElementMatrixTRIA3GPU(icell, cnc, in_node_coord, K_e);
+    for (Int32 k = 0; k < 9; ++k)
+      out_cell_matrix(icell.localId(), k) = K_e[k];
+  };
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::_computeCellMatricesGpuQuad4()
+{
+  m_cell_matrix.resize(mesh()->cellFamily()->maxLocalId(), 16);
+
+  RunQueue* queue = acceleratorMng()->defaultQueue();
+  auto command = makeCommand(queue);
+
+  auto in_node_coord = ax::viewIn(command, m_node_coord);
+  auto out_cell_matrix = ax::viewOut(command, m_cell_matrix);
+
+  UnstructuredMeshConnectivityView connectivity_view;
+  connectivity_view.setMesh(this->mesh());
+  auto cnc = connectivity_view.cellNode();
+
+  command << RUNCOMMAND_ENUMERATE(Cell, icell, allCells())
+  {
+    Real K_e[16];
+    _computeElementMatrixQUAD4GPU(icell, cnc, in_node_coord, K_e);
+    for (Int32 k = 0; k < 16; ++k)
+      out_cell_matrix(icell.localId(), k) = K_e[k];
+  };
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::_computeCellMatricesGpu3D()
+{
+  bool is_hexa = (m_cell_type == IT_Hexaedron8);
+  Int32 nb_node = (is_hexa) ? 8 : 4;
+  m_cell_matrix.resize(mesh()->cellFamily()->maxLocalId(), nb_node * nb_node);
+
+  RunQueue* queue = acceleratorMng()->defaultQueue();
+  auto command = makeCommand(queue);
+
+  auto in_node_coord = ax::viewIn(command, m_node_coord);
+  auto out_cell_matrix = ax::viewOut(command, m_cell_matrix);
+
+  UnstructuredMeshConnectivityView connectivity_view;
+  connectivity_view.setMesh(this->mesh());
+  auto cnc = connectivity_view.cellNode();
+
+  command << RUNCOMMAND_ENUMERATE(Cell, icell, allCells())
+  {
+    Real3 m[8];
+    for (Int32 i = 0; i < nb_node; ++i)
+      m[i] = in_node_coord[cnc.nodeId(icell, i)];
+    Real K_e[64];
+    if (is_hexa)
+      computeStiffnessMatrixHEXA8(m, K_e);
+    else
+      computeStiffnessMatrixTETRA4(m, K_e);
+    for (Int32 k = 0; k < nb_node * nb_node; ++k)
+      out_cell_matrix(icell.localId(), k) = K_e[k];
+  };
 }
 
 /*---------------------------------------------------------------------------*/
@@ -68,93 +185,86 @@ void FemModule::_assembleNodeWiseCsrBilinearOperatorTria3()
     _buildMatrixNodeWiseCsr();
   }
 
+  Timer::Action timer_blcsr_add_compute(m_time_stats, "NodeWiseCsrAddAndCompute");
+  _computeCellMatricesGpuTria3();
+  _addCellMatricesNodeWiseCsr(3);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::_assembleNodeWiseCsrBilinearOperatorQuad4()
+{
+  Timer::Action timer_blcsr_bili(m_time_stats, "AssembleNodeWiseCsrBilinearOperatorQuad4");
+
+  {
+    Timer::Action timer_blcsr_build(m_time_stats, "NodeWiseCsrBuildMatrixQuad4");
+    _buildMatrixNodeWiseCsrFromCells();
+  }
+
+  Timer::Action timer_blcsr_add_compute(m_time_stats, "NodeWiseCsrAddAndComputeQuad4");
+  _computeCellMatricesGpuQuad4();
+  _addCellMatricesNodeWiseCsr(4);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Nodewise assembly for TETRA4 and HEXA8 cells.
+ *
+ * Each node only writes its own row, so the gather runs in parallel on the
+ * threads (or on the accelerator) without coloring nor atomics.
+ */
+void FemModule::_assembleNodeWiseCsrBilinearOperator3D()
+{
+  Timer::Action timer_blcsr_bili(m_time_stats, "AssembleNodeWiseCsrBilinearOperator3D");
+
+  {
+    Timer::Action timer_blcsr_build(m_time_stats, "NodeWiseCsrBuildMatrix3D");
+    _buildMatrixNodeWiseCsrFromCells();
+  }
+
+  Timer::Action timer_blcsr_add_compute(m_time_stats, "NodeWiseCsrAddAndCompute3D");
+  _computeCellMatricesGpu3D();
+  _addCellMatricesNodeWiseCsr((m_cell_type == IT_Hexaedron8) ? 8 : 4);
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+/*!
+ * \brief Add the element matrices of m_cell_matrix in the csr matrix.
+ *
+ * Each thread handles one row (one node): each (node, cell) pair gives the
+ * row of the element matrix of the cell and the CSR slots where to add it,
+ * so no search nor atomic operation is needed.
+ */
+void FemModule::_addCellMatricesNodeWiseCsr(Int32 nb_node_per_cell)
+{
   RunQueue* queue = acceleratorMng()->defaultQueue();
 
   // Boucle sur les noeuds déportée sur accélérateur
   auto command = makeCommand(queue);
 
-  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
-  auto in_row_csr = ax::viewIn(command, m_csr_matrix.m_matrix_row);
-  Int32 row_csr_size = m_csr_matrix.m_matrix_row.dim1Size();
-  auto in_col_csr = ax::viewIn(command, m_csr_matrix.m_matrix_column);
-  Int32 col_csr_size = m_csr_matrix.m_matrix_column.dim1Size();
   auto in_out_val_csr = ax::viewInOut(command, m_csr_matrix.m_matrix_value);
+  auto in_cell_matrix = ax::viewIn(command, m_cell_matrix);
+  auto in_node_begin = ax::viewIn(command, m_node_cell_connectivity.m_node_begin);
+  auto in_pair_cell = ax::viewIn(command, m_node_cell_connectivity.m_pair_cell);
+  auto in_local_index = ax::viewIn(command, m_node_cell_connectivity.m_local_index);
+  auto in_csr_slot = ax::viewIn(command, m_node_cell_connectivity.m_csr_slot);
+  Int32 max_nb_node = m_node_cell_connectivity.maxNbNodePerCell();
+  Int32 nb_node = nb_node_per_cell;
 
-  auto in_node_coord = ax::viewIn(command, m_node_coord);
-
-  UnstructuredMeshConnectivityView m_connectivity_view;
-  m_connectivity_view.setMesh(this->mesh());
-  auto ncc = m_connectivity_view.nodeCell();
-  auto cnc = m_connectivity_view.cellNode();
   Arcane::ItemGenericInfoListView nodes_infos(this->mesh()->nodeFamily());
-  Arcane::ItemGenericInfoListView cells_infos(this->mesh()->cellFamily());
 
-  Timer::Action timer_blcsr_add_compute(m_time_stats, "NodeWiseCsrAddAndCompute");
   command << RUNCOMMAND_ENUMERATE(Node, inode, allNodes())
   {
-    Int32 inode_index = 0;
-    for (auto cell : ncc.cells(inode)) {
-
-      // How can I know the right index ?
-      // By checking in the global id ?
-      // Working currently, but maybe only because p = 1 ?
-      if (inode == cnc.nodeId(cell, 1)) {
-        inode_index = 1;
-      }
-      else if (inode == cnc.nodeId(cell, 2)) {
-        inode_index = 2;
-      }
-      else {
-        inode_index = 0;
-      }
-      Real3 m0 = in_node_coord[cnc.nodeId(cell, 0)];
-      Real3 m1 = in_node_coord[cnc.nodeId(cell, 1)];
-      Real3 m2 = in_node_coord[cnc.nodeId(cell, 2)];
-
-      Real area = 0.5 * ((m1.x - m0.x) * (m2.y - m0.y) - (m2.x - m0.x) * (m1.y - m0.y)); // calculate area
-
-      Real2 dPhi0(m1.y - m2.y, m2.x - m1.x);
-      Real2 dPhi1(m2.y - m0.y, m0.x - m2.x);
-      Real2 dPhi2(m0.y - m1.y, m1.x - m0.x);
-
-      Real b_matrix[3][2] = { 0 };
-      Real mul = (1.0 / (2.0 * area));
-      b_matrix[0][0] = dPhi0.x * mul;
-      b_matrix[0][1] = dPhi0.y * mul;
-
-      b_matrix[1][0] = dPhi1.x * mul;
-      b_matrix[1][1] = dPhi1.y * mul;
-
-      b_matrix[2][0] = dPhi2.x * mul;
-      b_matrix[2][1] = dPhi2.y * mul;
-
-      Int32 i = 0;
-      for (NodeLocalId node2 : cnc.nodes(cell)) {
-        Real x = 0.0;
-        for (Int32 k = 0; k < 2; k++) {
-          x += b_matrix[inode_index][k] * b_matrix[i][k];
-        }
-        if (nodes_infos.isOwn(inode)) {
-
-          Int32 row = node_dof.dofId(inode, 0).localId();
-          Int32 col = node_dof.dofId(node2, 0).localId();
-          Int32 begin = in_row_csr[row];
-          Int32 end;
-          if (row == row_csr_size - 1) {
-            end = col_csr_size;
-          }
-          else {
-            end = in_row_csr[row + 1];
-          }
-          while (begin < end) {
-            if (in_col_csr[begin] == col) {
-              in_out_val_csr[begin] += x * area;
-              break;
-            }
-            begin++;
-          }
-        }
-        i++;
+    if (nodes_infos.isOwn(inode)) {
+      Int32 node_lid = inode.localId();
+      for (Int32 p = in_node_begin[node_lid]; p < in_node_begin[node_lid + 1]; ++p) {
+        Int32 cell_lid = in_pair_cell[p];
+        Int32 inode_index = in_local_index[p];
+        for (Int32 i = 0; i < nb_node; ++i)
+          in_out_val_csr[in_csr_slot[p * max_nb_node + i]] += in_cell_matrix(cell_lid, inode_index * nb_node + i);
       }
     }
   };
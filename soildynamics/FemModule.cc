@@ -23,6 +23,7 @@
 #include "FemUtils.h"
 #include "DoFLinearSystem.h"
 #include "FemDoFsOnNodes.h"
+#include "FemLoadPipeline.h"
 
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -43,6 +44,7 @@ class FemModule
   explicit FemModule(const ModuleBuildInfo& mbi)
   : ArcaneFemObject(mbi)
   , m_dofs_on_nodes(mbi.subDomain()->traceMng())
+  , m_load_pipeline(mbi.subDomain()->traceMng())
   {
     ICaseMng* cm = mbi.subDomain()->caseMng();
     cm->setTreatWarningAsError(true);
@@ -60,6 +62,8 @@ class FemModule
       delete t.case_table;
     for( const CaseTableInfo&  t : m_double_couple_case_table_list_west )
       delete t.case_table;
+    for( CaseTable* t : m_ensemble_traction_case_table )
+      delete t;
   }
 
  public:
@@ -128,6 +132,39 @@ class FemModule
   UniqueArray<CaseTableInfo> m_double_couple_case_table_list_east;
   UniqueArray<CaseTableInfo> m_double_couple_case_table_list_west;
 
+  // Loads which only depend on the time (body forces and traction). They
+  // are computed from the arrays below, which are built at the
+  // initialisation, so that the next time step can be prepared in another
+  // thread during the solve (see 'async-loads' option).
+  FemLoadPipeline m_load_pipeline;
+  //! Body force term of the DoFs
+  UniqueArray<Real> m_body_force_loads;
+  //! Traction input of each traction boundary condition (null for a constant traction)
+  UniqueArray<CaseTable*> m_traction_load_case_table;
+  //! Constant traction of each traction boundary condition
+  UniqueArray<Real3> m_traction_load_value;
+  //! Boundary condition, DoF, direction (0 for x, 1 for y) and weight of the traction terms
+  UniqueArray<Int32> m_traction_load_condition;
+  UniqueArray<Int32> m_traction_load_dof;
+  UniqueArray<Int32> m_traction_load_direction;
+  UniqueArray<Real> m_traction_load_weight;
+
+  // Ensemble mode (see 'ensemble-member' option). The state of the members
+  // is member-contiguous: value of the member k for the DoF i at
+  // [i * m_nb_member + k].
+  Int32 m_nb_member = 0;
+  UniqueArray<Real> m_ensemble_u;
+  UniqueArray<Real> m_ensemble_v;
+  UniqueArray<Real> m_ensemble_a;
+  UniqueArray<Real> m_ensemble_du;
+  UniqueArray<Real> m_ensemble_rhs;
+  UniqueArray<Real> m_ensemble_load_scale;
+  UniqueArray<Real> m_ensemble_time_shift;
+  //! Traction input of each member (null if the member uses the ones of the boundary conditions)
+  UniqueArray<CaseTable*> m_ensemble_traction_case_table;
+  //! Lumped mass weight of the nodes (indexed by node local id), shared by the members
+  UniqueArray<Real> m_node_mass_weight;
+
  private:
 
   void _doStationarySolve();
@@ -144,6 +181,12 @@ class FemModule
   void _applyDoubleCoupleBilinear();
   void _checkResultFile();
   void _readCaseTables();
+  void _initLoads();
+  void _computeLoads(Real time, ArrayView<Real> loads) const;
+  void _initEnsemble();
+  void _doEnsembleSolve();
+  void _assembleEnsembleLinearOperator();
+  void _updateEnsembleVariables();
   FixedMatrix<4, 4> _computeElementMatrixEDGE2(Face face);
   FixedMatrix<6, 6> _computeElementMatrixTRIA3(Cell cell);
   FixedMatrix<4, 4> _computeElementMatrixQUAD4(Cell cell);
@@ -164,30 +207,48 @@ compute()
   info() << " \n\n***[WIP] this is module is not working yet please dont trust the results***[\n\n";
 
   // Stop code after computations
-  if (t >= tmax)
+  bool is_last_step = (t >= tmax);
+  if (is_last_step)
     subDomain()->timeLoopMng()->stopComputeLoop(true);
 
   info() << "Time iteration at t : " << t << " (s) ";
 
   // Set if we want to keep the matrix structure between calls.
   // The matrix has to have the same structure (same structure for non-zero)
+  // A frozen matrix is kept as is, only the RHS vector is assembled again.
   bool keep_struct = true;
   if (m_linear_system.isInitialized() && keep_struct){
-    m_linear_system.clearValues();
+    if (!m_linear_system.hasFrozenMatrix())
+      m_linear_system.clearValues();
   }
   else{
     m_linear_system.reset();
     m_linear_system.setLinearSystemFactory(options()->linearSystem());
     m_linear_system.initialize(subDomain(), m_dofs_on_nodes.dofFamily(), "Solver");
+    if (options()->freezeMatrix())
+      m_linear_system.setMatrixFrozen(true);
+    // The members start from their displacement at the previous step
+    if (m_nb_member > 0)
+      m_linear_system.setSolutionAsInitialGuess(true);
   }
 
   info() << " \n\n***[WIP] this is module is not working yet please dont trust the results***[\n\n";
 
-  _doStationarySolve();
+  if (m_nb_member > 0)
+    _doEnsembleSolve();
+  else
+    _doStationarySolve();
 
   info() << " \n\n***[WIP] this is module is not working yet please dont trust the results***[\n\n";
 
-  _updateVariables();
+  if (m_nb_member > 0)
+    _updateEnsembleVariables();
+  else
+    _updateVariables();
+
+  // Displacements of the last time step
+  if (is_last_step)
+    _checkResultFile();
 
   info() << " \n\n***[WIP] this is module is not working yet please dont trust the results***[\n\n";
 
@@ -216,6 +277,8 @@ startInit()
   m_global_deltat.assign(dt);
 
   _readCaseTables();
+  _initLoads();
+  _initEnsemble();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -236,21 +299,23 @@ _doStationarySolve()
 {
 
   // Assemble the FEM bilinear operator (LHS - matrix A)
-  if (options()->meshType == "QUAD4")
-    _assembleBilinearOperatorQUAD4();
-  else
-    _assembleBilinearOperatorTRIA3();
+  if (!m_linear_system.hasFrozenMatrix()) {
+    if (options()->meshType == "QUAD4")
+      _assembleBilinearOperatorQUAD4();
+    else
+      _assembleBilinearOperatorTRIA3();
 
-  _assembleBilinearOperatorEDGE2();
+    _assembleBilinearOperatorEDGE2();
+  }
 
   // Assemble the FEM linear operator (RHS - vector b)
   _assembleLinearOperator();
 
+  // Loads of the next time step, computed during the solve with 'async-loads'
+  m_load_pipeline.prepare(t + dt);
+
   // Solve for [u1,u2]
   _solve();
-
-  // Check results TODO
-  // _checkResultFile();
 }
 
 /*---------------------------------------------------------------------------*/
@@ -397,6 +462,188 @@ _readCaseTables()
   }
 }
 
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// Ensemble mode: the members differ by their loads only (traction and
+// double-couple inputs). The mesh, the matrix and the terms which do not
+// depend on the loads (lumped mass weights, body forces) are shared.
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_initEnsemble()
+{
+  m_nb_member = options()->ensembleMember().size();
+  if (m_nb_member == 0)
+    return;
+
+  info() << "Ensemble mode with " << m_nb_member << " members";
+  String dirichlet_method = options()->enforceDirichletMethod();
+  if (dirichlet_method != "Penalty" && dirichlet_method != "WeakPenalty")
+    ARCANE_FATAL("Only Penalty | WeakPenalty are supported for enforce-Dirichlet-method in ensemble mode");
+
+  IParallelMng* pm = subDomain()->parallelMng();
+  for (const auto& member : options()->ensembleMember()) {
+    m_ensemble_load_scale.add(member->loadScale());
+    m_ensemble_time_shift.add(member->timeShift());
+    CaseTable* case_table = nullptr;
+    if (member->tractionInputFile.isPresent())
+      case_table = readFileAsCaseTable(pm, member->tractionInputFile(), 3);
+    m_ensemble_traction_case_table.add(case_table);
+  }
+
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Int32 nb_dof = m_dofs_on_nodes.dofFamily()->maxLocalId();
+  m_ensemble_u.resize(nb_dof * m_nb_member);
+  m_ensemble_v.resize(nb_dof * m_nb_member);
+  m_ensemble_a.resize(nb_dof * m_nb_member);
+  m_ensemble_du.resize(nb_dof * m_nb_member);
+  m_ensemble_rhs.resize(nb_dof * m_nb_member);
+  m_ensemble_du.fill(0.0);
+
+  // All the members start from the initial state (with the Dirichlet values)
+  ENUMERATE_ (Node, inode, allNodes()) {
+    Node node = *inode;
+    for (Int32 k = 0; k < m_nb_member; ++k) {
+      Int32 i1 = node_dof.dofId(node, 0).localId() * m_nb_member + k;
+      Int32 i2 = node_dof.dofId(node, 1).localId() * m_nb_member + k;
+      m_ensemble_u[i1] = m_U[node].x;
+      m_ensemble_u[i2] = m_U[node].y;
+      m_ensemble_v[i1] = m_V[node].x;
+      m_ensemble_v[i2] = m_V[node].y;
+      m_ensemble_a[i1] = m_A[node].x;
+      m_ensemble_a[i2] = m_A[node].y;
+    }
+  }
+
+  // Same lumped mass weights as _assembleLinearOperator(). The body forces
+  // are the ones of _initLoads().
+  m_node_mass_weight.resize(mesh()->nodeFamily()->maxLocalId());
+  m_node_mass_weight.fill(0.0);
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    Real area = _computeAreaTriangle3(cell);
+    for (Node node : cell.nodes())
+      m_node_mass_weight[node.localId()] += area / 3.;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+// Loads which only depend on the time
+//  - The DoFs and the weights of the body force and traction terms are
+//    computed once here, only for the own nodes that are non-Dirichlet
+//  - _computeLoads() then only reads these arrays and the CaseTables, so
+//    that it can run in another thread
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_initLoads()
+{
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  Int32 nb_dof = m_dofs_on_nodes.dofFamily()->maxLocalId();
+
+  //----------------------------------------------
+  // Body force term
+  //----------------------------------------------
+  //  $int_{Omega}(f1*v1^h)$
+  //  $int_{Omega}(f2*v2^h)$
+  //----------------------------------------------
+  m_body_force_loads.resize(nb_dof);
+  m_body_force_loads.fill(0.0);
+  ENUMERATE_ (Cell, icell, allCells()) {
+    Cell cell = *icell;
+    Real area = _computeAreaTriangle3(cell);
+    for (Node node : cell.nodes()) {
+      if (!node.isOwn())
+        continue;
+      if (options()->f1.isPresent() && !(m_u1_fixed[node]))
+        m_body_force_loads[node_dof.dofId(node, 0).localId()] += f1 * area / 3;
+      if (options()->f2.isPresent() && !(m_u2_fixed[node]))
+        m_body_force_loads[node_dof.dofId(node, 1).localId()] += f2 * area / 3;
+    }
+  }
+
+  //----------------------------------------------
+  // Traction term
+  //----------------------------------------------
+  //  $int_{dOmega_N}((tx.nx)*v1^h)$
+  //  $int_{dOmega_N}((ty.ny)*v1^h)$
+  //----------------------------------------------
+  Int32 boundary_condition_index = 0;
+
+  for (const auto& bs : options()->tractionBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+    const CaseTableInfo& case_table_info = m_traction_case_table_list[boundary_condition_index];
+    const Int32 condition_index = boundary_condition_index;
+    ++boundary_condition_index;
+
+    CaseTable* inn = nullptr;
+    bool has_t1 = bs->t1.isPresent();
+    bool has_t2 = bs->t2.isPresent();
+    if (bs->tractionInputFile.isPresent()) {
+      String file_name = bs->tractionInputFile();
+      info() << "Applying traction boundary conditions for surface " << group.name()
+             << " via CaseTable" << file_name;
+      inn = case_table_info.case_table;
+      if (!inn)
+        ARCANE_FATAL("CaseTable is null. Maybe there is a missing call to _readCaseTables()");
+      if (file_name != case_table_info.file_name)
+        ARCANE_FATAL("Incoherent CaseTable. The current CaseTable is associated to file '{0}'", case_table_info.file_name);
+      has_t1 = true;
+      has_t2 = true;
+    }
+    else
+      info() << "Applying constant traction boundary conditions for surface " << group.name();
+
+    m_traction_load_case_table.add(inn);
+    m_traction_load_value.add(Real3(bs->t1(), bs->t2(), 0.));
+
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+      Real length = _computeEdgeLength2(face);
+      for (Node node : iface->nodes()) {
+        if (!node.isOwn())
+          continue;
+        for (Int32 idof = 0; idof < 2; ++idof) {
+          bool has_traction = (idof == 0) ? has_t1 : has_t2;
+          bool is_fixed = (idof == 0) ? m_u1_fixed[node] : m_u2_fixed[node];
+          if (!has_traction || is_fixed)
+            continue;
+          m_traction_load_condition.add(condition_index);
+          m_traction_load_dof.add(node_dof.dofId(node, idof).localId());
+          m_traction_load_direction.add(idof);
+          m_traction_load_weight.add(length / 2.);
+        }
+      }
+    }
+  }
+
+  m_load_pipeline.initialize(nb_dof, [this](Real time, ArrayView<Real> loads) { _computeLoads(time, loads); });
+  m_load_pipeline.setAsynchronous(options()->asyncLoads());
+  if (options()->asyncLoads())
+    info() << "The loads of the next time step are computed during the solve";
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_computeLoads(Real time, ArrayView<Real> loads) const
+{
+  loads.copy(m_body_force_loads);
+
+  const Int32 nb_condition = m_traction_load_case_table.size();
+  UniqueArray<Real3> trac(nb_condition);
+  for (Int32 i = 0; i < nb_condition; ++i) {
+    if (m_traction_load_case_table[i])
+      m_traction_load_case_table[i]->value(time, trac[i]);
+    else
+      trac[i] = m_traction_load_value[i];
+  }
+
+  for (Int32 i = 0, n = m_traction_load_dof.size(); i < n; ++i)
+    loads[m_traction_load_dof[i]] += trac[m_traction_load_condition[i]][m_traction_load_direction[i]] * m_traction_load_weight[i];
+}
+
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
@@ -715,37 +962,18 @@ _assembleLinearOperator()
     ARCANE_FATAL( "Dirichlet boundary conditions were not applied " );
   }
   //----------------------------------------------
-  // Body force term assembly
+  // Body force and traction terms (see _initLoads())
   //----------------------------------------------
   //
   //  $int_{Omega}(f1*v1^h)$
-  //  $int_{Omega}(f2*v2^h)$
+  //  $int_{dOmega_N}((tx.nx)*v1^h)$
   //  only for nodes that are non-Dirichlet
   //----------------------------------------------
 
-  if ( options()->f1.isPresent()) {
-    ENUMERATE_ (Cell, icell, allCells()) {
-      Cell cell = *icell;
-      Real area = _computeAreaTriangle3(cell);
-      for (Node node : cell.nodes()) {
-        if (!(m_u1_fixed[node]) && node.isOwn()) {
-          DoFLocalId dof_id1 = node_dof.dofId(node, 0);
-          rhs_values[dof_id1] += f1 * area / 3;
-        }
-      }
-    }
-  }
-
-  if ( options()->f2.isPresent()) {
-    ENUMERATE_ (Cell, icell, allCells()) {
-      Cell cell = *icell;
-      Real area = _computeAreaTriangle3(cell);
-      for (Node node : cell.nodes()) {
-        if (!(m_u2_fixed[node]) && node.isOwn()) {
-          DoFLocalId dof_id2 = node_dof.dofId(node, 1);
-          rhs_values[dof_id2] += f2 * area / 3;
-        }
-      }
+  {
+    ConstArrayView<Real> loads = m_load_pipeline.loads(t);
+    ENUMERATE_ (DoF, idof, m_dofs_on_nodes.dofFamily()->allItems().own()) {
+      rhs_values[idof] += loads[idof.itemLocalId()];
     }
   }
 
@@ -788,118 +1016,6 @@ $$
     }
   }
 
-  //----------------------------------------------
-  // Traction term assembly
-  //----------------------------------------------
-  //
-  //  $int_{dOmega_N}((tx.nx)*v1^h)$
-  //  $int_{dOmega_N}((ty.ny)*v1^h)$
-  //  only for noded that are non-Dirichlet
-  //----------------------------------------------
-
-  // Index of the boundary condition. Needed to associate a CaseTable
-  Int32 boundary_condition_index = 0;
-
-  for (const auto& bs : options()->tractionBoundaryCondition()) {
-
-    FaceGroup group = bs->surface();
-
-    const CaseTableInfo& case_table_info = m_traction_case_table_list[boundary_condition_index];
-    ++boundary_condition_index;
-
-    Real3 trac; // traction in x, y and z
-
-
-    if (bs->tractionInputFile.isPresent()){
-
-      String file_name = bs->tractionInputFile();
-      info() << "Applying traction boundary conditions for surface "<< group.name()
-             << " via CaseTable" <<  file_name;
-      CaseTable* inn = case_table_info.case_table;
-
-      if (!inn)
-        ARCANE_FATAL("CaseTable is null. Maybe there is a missing call to _readCaseTables()");
-      if (file_name!=case_table_info.file_name)
-        ARCANE_FATAL("Incoherent CaseTable. The current CaseTable is associated to file '{0}'",case_table_info.file_name);
-
-      inn->value(t, trac);
-
-
-      ENUMERATE_ (Face, iface, group) {
-        Face face = *iface;
-        Real length = _computeEdgeLength2(face);
-        for (Node node : iface->nodes()) {
-          if (!(m_u1_fixed[node]) && node.isOwn()) {
-            DoFLocalId dof_id1 = node_dof.dofId(node, 0);
-
-            rhs_values[dof_id1] += trac.x * length / 2.;
-          }
-          if (!(m_u2_fixed[node]) && node.isOwn()) {
-            DoFLocalId dof_id2 = node_dof.dofId(node, 1);
-            rhs_values[dof_id2] += trac.y * length / 2.;
-
-          }
-        }
-      }
-
-      continue;
-    }
-    else {
-
-      info() << "Applying constant traction boundary conditions for surface "<< group.name();
-
-      trac.x = bs->t1();
-      trac.y = bs->t2();
-
-      if( bs->t1.isPresent() && bs->t2.isPresent()) {
-        ENUMERATE_ (Face, iface, group) {
-          Face face = *iface;
-          Real length = _computeEdgeLength2(face);
-          for (Node node : iface->nodes()) {
-            if (!(m_u1_fixed[node]) && node.isOwn()) {
-              DoFLocalId dof_id1 = node_dof.dofId(node, 0);
-              rhs_values[dof_id1] += trac.x * length / 2.;
-            }
-            if (!(m_u2_fixed[node]) && node.isOwn()) {
-              DoFLocalId dof_id2 = node_dof.dofId(node, 1);
-              rhs_values[dof_id2] += trac.y * length / 2.;
-            }
-          }
-        }
-        continue;
-      }
-
-      if( bs->t1.isPresent()) {
-        ENUMERATE_ (Face, iface, group) {
-          Face face = *iface;
-        Real length = _computeEdgeLength2(face);
-          for (Node node : iface->nodes()) {
-            if (!(m_u1_fixed[node]) && node.isOwn()) {
-              DoFLocalId dof_id1 = node_dof.dofId(node, 0);
-              rhs_values[dof_id1] += trac.x * length / 2.;
-            }
-          }
-        }
-        continue;
-      }
-
-      if( bs->t2.isPresent()) {
-        ENUMERATE_ (Face, iface, group) {
-          Face face = *iface;
-          Real length = _computeEdgeLength2(face);
-          for (Node node : iface->nodes()) {
-            if (!(m_u2_fixed[node]) && node.isOwn()) {
-              DoFLocalId dof_id2 = node_dof.dofId(node, 1);
-              rhs_values[dof_id2] += trac.y * length / 2. ;
-            }
-          }
-        }
-        continue;
-      }
-
-    }
-  }
-
   //----------------------------------------------
   // Paraxial term assembly
   //----------------------------------------------
@@ -1030,6 +1146,251 @@ $$
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 
+void FemModule::
+_doEnsembleSolve()
+{
+  // Assemble the FEM bilinear operator (LHS - matrix A), shared by the members
+  if (!m_linear_system.hasFrozenMatrix()) {
+    if (options()->meshType == "QUAD4")
+      _assembleBilinearOperatorQUAD4();
+    else
+      _assembleBilinearOperatorTRIA3();
+
+    _assembleBilinearOperatorEDGE2();
+  }
+
+  // Assemble the FEM linear operators (RHS - vectors b) of the members
+  _assembleEnsembleLinearOperator();
+
+  info() << "Solving the linear systems of the " << m_nb_member << " members";
+  m_ensemble_du.copy(m_ensemble_u);
+  m_linear_system.solveEnsemble(m_nb_member, m_ensemble_rhs, m_ensemble_du);
+}
+
+/*---------------------------------------------------------------------------*/
+// Assemble the FEM linear operators of the ensemble members
+//  - Same terms as _assembleLinearOperator() with the loads of each member,
+//    except on the Dirichlet rows which only get the penalty term
+//  - The loops on the members are the inner ones: the geometric terms of a
+//    node or of a face are computed once for all the members
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_assembleEnsembleLinearOperator()
+{
+  info() << "Assembly of FEM linear operators of the ensemble members";
+
+  const Int32 nb_member = m_nb_member;
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  m_ensemble_rhs.fill(0.0);
+  Real* rhs = m_ensemble_rhs.data();
+  const Real* u = m_ensemble_u.data();
+  const Real* v = m_ensemble_v.data();
+  const Real* a = m_ensemble_a.data();
+
+  //----------------------------------------------
+  // Dirichlet BC via (weak) penalty, inertia and body force terms
+  //----------------------------------------------
+  bool is_weak_penalty = (options()->enforceDirichletMethod() == "WeakPenalty");
+  Real Penalty = options()->penalty();        // 1.0e30 is the default
+
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    Real weight = m_node_mass_weight[node.localId()];
+    for (Int32 idof = 0; idof < 2; ++idof) {
+      DoFLocalId dof_id = node_dof.dofId(node, idof);
+      const Int64 offset = static_cast<Int64>(dof_id.localId()) * nb_member;
+      bool is_fixed = (idof == 0) ? m_u1_fixed[node] : m_u2_fixed[node];
+      if (is_fixed) {
+        if (is_weak_penalty)
+          m_linear_system.matrixAddValue(dof_id, dof_id, Penalty);
+        else
+          m_linear_system.matrixSetValue(dof_id, dof_id, Penalty);
+        for (Int32 k = 0; k < nb_member; ++k)
+          rhs[offset + k] = Penalty * u[offset + k];
+        // The row only imposes the value: no inertia or body force term
+        continue;
+      }
+      const Real body_force = m_body_force_loads[dof_id.localId()];
+      for (Int32 k = 0; k < nb_member; ++k)
+        rhs[offset + k] += body_force + weight * (c0 * u[offset + k] + c3 * v[offset + k] + c4 * a[offset + k]);
+    }
+  }
+
+  //----------------------------------------------
+  // Traction term assembly
+  //----------------------------------------------
+  Int32 boundary_condition_index = 0;
+  UniqueArray<Real3> member_trac(nb_member);
+
+  for (const auto& bs : options()->tractionBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+    const CaseTableInfo& case_table_info = m_traction_case_table_list[boundary_condition_index];
+    ++boundary_condition_index;
+
+    bool has_t1 = true;
+    bool has_t2 = true;
+    if (bs->tractionInputFile.isPresent()) {
+      for (Int32 k = 0; k < nb_member; ++k) {
+        CaseTable* inn = m_ensemble_traction_case_table[k];
+        if (!inn)
+          inn = case_table_info.case_table;
+        if (!inn)
+          ARCANE_FATAL("CaseTable is null. Maybe there is a missing call to _readCaseTables()");
+        Real3 trac;
+        inn->value(t - m_ensemble_time_shift[k], trac);
+        member_trac[k] = m_ensemble_load_scale[k] * trac;
+      }
+    }
+    else {
+      has_t1 = bs->t1.isPresent();
+      has_t2 = bs->t2.isPresent();
+      Real3 trac(bs->t1(), bs->t2(), 0.);
+      for (Int32 k = 0; k < nb_member; ++k)
+        member_trac[k] = m_ensemble_load_scale[k] * trac;
+    }
+    info() << "Applying traction boundary conditions of the members for surface " << group.name();
+
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+      Real length = _computeEdgeLength2(face);
+      for (Node node : iface->nodes()) {
+        if (!node.isOwn())
+          continue;
+        if (has_t1 && !(m_u1_fixed[node])) {
+          const Int64 offset = static_cast<Int64>(node_dof.dofId(node, 0).localId()) * nb_member;
+          for (Int32 k = 0; k < nb_member; ++k)
+            rhs[offset + k] += member_trac[k].x * length / 2.;
+        }
+        if (has_t2 && !(m_u2_fixed[node])) {
+          const Int64 offset = static_cast<Int64>(node_dof.dofId(node, 1).localId()) * nb_member;
+          for (Int32 k = 0; k < nb_member; ++k)
+            rhs[offset + k] += member_trac[k].y * length / 2.;
+        }
+      }
+    }
+  }
+
+  //----------------------------------------------
+  // Paraxial term assembly
+  //----------------------------------------------
+  //  The paraxial term is linear in W = c7 U - c8 V - c9 A
+  //----------------------------------------------
+  for (const auto& bs : options()->paraxialBoundaryCondition()) {
+    FaceGroup group = bs->surface();
+
+    ENUMERATE_ (Face, iface, group) {
+      Face face = *iface;
+
+      Real  length = _computeEdgeLength2(face);
+      Real2 Normal = _computeEdgeNormal2(face);
+      Real nxx = Normal.x * Normal.x;
+      Real nxy = Normal.x * Normal.y;
+      Real nyy = Normal.y * Normal.y;
+
+      for (Node node : iface->nodes()) {
+        if (!node.isOwn())
+          continue;
+        const Int64 offset1 = static_cast<Int64>(node_dof.dofId(node, 0).localId()) * nb_member;
+        const Int64 offset2 = static_cast<Int64>(node_dof.dofId(node, 1).localId()) * nb_member;
+        bool is_free1 = !(m_u1_fixed[node]);
+        bool is_free2 = !(m_u2_fixed[node]);
+        for (Int32 k = 0; k < nb_member; ++k) {
+          Real wx = c7 * u[offset1 + k] - c8 * v[offset1 + k] - c9 * a[offset1 + k];
+          Real wy = c7 * u[offset2 + k] - c8 * v[offset2 + k] - c9 * a[offset2 + k];
+          if (is_free1)
+            rhs[offset1 + k] += (cp * (nxx * wx + nxy * wy) + cs * (nyy * wx - nxy * wy)) * length / 2.;
+          if (is_free2)
+            rhs[offset2 + k] += (cp * (nxy * wx + nyy * wy) + cs * (-nxy * wx + nxx * wy)) * length / 2.;
+        }
+      }
+    }
+  }
+
+  //----------------------------------------------
+  // Double-couple term assembly
+  //----------------------------------------------
+  Int32 boundary_condition_index_dc = 0;
+
+  for (const auto& bs : options()->doubleCouple()) {
+    CaseTable* inn_north = m_double_couple_case_table_list_north[boundary_condition_index_dc].case_table;
+    CaseTable* inn_south = m_double_couple_case_table_list_south[boundary_condition_index_dc].case_table;
+    CaseTable* inn_east  = m_double_couple_case_table_list_east[boundary_condition_index_dc].case_table;
+    CaseTable* inn_west  = m_double_couple_case_table_list_west[boundary_condition_index_dc].case_table;
+    ++boundary_condition_index_dc;
+
+    UniqueArray<Real3> trac_north(nb_member);
+    UniqueArray<Real3> trac_south(nb_member);
+    UniqueArray<Real3> trac_east(nb_member);
+    UniqueArray<Real3> trac_west(nb_member);
+    for (Int32 k = 0; k < nb_member; ++k) {
+      Real tk = t - m_ensemble_time_shift[k];
+      inn_north->value(tk, trac_north[k]);
+      inn_south->value(tk, trac_south[k]);
+      inn_east->value(tk, trac_east[k]);
+      inn_west->value(tk, trac_west[k]);
+    }
+
+    auto set_values = [&](NodeGroup group, Int32 idof, ConstArrayView<Real3> values) {
+      ENUMERATE_ (Node, inode, group) {
+        const Int64 offset = static_cast<Int64>(node_dof.dofId(*inode, idof).localId()) * nb_member;
+        for (Int32 k = 0; k < nb_member; ++k)
+          rhs[offset + k] = m_ensemble_load_scale[k] * ((idof == 0) ? values[k].x : values[k].y);
+      }
+    };
+    set_values(bs->northNodeName(), 0, trac_north);
+    set_values(bs->southNodeName(), 0, trac_south);
+    set_values(bs->eastNodeName(), 1, trac_east);
+    set_values(bs->westNodeName(), 1, trac_west);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
+void FemModule::
+_updateEnsembleVariables()
+{
+  // Newmark-beta update of all the members, same as _updateVariables()
+  const Int64 size = m_ensemble_u.size();
+  for (Int64 i = 0; i < size; ++i) {
+    Real aloc = (m_ensemble_du[i] - m_ensemble_u[i] - dt * m_ensemble_v[i]) / beta / (dt * dt)
+    - (1. - 2. * beta) / 2. / beta * m_ensemble_a[i];
+    m_ensemble_v[i] = m_ensemble_v[i] + dt * ((1. - gamma) * m_ensemble_a[i] + gamma * aloc);
+    m_ensemble_a[i] = aloc;
+    m_ensemble_u[i] = m_ensemble_du[i];
+  }
+
+  // The variables U, V and A are the ones of the first member
+  auto node_dof(m_dofs_on_nodes.nodeDoFConnectivityView());
+  ENUMERATE_ (Node, inode, allNodes()) {
+    Node node = *inode;
+    Int32 i1 = node_dof.dofId(node, 0).localId() * m_nb_member;
+    Int32 i2 = node_dof.dofId(node, 1).localId() * m_nb_member;
+    m_dU[node] = Real3(m_ensemble_u[i1], m_ensemble_u[i2], 0.);
+    m_U[node] = m_dU[node];
+    m_V[node] = Real3(m_ensemble_v[i1], m_ensemble_v[i2], 0.);
+    m_A[node] = Real3(m_ensemble_a[i1], m_ensemble_a[i2], 0.);
+  }
+
+  UniqueArray<Real> max_displacement(m_nb_member, 0.0);
+  ENUMERATE_ (Node, inode, ownNodes()) {
+    Node node = *inode;
+    Int32 i1 = node_dof.dofId(node, 0).localId() * m_nb_member;
+    Int32 i2 = node_dof.dofId(node, 1).localId() * m_nb_member;
+    for (Int32 k = 0; k < m_nb_member; ++k) {
+      Real norm = math::sqrt(m_ensemble_u[i1 + k] * m_ensemble_u[i1 + k] + m_ensemble_u[i2 + k] * m_ensemble_u[i2 + k]);
+      max_displacement[k] = math::max(max_displacement[k], norm);
+    }
+  }
+  subDomain()->parallelMng()->reduce(Parallel::ReduceMax, max_displacement);
+  for (Int32 k = 0; k < m_nb_member; ++k)
+    info() << "Ensemble member " << k << " t=" << t << " max |U|=" << max_displacement[k];
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+
 Real FemModule::
 _computeAreaQuad4(Cell cell)
 {
@@ -1785,13 +2146,14 @@ _solve()
 void FemModule::
 _checkResultFile()
 {
+  if (options()->writeResultFile.isPresent())
+    writeNodeResultFile(traceMng(), options()->writeResultFile(), m_U);
   String filename = options()->resultFile();
   info() << "CheckResultFile filename=" << filename;
   if (filename.empty())
     return;
   const double epsilon = 1.0e-4;
-  // TODO
-  //Arcane::FemUtils::checkNodeResultFile(traceMng(), filename, m_U.x, epsilon);
+  checkNodeResultFile(traceMng(), filename, m_U, epsilon);
 }
 
 /*---------------------------------------------------------------------------*/